@@ -0,0 +1,164 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <lorina/bristol.hpp>
+#include <mockturtle/io/bristol_reader.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+
+#include <experiments.hpp>
+
+/* writes a random Bristol circuit with the gate mix of typical crypto circuits */
+void write_random_bristol( std::string const& filename, uint32_t num_pis, uint32_t num_gates, uint32_t num_pos )
+{
+  std::mt19937 rng( 1 );
+  std::ofstream os( filename );
+  os << fmt::format( "{} {}\n1 {}\n1 {}\n\n", num_gates, num_pis + num_gates, num_pis, num_pos );
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto out = num_pis + i;
+    /* prefer recent wires to get deep circuits with short-range fanins */
+    const auto a = out - 1u - rng() % std::min( out, 1024u );
+    const auto b = out - 1u - rng() % std::min( out, 1024u );
+    switch ( rng() % 8u )
+    {
+    case 0u:
+    case 1u:
+      os << "2 1 " << a << ' ' << b << ' ' << out << " AND\n";
+      break;
+    case 2u:
+      os << "1 1 " << a << ' ' << out << " INV\n";
+      break;
+    default:
+      os << "2 1 " << a << ' ' << b << ' ' << out << " XOR\n";
+      break;
+    }
+  }
+}
+
+/* usage: bristol_parsing [--gates N] [--threads N] [file ...]
+ *
+ * Compares the throughput of lorina::read_bristol with bristol_reader and of
+ * read_bristol_fast on the given Bristol files, or on a random circuit with
+ * N gates (default: 4M) if no file is given. */
+int main( int argc, char** argv )
+{
+  using namespace experiments;
+  using namespace mockturtle;
+
+  uint32_t num_gates = 4000000u;
+  uint32_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  std::vector<std::string> filenames;
+  for ( auto i = 1; i < argc; ++i )
+  {
+    const std::string arg = argv[i];
+    if ( arg == "--gates" && i + 1 < argc )
+    {
+      num_gates = std::stoul( argv[++i] );
+    }
+    else if ( arg == "--threads" && i + 1 < argc )
+    {
+      num_threads = std::stoul( argv[++i] );
+    }
+    else
+    {
+      filenames.push_back( arg );
+    }
+  }
+
+  std::string random_filename;
+  if ( filenames.empty() )
+  {
+    random_filename = fmt::format( "random_{}.bristol", num_gates );
+    fmt::print( "[i] writing random circuit with {} gates to {}\n", num_gates, random_filename );
+    write_random_bristol( random_filename, 512u, num_gates, 256u );
+    filenames.push_back( random_filename );
+  }
+
+  experiment<std::string, uint64_t, float, float, float, float, float, bool> exp( "bristol_parsing", "benchmark", "gates", "size [MB]", "lorina [s]", "fast [s]", fmt::format( "fast x{} [s]", num_threads ), "MB/s", "equivalent" );
+
+  for ( auto const& filename : filenames )
+  {
+    fmt::print( "[i] processing {}\n", filename );
+    std::ifstream in( filename, std::ifstream::binary | std::ifstream::ate );
+    const auto megabytes = in.tellg() / ( 1024.0f * 1024.0f );
+
+    xag_network xag_lorina;
+    stopwatch<>::duration time_lorina{ 0 };
+    {
+      stopwatch<> t( time_lorina );
+      if ( lorina::read_bristol( filename, bristol_reader( xag_lorina ) ) != lorina::return_code::success )
+      {
+        fmt::print( "[e] cannot read {}\n", filename );
+        continue;
+      }
+    }
+
+    xag_network xag_fast;
+    read_bristol_fast_stats st_fast;
+    if ( read_bristol_fast( filename, xag_fast, {}, &st_fast ) != lorina::return_code::success )
+    {
+      fmt::print( "[e] cannot read {}\n", filename );
+      continue;
+    }
+
+    xag_network xag_parallel;
+    read_bristol_fast_params ps;
+    ps.num_threads = num_threads;
+    read_bristol_fast_stats st_parallel;
+    stopwatch<>::duration time_parallel{ 0 };
+    {
+      stopwatch<> t( time_parallel );
+      read_bristol_fast( filename, xag_parallel, ps, &st_parallel );
+    }
+    st_parallel.report();
+
+    /* all readers create the same structurally hashed network */
+    const auto equivalent = xag_lorina._storage->nodes == xag_fast._storage->nodes && xag_fast._storage->nodes == xag_parallel._storage->nodes &&
+                            xag_lorina._storage->outputs == xag_parallel._storage->outputs;
+
+    const auto time_fast = to_seconds( st_fast.time_parse + st_fast.time_build );
+    exp( filename, st_fast.num_gates, megabytes, to_seconds( time_lorina ), time_fast, to_seconds( time_parallel ), megabytes / to_seconds( time_parallel ), equivalent );
+  }
+
+  if ( !random_filename.empty() )
+  {
+    std::remove( random_filename.c_str() );
+  }
+
+  exp.save();
+  exp.table();
+
+  return 0;
+}
@@ -0,0 +1,368 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if defined( BILL_HAS_Z3 )
+
+#include <bill/sat/interface/z3.hpp>
+#include <caterpillar/solvers/solver_manager.hpp>
+#include <caterpillar/solvers/z3_inplace_solver.hpp>
+#include <caterpillar/structures/circuit_sink.hpp>
+#include <caterpillar/structures/pebbling_view.hpp>
+#include <caterpillar/synthesis/lhrs.hpp>
+#include <caterpillar/synthesis/strategies/bennett_mapping_strategy.hpp>
+#include <fmt/format.h>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <lorina/aiger.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/exact_mc_synthesis.hpp>
+#include <mockturtle/algorithms/experimental/cost_generic_resub.hpp>
+#include <mockturtle/algorithms/node_resynthesis/bidecomposition.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc2.hpp>
+#include <mockturtle/algorithms/refactoring.hpp>
+#include <mockturtle/algorithms/rewrite.hpp>
+#include <mockturtle/algorithms/xag_optimization.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/io/bristol_reader.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/properties/mccost.hpp>
+#include <mockturtle/utils/cost_functions.hpp>
+#include <mockturtle/utils/recursive_cost_functions.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+#include <mockturtle/utils/tech_library.hpp>
+
+#include <experiments.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+/* 6-input functions with MC = 4 (see exact_mc_synthesis.cpp) */
+static const std::vector<uint64_t> practical6 = {
+    UINT64_C( 0x6996966996696996 ),
+    UINT64_C( 0x9669699669969669 ),
+    UINT64_C( 0x0000000069969669 ),
+    UINT64_C( 0x0000000096696996 ),
+    UINT64_C( 0x9669699600000000 ),
+    UINT64_C( 0x6996966900000000 ),
+    UINT64_C( 0x1ee1e11ee11e1ee1 ),
+    UINT64_C( 0xe11e1ee11ee1e11e ),
+    UINT64_C( 0x6996699669969669 ),
+    UINT64_C( 0x00000000e11e1ee1 ) };
+
+/* ISCAS and small EPFL benchmarks, on which every stage finishes in seconds */
+static const std::vector<std::string> aig_benchmarks = {
+    "c17", "c432", "c499", "c880", "c1355", "c1908", "c2670", "c3540", "c5315", "c6288", "c7552",
+    "adder", "bar", "cavlc", "ctrl", "dec", "int2float", "priority", "router" };
+
+/* creates a random circuit with the gate mix of typical Bristol crypto circuits */
+mockturtle::xag_network random_crypto_circuit( uint32_t num_pis, uint32_t num_gates, uint32_t num_pos )
+{
+  using namespace mockturtle;
+
+  std::mt19937 rng( 1 );
+  xag_network xag;
+  std::vector<xag_network::signal> wires;
+  for ( auto i = 0u; i < num_pis; ++i )
+  {
+    wires.push_back( xag.create_pi() );
+  }
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    /* prefer recent wires to get deep circuits with short-range fanins */
+    const auto n = static_cast<uint32_t>( wires.size() );
+    const auto a = wires[n - 1u - rng() % std::min( n, 1024u )];
+    const auto b = wires[n - 1u - rng() % std::min( n, 1024u )];
+    switch ( rng() % 8u )
+    {
+    case 0u:
+    case 1u:
+      wires.push_back( xag.create_and( a, b ) );
+      break;
+    case 2u:
+      wires.push_back( xag.create_not( a ) );
+      break;
+    default:
+      wires.push_back( xag.create_xor( a, b ) );
+      break;
+    }
+  }
+  for ( auto i = 0u; i < num_pos; ++i )
+  {
+    xag.create_po( wires[wires.size() - 1u - i] );
+  }
+  return mockturtle::cleanup_dangling( xag );
+}
+
+struct flow_regressions
+{
+  uint32_t gate_mismatches{ 0u };
+  uint32_t slowdowns{ 0u };
+};
+
+/* compares the last two datasets in `filename`: reports the stages whose gate
+   counts differ, and those whose runtime changed by more than `rel_tolerance`
+   (relative) and more than `abs_tolerance` seconds */
+flow_regressions report_regressions( std::string const& filename, float rel_tolerance, float abs_tolerance )
+{
+  flow_regressions result;
+
+  std::ifstream in( filename, std::ifstream::in );
+  if ( !in.good() )
+  {
+    return result;
+  }
+  const auto data = nlohmann::json::parse( in );
+  if ( data.size() < 2u )
+  {
+    return result;
+  }
+
+  auto const& entries_old = data[data.size() - 2u]["entries"];
+  auto const& entries_cur = data.back()["entries"];
+
+  uint32_t speedups{ 0u };
+  for ( auto const& cur : entries_cur )
+  {
+    const auto it = std::find_if( entries_old.begin(), entries_old.end(), [&]( auto const& old ) { return old["benchmark"] == cur["benchmark"]; } );
+    if ( it == entries_old.end() )
+    {
+      continue;
+    }
+    const auto name = cur["benchmark"].get<std::string>();
+
+    if ( ( *it )["gates after"] != cur["gates after"] || ( *it )["ANDs after"] != cur["ANDs after"] )
+    {
+      ++result.gate_mismatches;
+      fmt::print( "[e] {}: gates {} -> {}, ANDs {} -> {}\n", name, ( *it )["gates after"].get<uint32_t>(), cur["gates after"].get<uint32_t>(),
+                  ( *it )["ANDs after"].get<uint32_t>(), cur["ANDs after"].get<uint32_t>() );
+    }
+
+    const auto time_old = ( *it )["time [s]"].get<float>();
+    const auto time_cur = cur["time [s]"].get<float>();
+    if ( std::abs( time_cur - time_old ) <= std::max( abs_tolerance, rel_tolerance * time_old ) )
+    {
+      continue;
+    }
+
+    ( time_cur > time_old ? result.slowdowns : speedups )++;
+    fmt::print( "[{}] {}: {:.2f} s -> {:.2f} s\n", time_cur > time_old ? "w" : "i", name, time_old, time_cur );
+  }
+
+  fmt::print( "[i] {} gate count mismatches\n", result.gate_mismatches );
+  fmt::print( "[i] {} slowdowns and {} speedups beyond {:.0f}% and {:.2f} s\n", result.slowdowns, speedups, 100 * rel_tolerance, abs_tolerance );
+  return result;
+}
+
+/* usage: xag_flow_benchmark [file.bristol ...]
+ *
+ * Times each stage of the XAG optimization and quantum compilation flow on
+ * fixed inputs: the practical6 functions, the AIGs listed above, and the
+ * given Bristol circuits (or a fixed random crypto-like circuit if none is
+ * given).  Every row is one stage on one benchmark, keyed by
+ * `<benchmark>/<stage>`, and results are stored per git revision in
+ * xag_flow_benchmark.json, such that `compare` shows the differences to the
+ * previous revision.  Gate counts are compared exactly, runtimes against a
+ * tolerance; the exit code is non-zero if gate counts differ or a stage got
+ * slower, such that the benchmark can be run in CI.  All SAT-based stages are bounded by conflict or step limits
+ * rather than wall-clock timeouts, such that the gate counts do not depend
+ * on the machine. */
+int main( int argc, char** argv )
+{
+  using namespace experiments;
+  using namespace mockturtle;
+  using namespace mockturtle::experimental;
+
+  /* larger networks are skipped by the SAT-based stages */
+  constexpr uint32_t max_exact_linear_gates = 64u;
+  constexpr uint32_t max_pebbling_gates = 64u;
+
+  experiment<std::string, uint32_t, uint32_t, uint32_t, float> exp( "xag_flow_benchmark", "benchmark", "gates before", "gates after", "ANDs after", "time [s]" );
+
+  future::xag_minmc_resynthesis<xag_network> resyn;
+  exact_library_params eps;
+  eps.np_classification = false;
+  exact_library<xag_network, decltype( resyn )> exact_lib( resyn, eps );
+
+  /* runs `fn( xag )` and adds one row with its runtime */
+  const auto run_stage = [&]( std::string const& benchmark, std::string const& stage, xag_network& xag, auto&& fn ) {
+    const auto gates_before = xag.num_gates();
+    stopwatch<>::duration time{ 0 };
+    call_with_stopwatch( time, [&]() { fn( xag ); } );
+    exp( fmt::format( "{}/{}", benchmark, stage ), gates_before, xag.num_gates(), *multiplicative_complexity( xag ), to_seconds( time ) );
+  };
+
+  const auto has_complemented_edges = []( xag_network const& xag ) {
+    bool complemented{ false };
+    xag.foreach_gate( [&]( auto const& n ) {
+      xag.foreach_fanin( n, [&]( auto const& f ) { complemented |= xag.is_complemented( f ); } );
+    } );
+    xag.foreach_po( [&]( auto const& f ) { complemented |= xag.is_complemented( f ); } );
+    return complemented;
+  };
+
+  const auto optimization_flow = [&]( std::string const& benchmark, xag_network xag ) {
+    fmt::print( "[i] processing {}\n", benchmark );
+
+    if ( xag.num_gates() <= max_exact_linear_gates && !has_complemented_edges( xag ) )
+    {
+      run_stage( benchmark, "exact_linear_resynthesis_optimization", xag, []( auto& ntk ) {
+        ntk = cleanup_dangling( exact_linear_resynthesis_optimization<bill::solvers::z3>( ntk, 500000u ) );
+      } );
+    }
+    run_stage( benchmark, "xag_constant_fanin_optimization", xag, []( auto& ntk ) {
+      ntk = cleanup_dangling( xag_constant_fanin_optimization( ntk ) );
+    } );
+    run_stage( benchmark, "xag_dont_cares_optimization", xag, []( auto& ntk ) {
+      ntk = cleanup_dangling( xag_dont_cares_optimization( ntk ) );
+    } );
+    run_stage( benchmark, "cost_generic_resub", xag, []( auto& ntk ) {
+      cost_generic_resub( ntk, t_xag_depth_cost_function<xag_network>(), {} );
+      ntk = cleanup_dangling( ntk );
+    } );
+    run_stage( benchmark, "refactoring", xag, []( auto& ntk ) {
+      bidecomposition_resynthesis<xag_network> bidec;
+      refactoring( ntk, bidec );
+      ntk = cleanup_dangling( ntk );
+    } );
+    run_stage( benchmark, "rewrite", xag, [&]( auto& ntk ) {
+      rewrite( ntk, exact_lib, {}, nullptr, and_xor_cost<xag_network>{} );
+      ntk = cleanup_dangling( ntk );
+    } );
+
+    /* quantum compilation: for pebbling, "gates after" is the number of
+       pebbling steps; for synthesis, it is the number of quantum gates and
+       "ANDs after" the number of Toffoli gates */
+    if ( xag.num_gates() <= max_pebbling_gates )
+    {
+      caterpillar::pebbling_view<xag_network> pntk{ xag };
+      caterpillar::pebbling_mapping_strategy_params pps;
+      pps.pebble_limit = 4u;
+      pps.increment_pebbles_on_failure = true;
+      /* with as many pebbles as gates, Bennett's strategy needs fewer than 2n
+         steps; a failure with that many pebbles ends the search */
+      pps.max_pebble_limit = std::max( pps.pebble_limit, xag.num_gates() );
+      pps.max_steps = 2u * xag.num_gates();
+      pps.conflict_limit = 100000u;
+      pps.search_timeout = std::numeric_limits<uint32_t>::max();
+      stopwatch<>::duration time{ 0 };
+      const auto steps = call_with_stopwatch( time, [&]() {
+        return caterpillar::pebble<caterpillar::z3_pebble_inplace_solver<caterpillar::pebbling_view<xag_network>>>( pntk, pps );
+      } );
+      exp( fmt::format( "{}/pebbling", benchmark ), xag.num_gates(), static_cast<uint32_t>( steps.size() ), 0u, to_seconds( time ) );
+    }
+
+    caterpillar::function_sink sink( []( auto const&, auto const&, auto const& ) {} );
+    caterpillar::bennett_mapping_strategy<xag_network> strategy;
+    caterpillar::logic_network_synthesis_stats st;
+    caterpillar::logic_network_synthesis( sink, xag, strategy, {}, {}, &st );
+    exp( fmt::format( "{}/logic_network_synthesis", benchmark ), xag.num_gates(), static_cast<uint32_t>( sink.stats().num_gates ),
+         static_cast<uint32_t>( sink.stats().num_mcx ), to_seconds( st.time_total ) );
+  };
+
+  /* 6-input functions, starting with exact synthesis */
+  for ( auto const& word : practical6 )
+  {
+    kitty::dynamic_truth_table tt( 6u );
+    kitty::create_from_words( tt, &word, &word + 1 );
+    if ( kitty::get_bit( tt, 0u ) )
+    {
+      tt = ~tt;
+    }
+
+    const auto benchmark = fmt::format( "practical6-{:016x}", word );
+    exact_mc_synthesis_params ps;
+    ps.break_symmetric_variables = true;
+    ps.break_subset_symmetries = true;
+    ps.break_multi_level_subset_symmetries = true;
+    ps.ensure_to_use_gates = true;
+    ps.conflict_limit = 50000u;
+
+    /* an empty network is returned if the conflict limit is reached */
+    stopwatch<>::duration time{ 0 };
+    const auto xag = call_with_stopwatch( time, [&]() { return exact_mc_synthesis<xag_network, bill::solvers::z3>( tt, ps ); } );
+    if ( xag.num_pis() == 0u )
+    {
+      fmt::print( "[w] exact MC synthesis failed for {}, skipped\n", benchmark );
+      continue;
+    }
+    exp( fmt::format( "{}/exact_mc_synthesis", benchmark ), 0u, xag.num_gates(), *multiplicative_complexity( xag ), to_seconds( time ) );
+    optimization_flow( benchmark, xag );
+  }
+
+  for ( auto const& benchmark : aig_benchmarks )
+  {
+    xag_network xag;
+    if ( lorina::read_aiger( benchmark_path( benchmark ), aiger_reader( xag ) ) != lorina::return_code::success )
+    {
+      fmt::print( "[e] cannot read {}\n", benchmark );
+      continue;
+    }
+    optimization_flow( benchmark, xag );
+  }
+
+  if ( argc < 2 )
+  {
+    optimization_flow( "random_crypto", random_crypto_circuit( 256u, 4096u, 128u ) );
+  }
+  for ( auto i = 1; i < argc; ++i )
+  {
+    xag_network xag;
+    if ( read_bristol_fast( argv[i], xag ) != lorina::return_code::success )
+    {
+      fmt::print( "[e] cannot read {}\n", argv[i] );
+      continue;
+    }
+    optimization_flow( argv[i], xag );
+  }
+
+  exp.save();
+  exp.table();
+  exp.compare( {}, {}, { "gates after", "ANDs after" } );
+#ifndef EXPERIMENTS_PATH
+  const auto regressions = report_regressions( "xag_flow_benchmark.json", 0.25f, 0.05f );
+#else
+  const auto regressions = report_regressions( fmt::format( "{}xag_flow_benchmark.json", EXPERIMENTS_PATH ), 0.25f, 0.05f );
+#endif
+
+  return regressions.gate_mismatches == 0u && regressions.slowdowns == 0u ? 0 : 1;
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+  std::cout << "requires Z3" << std::endl;
+  return 0;
+}
+
+#endif
@@ -35,14 +35,25 @@
 #include <kitty/print.hpp>
 #include <mockturtle/algorithms/detail/minmc_xags.hpp>
 #include <mockturtle/algorithms/exact_mc_synthesis.hpp>
+#include <mockturtle/algorithms/exact_mc_synthesis_cache.hpp>
 #include <mockturtle/algorithms/xag_optimization.hpp>
 #include <mockturtle/io/index_list.hpp>
 #include <mockturtle/io/write_verilog.hpp>
 #include <mockturtle/properties/mccost.hpp>
 #include <mockturtle/utils/progress_bar.hpp>
 
+#include <mockturtle/utils/json_utils.hpp>
+#include <mockturtle/utils/truth_table_stream.hpp>
+
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 
 
@@ -51,6 +62,7 @@
 
 #include <caterpillar/caterpillar.hpp>
 #include "caterpillar/synthesis/strategies/pebbling_mapping_strategy.hpp"
+#include <caterpillar/synthesis/parallel_compilation.hpp>
 #include <caterpillar/details/utils.hpp>
 
 #include <tweedledum/io/write_unicode.hpp>
@@ -89,7 +101,7 @@
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/views/depth_view.hpp>
 
-#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc2.hpp>
 #include <mockturtle/algorithms/rewrite.hpp>
 #include <mockturtle/io/aiger_reader.hpp>
 #include <mockturtle/networks/xag.hpp>
@@ -97,8 +109,232 @@
 #include <mockturtle/views/depth_view.hpp>
 
 
-int main()
+/* path of a file written by the experiment, next to the experiment results */
+std::string experiments_file( std::string const& name )
+{
+#ifndef EXPERIMENTS_PATH
+  return name;
+#else
+  return fmt::format( "{}{}", EXPERIMENTS_PATH, name );
+#endif
+}
+
+/* XAG optimization pipeline, returns the network after each stage, starting with the input */
+template<class Library>
+std::vector<mockturtle::xag_network> optimization_pipeline( mockturtle::xag_network xag, Library const& exact_lib )
 {
+  using namespace mockturtle;
+  using namespace mockturtle::experimental;
+
+  /* networks share their storage when copied, store real copies such that later in-place passes do not change them */
+  std::vector<xag_network> variants;
+  std::vector<uint32_t> num_gates;
+  const auto add_stage = [&]() {
+    variants.push_back( cleanup_dangling( xag ) );
+    num_gates.push_back( variants.back().num_gates() );
+  };
+  add_stage();
+
+  /* linear resynthesis (requires linear parts without complemented edges) and AND reduction */
+  bool complemented{ false };
+  xag.foreach_gate( [&]( auto const& n ) {
+    xag.foreach_fanin( n, [&]( auto const& f ) { complemented |= xag.is_complemented( f ); } );
+  } );
+  xag.foreach_po( [&]( auto const& f ) { complemented |= xag.is_complemented( f ); } );
+  if ( !complemented )
+  {
+    xag = cleanup_dangling( windowed_exact_linear_resynthesis_optimization( xag ) );
+  }
+  xag = cleanup_dangling( xag_constant_fanin_optimization( xag ) );
+  xag = cleanup_dangling( xag_dont_cares_optimization( xag ) );
+  add_stage();
+
+  /* T-depth aware resubstitution */
+  cost_generic_resub_params rps;
+  cost_generic_resub( xag, t_xag_depth_cost_function<xag_network>(), rps );
+  xag = cleanup_dangling( xag );
+  add_stage();
+
+  bidecomposition_resynthesis<xag_network> bidec;
+  refactoring( xag, bidec );
+  xag = cleanup_dangling( xag );
+  add_stage();
+
+  /* rewrite with min-MC structures, ranking AND gates before XOR gates */
+  rewrite( xag, exact_lib, {}, nullptr, and_xor_cost<xag_network>{} );
+  add_stage();
+
+  for ( auto i = 0u; i < variants.size(); ++i )
+  {
+    if ( variants[i].num_gates() != num_gates[i] )
+    {
+      throw std::logic_error( fmt::format( "stage {} of the optimization pipeline was changed by a later pass", i + 1 ) );
+    }
+  }
+
+  return variants;
+}
+
+/* streams truth tables and writes one JSON line per function with the statistics of each pipeline stage */
+int batch_optimization( int argc, char** argv )
+{
+  using namespace mockturtle;
+
+  truth_table_stream_params ps;
+  std::string filename = "-";
+  std::string output = "-";
+  for ( auto i = 2; i < argc; ++i )
+  {
+    const std::string arg = argv[i];
+    if ( arg == "--binary" )
+    {
+      ps.format = truth_table_format::binary;
+    }
+    else if ( arg == "--num-vars" && i + 1 < argc )
+    {
+      ps.num_vars = std::stoul( argv[++i] );
+    }
+    else if ( arg == "--threads" && i + 1 < argc )
+    {
+      ps.num_threads = std::stoul( argv[++i] );
+    }
+    else if ( arg == "--output" && i + 1 < argc )
+    {
+      output = argv[++i];
+    }
+    else if ( arg == "--chunk-size" && i + 1 < argc )
+    {
+      ps.chunk_size = std::max( 1ul, std::stoul( argv[++i] ) );
+    }
+    else
+    {
+      filename = arg;
+    }
+  }
+  if ( ps.num_threads == 0u )
+  {
+    ps.num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  std::ifstream file;
+  if ( filename != "-" )
+  {
+    file.open( filename, ps.format == truth_table_format::binary ? std::ifstream::in | std::ifstream::binary : std::ifstream::in );
+    if ( !file.is_open() )
+    {
+      std::cerr << fmt::format( "[e] could not open {}\n", filename );
+      return 1;
+    }
+  }
+
+  /* some SAT solvers print to stdout, hence results can be written to a file instead */
+  std::ofstream output_file;
+  if ( output != "-" )
+  {
+    output_file.open( output );
+    if ( !output_file.is_open() )
+    {
+      std::cerr << fmt::format( "[e] could not open {}\n", output );
+      return 1;
+    }
+  }
+
+  exact_mc_synthesis_params mcps;
+  mcps.break_symmetric_variables = true;
+  mcps.break_subset_symmetries = true;
+  mcps.break_multi_level_subset_symmetries = true;
+  mcps.ensure_to_use_gates = true;
+  mcps.conflict_limit = 50000u;
+  mcps.ignore_conflict_limit_for_first_solution = true;
+
+  /* class representatives with known minimum MC XAGs, shared read-only by all workers */
+  std::vector<std::unordered_map<uint64_t, std::vector<uint32_t> const*>> minmc_db( mockturtle::detail::minmc_xags.size() );
+  for ( auto num_vars = 0u; num_vars < minmc_db.size(); ++num_vars )
+  {
+    for ( auto const& [cls, word, list, expr] : mockturtle::detail::minmc_xags[num_vars] )
+    {
+      (void)cls;
+      (void)expr;
+      minmc_db[num_vars].emplace( word, &list );
+    }
+  }
+  const auto synthesize = [&]( kitty::dynamic_truth_table const& func ) {
+    const auto num_vars = func.num_vars();
+    if ( num_vars < minmc_db.size() )
+    {
+      if ( const auto it = minmc_db[num_vars].find( func._bits[0] ); it != minmc_db[num_vars].end() )
+      {
+        return create_from_binary_index_list<xag_network>( it->second->begin() );
+      }
+    }
+    return exact_mc_synthesis<xag_network, bill::solvers::z3>( func, mcps );
+  };
+
+  /* per-thread caches and libraries, such that workers never share state; the
+     library is built once and loaded from xag_minmc.lib afterwards */
+  future::xag_minmc_resynthesis<xag_network> resyn;
+  exact_library_params eps;
+  eps.np_classification = false;
+  using library_t = exact_library<xag_network, decltype( resyn )>;
+  std::vector<std::unique_ptr<exact_mc_synthesis_cache<xag_network>>> caches;
+  std::vector<std::unique_ptr<library_t>> libraries;
+  for ( auto i = 0u; i < ps.num_threads; ++i )
+  {
+    caches.emplace_back( std::make_unique<exact_mc_synthesis_cache<xag_network>>( synthesize ) );
+    libraries.emplace_back( std::make_unique<library_t>( resyn, eps, experiments_file( "xag_minmc.lib" ) ) );
+  }
+
+  json_lines_writer out( output == "-" ? std::cout : output_file, true );
+  truth_table_stream_stats st;
+  std::atomic<uint64_t> num_errors{ 0u };
+  process_truth_table_stream(
+      filename == "-" ? std::cin : file, [&]( uint64_t index, kitty::dynamic_truth_table const& func, uint32_t thread_id ) {
+        stopwatch<>::duration time{};
+        nlohmann::json stages = nlohmann::json::array();
+        try
+        {
+          stopwatch<> t( time );
+          auto tt = func;
+          if ( kitty::get_bit( tt, 0u ) )
+          {
+            tt = ~tt;
+          }
+          for ( auto const& xag : optimization_pipeline( ( *caches[thread_id] )( tt ), *libraries[thread_id] ) )
+          {
+            const auto num_ands = *multiplicative_complexity( xag );
+            stages.push_back( { { "and", num_ands }, { "xor", xag.num_gates() - num_ands } } );
+          }
+        }
+        catch ( std::exception const& e )
+        {
+          /* an uncaught exception in a worker would terminate the whole batch */
+          ++num_errors;
+          out( { { "index", index }, { "function", kitty::to_hex( func ) }, { "error", e.what() } } );
+          return;
+        }
+        out( { { "index", index }, { "function", kitty::to_hex( func ) }, { "stages", stages }, { "time", to_seconds( time ) } } );
+      },
+      ps, &st );
+  out.flush();
+
+  std::cerr << fmt::format( "[i] optimized {} functions ({} invalid, {} failed) in {:.2f} secs\n", st.num_functions, st.num_invalid, num_errors.load(), to_seconds( st.time_total ) );
+  return num_errors == 0u ? 0 : 1;
+}
+
+/* usage: xag_optimizer [--cache]
+ *        xag_optimizer --batch <file|-> [--binary] [--num-vars N] [--threads N] [--chunk-size N] [--output <file>]
+ *
+ * With --cache, synthesis results are stored in and reused from `<flow>.cache`
+ * files; reused results are reported, since runtimes then include cache hits
+ * instead of synthesis. */
+int main( int argc, char** argv )
+{
+  if ( argc > 1 && std::string( argv[1] ) == "--batch" )
+  {
+    return batch_optimization( argc, argv );
+  }
+  const bool use_cache = argc > 1 && std::string( argv[1] ) == "--cache";
+
   using namespace experiments;
   using namespace mockturtle;
   using namespace mockturtle::experimental;
@@ -112,12 +348,43 @@ int main()
 
   experiment<std::string, uint32_t, uint32_t, double> exp( "exact_mc_synthesis", "name", "XOR gates", "AND gates", "total runtime" );
 
+  /* file name of a persistent synthesis cache, empty (no file) unless --cache is given */
+  const auto cache_filename = [&]( std::string const& prefix ) {
+    return use_cache ? experiments_file( prefix + ".cache" ) : std::string{};
+  };
+  const auto report_cached = [&]( exact_mc_synthesis_cache<xag_network> const& cache, std::string const& prefix ) {
+    if ( cache.size() != 0u )
+    {
+      fmt::print( "[i] reusing {} cached synthesis results from {}\n", cache.size(), cache_filename( prefix ) );
+    }
+  };
+
   // All spectral classes
   const auto all_spectral = [&]( uint32_t num_vars, bool multiple, bool minimize_xor, bool sat_linear_resyn ) {
     stopwatch<>::duration time{};
     uint32_t xor_gates{}, and_gates{};
     const auto prefix = fmt::format( "exact_mc_synthesis{}{}{}", multiple ? "-multiple" : "", minimize_xor ? "-xor" : "", sat_linear_resyn ? "-resyn" : "" );
     progress_bar pbar( mockturtle::detail::minmc_xags[num_vars].size(), prefix + " |{}| class = {}, function = {}, time so far = {:.2f}", true );
+
+    exact_mc_synthesis_params ps;
+    ps.break_symmetric_variables = true;
+    ps.break_subset_symmetries = true;
+    ps.break_multi_level_subset_symmetries = true;
+    ps.ensure_to_use_gates = true;
+    ps.auto_update_xor_bound = minimize_xor;
+    ps.conflict_limit = 50000u;
+    ps.ignore_conflict_limit_for_first_solution = true;
+
+    exact_mc_synthesis_cache<xag_network> cache( [&]( kitty::dynamic_truth_table const& func ) {
+      if ( multiple )
+      {
+        const auto xags = exact_mc_synthesis_multiple<xag_network, bill::solvers::z3>( func, 50u, ps );
+        return *std::min_element( xags.begin(), xags.end(), [&]( auto const& x1, auto const& x2 ) { return x1.num_gates() < x2.num_gates(); } );
+      }
+      return exact_mc_synthesis<xag_network, bill::solvers::z3>( func, ps );
+    }, cache_filename( prefix ) );
+    report_cached( cache, prefix );
+
     for ( auto const& [cls, word, list, expr] : mockturtle::detail::minmc_xags[num_vars] )
     {
       (void)expr;
@@ -132,26 +399,7 @@ int main()
       kitty::create_from_words( tt, &word, &word + 1 );
       pbar( cls, cls, kitty::to_hex( tt ), to_seconds( time ) );
 
-      exact_mc_synthesis_params ps;
-      ps.break_symmetric_variables = true;
-      ps.break_subset_symmetries = true;
-      ps.break_multi_level_subset_symmetries = true;
-      ps.ensure_to_use_gates = true;
-      ps.auto_update_xor_bound = minimize_xor;
-      ps.conflict_limit = 50000u;
-      ps.ignore_conflict_limit_for_first_solution = true;
-
-      xag_network xag;
-
-      if ( multiple )
-      {
-        const auto xags = exact_mc_synthesis_multiple<xag_network, bill::solvers::z3>( tt, 50u, ps );
-        xag = *std::min_element( xags.begin(), xags.end(), [&]( auto const& x1, auto const& x2 ) { return x1.num_gates() < x2.num_gates(); } );
-      }
-      else
-      {
-        xag = exact_mc_synthesis<xag_network, bill::solvers::z3>( tt, ps );
-      }
+      xag_network xag = cache( tt );
 
       if ( sat_linear_resyn )
       {
@@ -174,6 +422,10 @@ int main()
         std::abort();
       }
     }
+    if ( use_cache && cache.stats().cache_hits != 0u )
+    {
+      fmt::print( "[i] {} of {} synthesis results came from the cache\n", cache.stats().cache_hits, cache.stats().cache_hits + cache.stats().cache_misses );
+    }
     const auto name = fmt::format( "all-spectral-{}{}{}{}", num_vars, multiple ? "-multiple" : "", minimize_xor ? "-xor" : "", sat_linear_resyn ? "-resyn" : "" );
     exp( name, xor_gates, and_gates, to_seconds( time ) );
   };
@@ -288,6 +540,32 @@ int main()
 
     progress_bar pbar( static_cast<uint32_t>( functions.size() ), prefix + " |{}| function = {:016x}, time so far = {:.2f}", true );
 
+    exact_mc_synthesis_params ps;
+    ps.verbose = true;
+    ps.very_verbose = true;
+    ps.break_symmetric_variables = true;
+    ps.break_subset_symmetries = true;
+    ps.break_multi_level_subset_symmetries = true;
+    ps.ensure_to_use_gates = true;
+    ps.auto_update_xor_bound = minimize_xor;
+    ps.conflict_limit = 50000u;
+
+    /* affine-equivalent functions share one synthesized representative */
+    exact_mc_synthesis_cache<xag_network> cache( [&]( kitty::dynamic_truth_table const& func ) {
+      if ( multiple )
+      {
+        const auto xags = exact_mc_synthesis_multiple<xag_network, bill::solvers::z3>( func, 5u, ps );
+        return *std::min_element( xags.begin(), xags.end(), [&]( auto const& x1, auto const& x2 ) { return x1.num_gates() < x2.num_gates(); } );
+      }
+      return exact_mc_synthesis<xag_network, bill::solvers::z3>( func, ps );
+    }, cache_filename( prefix ) );
+    report_cached( cache, prefix );
+
+    future::xag_minmc_resynthesis<xag_network> resyn;
+    exact_library_params eps;
+    eps.np_classification = false;
+    exact_library<xag_network, decltype( resyn )> exact_lib( resyn, eps, experiments_file( "xag_minmc.lib" ) );
+
     for ( auto i = 0u; i < functions.size(); ++i )
     {
       stopwatch<> t( time );
@@ -301,212 +579,43 @@ int main()
       }
 
       pbar( i, functions[i], to_seconds( time ) );
-      
-      exact_mc_synthesis_params ps;
-      ps.verbose = true;
-      ps.very_verbose = true;
-      ps.break_symmetric_variables = true;
-      ps.break_subset_symmetries = true;
-      ps.break_multi_level_subset_symmetries = true;
-      ps.ensure_to_use_gates = true;
-      ps.auto_update_xor_bound = minimize_xor;
-      ps.conflict_limit = 50000u;
-
-      mockturtle::xag_network xag;
-      mockturtle::xag_network xagi1;
-      mockturtle::xag_network xagi11;
-      mockturtle::xag_network xagi2;
-      mockturtle::xag_network xagi3;
-      mockturtle::xag_network xagi4;
-       
-
-      if ( multiple )
-      {
-        const auto xags = exact_mc_synthesis_multiple<xag_network, bill::solvers::z3>( tt, 5u, ps );
-        xag = *std::min_element( xags.begin(), xags.end(), [&]( auto const& x1, auto const& x2 ) { return x1.num_gates() < x2.num_gates(); } );
-      }
-      else
-      {
-        xag = exact_mc_synthesis<xag_network, bill::solvers::z3>( tt, ps );
-      }
 
+      mockturtle::xag_network xag = cache( tt );
+      /* intermediate variants of the optimization pipeline */
+      std::vector<xag_network> variants{ xag };
       if ( sat_linear_resyn )
       {
-        fmt::print( "Linear resynthesis-XOR reduction\n");
-        
-        const auto numands1 = *multiplicative_complexity( xag );
-        const auto numxors1 = xag.num_gates() - numands1;
-        fmt::print( "\n  XorsXAGI1 = {}\n\n", numxors1) ;
-        fmt::print( "\n  AndsXAGI1 = {}\n\n", numands1 );
-        
-        xagi1=xag;
-        xag = exact_linear_resynthesis_optimization( xag, 500000u );
-        xag = cleanup_dangling( xag );
-        
-        fmt::print( " AND Reduction\n" );
-        xag = xag_constant_fanin_optimization(xag);
-        xag = cleanup_dangling( xag );
-        
-       
-        xag = xag_dont_cares_optimization(xag);
-        xag = cleanup_dangling( xag );
-        xagi11=xag;
-        const auto numands2 = *multiplicative_complexity( xag );
-        const auto numxors2 = xag.num_gates() - numands2;
-        fmt::print( "\n  XorsXAGI2 = {}\n\n", numxors2) ;
-        fmt::print( "\n  AndsXAGI2 = {}\n\n", numands2 );
-        
-        
-        auto costfn = t_xag_depth_cost_function<xag_network>();
-        cost_generic_resub_params ss;
-        cost_generic_resub_stats sts;
-        ss.verbose = true;
-
-        cost_generic_resub( xag, costfn, ss, &sts );
-        xagi2 = cleanup_dangling( xag );
-        xag = cleanup_dangling( xag );
-        const auto numands3 = *multiplicative_complexity( xag );
-        const auto numxors3 = xag.num_gates() - numands3;
-        fmt::print( "\n  XorsXAGI3 = {}\n\n", numxors3) ;
-        fmt::print( "\n  AndsXAGI3 = {}\n\n", numands3 );
-        bidecomposition_resynthesis<xag_network> reyn;
-        refactoring( xag, reyn );
-        xag = cleanup_dangling( xag );
-        xagi3 = xag;
-        
-        const auto numands4 = *multiplicative_complexity( xag );
-        const auto numxors4 = xag.num_gates() - numands4;
-        fmt::print( "\n  XorsXAGI4 = {}\n\n", numxors4) ;
-        fmt::print( "\n  AndsXAGI4 = {}\n\n", numands4 );
-        
-        xag_npn_resynthesis<xag_network, xag_network, xag_npn_db_kind::xag_incomplete> resyn;
-        
-        exact_library_params eps;
-        eps.np_classification = false;
-        exact_library<xag_network, decltype( resyn )> exact_lib( resyn, eps );
-        rewrite_params p;
-        rewrite_stats s;
-        rewrite( xag, exact_lib, p, &s );
-        xagi4 = cleanup_dangling( xag );
-        
-        const auto numands5 = *multiplicative_complexity( xag );
-        const auto numxors5 = xag.num_gates() - numands5;
-        fmt::print( "\n  XorsXAGI5 = {}\n\n", numxors5) ;
-        fmt::print( "\n  AndsXAGI5 = {}\n\n", numands5 );
-        
-        
+        variants = optimization_pipeline( xag, exact_lib );
+        for ( auto j = 0u; j < variants.size(); ++j )
+        {
+          const auto num_ands = *multiplicative_complexity( variants[j] );
+          fmt::print( "[i] i{}: XORs = {}, ANDs = {}\n", j + 1, variants[j].num_gates() - num_ands, num_ands );
+        }
       }
 
-      
-
       //xor_gates += num_xors;
       //and_gates += num_ands;
       
-      std::fstream FileName;                       
-      FileName.open("XAGStruct/i1.qasm", ios::out);     
-     
-      network_t pxagi1 {xagi1};
-
-      pebbling_mapping_strategy_params pssi1;
-      pssi1.pebble_limit = 4;
-      pebbling_mapping_strategy<network_t, z3_pebble_inplace_solver<network_t>> inplace_strategyi1 (pssi1);
-
-  
-      tweedledum::netlist<stg_gate> rneti1;
-      logic_network_synthesis_stats sti1;
-      logic_network_synthesis_params parami1;
-      parami1.verbose = false;
- 
-      caterpillar::logic_network_synthesis(rneti1, pxagi1, inplace_strategyi1, {}, parami1, &sti1);
-      //write_unicode(rnet);
-      writeqasm(rneti1,"XAGStruct/i1.qasm");
-      FileName.close();
-      
-      
-      FileName.open("XAGStruct/i2.qasm", ios::out);     
-     
-      network_t pxagi2 {xagi11};
-
-      pebbling_mapping_strategy_params pssi2;
-      pssi2.pebble_limit = 4;
-      pebbling_mapping_strategy<network_t, z3_pebble_inplace_solver<network_t>> inplace_strategyi2 (pssi2);
-
-  
-      tweedledum::netlist<stg_gate> rneti2;
-      logic_network_synthesis_stats sti2;
-      logic_network_synthesis_params parami2;
-      parami2.verbose = false;
- 
-      caterpillar::logic_network_synthesis(rneti2, pxagi2, inplace_strategyi2, {}, parami2, &sti2);
-      //write_unicode(rnet);
-      writeqasm(rneti2,"XAGStruct/i2.qasm");
-      FileName.close();
-      
-      FileName.open("XAGStruct/i3.qasm", ios::out);     
-     
-      network_t pxag {xagi2};
-
-      pebbling_mapping_strategy_params pss;
-      pss.pebble_limit = 4;
-      pebbling_mapping_strategy<network_t, z3_pebble_inplace_solver<network_t>> inplace_strategy (pss);
-
-  
-      tweedledum::netlist<stg_gate> rnet;
-      logic_network_synthesis_stats st;
-      logic_network_synthesis_params param;
-      param.verbose = false;
- 
-      caterpillar::logic_network_synthesis(rnet, pxag, inplace_strategy, {}, param, &st);
-      //write_unicode(rnet);
-      writeqasm(rnet,"XAGStruct/i3.qasm");
-      FileName.close();
-      
-      
-      FileName.open("XAGStruct/i4.qasm", ios::out);     
-       
-       
-      
-      network_t pxag4 {xagi3};
-
-      pebbling_mapping_strategy_params pss4;
-      pss4.pebble_limit = 4;
-      pebbling_mapping_strategy<network_t, z3_pebble_inplace_solver<network_t>> inplace_strategyi4 (pss4);
-
-  
-      tweedledum::netlist<stg_gate> rnet4;
-      logic_network_synthesis_stats st4;
-      logic_network_synthesis_params param4;
-      param.verbose = false;
- 
-      caterpillar::logic_network_synthesis(rnet4, pxag4, inplace_strategyi4, {}, param4, &st4);
-      //write_unicode(rnet);
-      writeqasm(rnet,"XAGStruct/i4.qasm");
-      FileName.close();
-      
-      
-      
-      
-      FileName.open("XAGStruct/i5.qasm", ios::out);     
-     
-      network_t pxag5 {xagi4};
+      /* compile all intermediate variants concurrently */
+      parallel_compilation_params pcps;
+      pcps.pebbling.pebble_limit = 4;
 
-      pebbling_mapping_strategy_params pss5;
-      pss5.pebble_limit = 4;
-      pebbling_mapping_strategy<network_t, z3_pebble_inplace_solver<network_t>> inplace_strategyi5 (pss5);
+      std::vector<tweedledum::netlist<stg_gate>> circuits;
+      const auto reports = compile_variants( variants, pcps, &circuits );
 
-  
-      tweedledum::netlist<stg_gate> rnet5;
-      logic_network_synthesis_stats st5;
-      logic_network_synthesis_params param5;
-      param.verbose = false;
- 
-      caterpillar::logic_network_synthesis(rnet5, pxag5, inplace_strategyi5, {}, param5, &st5);
-      //write_unicode(rnet);
-      writeqasm(rnet,"XAGStruct/i5.qasm");
-      FileName.close();
+      for ( auto j = 0u; j < circuits.size(); ++j )
+      {
+        const auto variant = fmt::format( "i{}", j + 1 );
+        reports[j].report( variant );
+        writeqasm( circuits[j], fmt::format( "XAGStruct/{}.qasm", variant ) );
+      }
       
       
       
+    }
+    if ( use_cache && cache.stats().cache_hits != 0u )
+    {
+      fmt::print( "[i] {} of {} synthesis results came from the cache\n", cache.stats().cache_hits, cache.stats().cache_hits + cache.stats().cache_misses );
     }
     const auto name = fmt::format( "practical6{}{}{}", multiple ? "-multiple" : "", minimize_xor ? "-xor" : "", sat_linear_resyn ? "-resyn" : "" );
     exp( name, xor_gates, and_gates, to_seconds( time ) );
@@ -40,8 +40,10 @@
 #include "caterpillar/solvers/z3_inplace_solver.hpp"
 #include "caterpillar/structures/stg_gate.hpp"
 #include "caterpillar/structures/abstract_network.hpp"
+#include "caterpillar/structures/circuit_sink.hpp"
 #include "caterpillar/structures/pebbling_view.hpp"
 #include "caterpillar/synthesis/lhrs.hpp"
+#include "caterpillar/synthesis/parallel_compilation.hpp"
 #include "caterpillar/synthesis/satbased_cnotrz.hpp"
 #include "caterpillar/synthesis/stg_to_mcx.hpp"
 #include "caterpillar/synthesis/strategies/action.hpp"
@@ -52,3 +54,4 @@
 #include "caterpillar/synthesis/strategies/pebbling_mapping_strategy.hpp"
 #include "caterpillar/synthesis/strategies/xag_mapping_strategy.hpp"
 #include "caterpillar/verification/circuit_to_logic_network.hpp"
+#include "caterpillar/verification/simulate_circuit.hpp"
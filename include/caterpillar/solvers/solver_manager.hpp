@@ -6,6 +6,8 @@
 #include <caterpillar/solvers/z3_solver.hpp>
 #include <type_traits>
 #include <limits>
+#include <memory>
+#include <utility>
 
 
 using namespace std::chrono;
@@ -13,6 +15,17 @@ using namespace std::chrono;
 namespace caterpillar
 {
 
+/*! \brief Strategy to search for the number of pebbling steps. */
+enum class pebbling_step_search
+{
+  /*! \brief Try one step after the other until satisfiable. */
+  linear,
+  /*! \brief Double the step increment until satisfiable, then binary search
+   *         for the least number of steps (requires a solver implementing
+   *         `reset_pebbles`, falls back to `linear` otherwise). */
+  exponential
+};
+
 struct pebbling_mapping_strategy_params
 {
   /*! \brief Show progress bar. */
@@ -39,19 +52,120 @@ struct pebbling_mapping_strategy_params
   /*! \brief Increment pebble numbers, if a failure occurs. */
   bool increment_pebbles_on_failure{false};
 
+  /*! \brief Largest pebble number reached by incrementing (0 means no limit). */
+  uint32_t max_pebble_limit{0u};
+
   /*! \brief Decrement pebble numbers, if satisfiable. */
   bool decrement_pebbles_on_success{false};
 
   /*! \brief Decrement max weight, if satisfiable. */
   bool optimize_weight{false};
 
+  /*! \brief Strategy to search for the number of steps. */
+  pebbling_step_search step_search{pebbling_step_search::linear};
+
+  /*! \brief Skip the steps below a structural lower bound without solving. */
+  bool step_lower_bound{true};
+
 };
 
 template<typename Ntk>
 using Steps = std::vector<std::pair<typename Ntk::node, mapping_strategy_action>>;
 
+namespace detail
+{
+
+/* solvers that can change the pebble limit without being rebuilt */
+template<class Solver, class = void>
+struct has_reset_pebbles : std::false_type
+{
+};
+
+template<class Solver>
+struct has_reset_pebbles<Solver, std::void_t<decltype( std::declval<Solver&>().reset_pebbles( 0, 0u ) )>> : std::true_type
+{
+};
+
+template<class Solver>
+inline constexpr bool has_reset_pebbles_v = has_reset_pebbles<Solver>::value;
+
+/* Lower bound on the number of steps of any pebbling strategy.
+ *
+ * A gate can be computed at the earliest in the step given by its depth, since
+ * its children must be pebbled in the step before.  A non-output gate must
+ * still be pebbled when its last parent is computed (an in-place XOR may
+ * release it in that same step) and can be uncomputed only after all its
+ * non-output parents have been uncomputed, as uncomputing a gate requires its
+ * children to be pebbled.  The bound is the latest of these events. */
+template<typename Ntk>
+uint32_t pebbling_step_lower_bound( Ntk const& ntk )
+{
+  std::vector<typename Ntk::node> gates;
+  std::vector<bool> is_gate( ntk.size(), false ), is_output( ntk.size(), false ), needed( ntk.size(), false );
+  std::vector<uint32_t> depth( ntk.size(), 0u ), uncompute( ntk.size(), 0u );
+
+  ntk.foreach_gate( [&]( auto const& n ) {
+    is_gate[ntk.node_to_index( n )] = true;
+    gates.push_back( n );
+  } );
+
+  uint32_t bound{0u};
+  for ( auto const& n : gates )
+  {
+    auto& d = depth[ntk.node_to_index( n )];
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      d = std::max( d, depth[ntk.node_to_index( ntk.get_node( f ) )] );
+    } );
+    ++d;
+  }
+
+  ntk.foreach_po( [&]( auto const& f ) {
+    const auto index = ntk.node_to_index( ntk.get_node( f ) );
+    is_output[index] = needed[index] = true;
+    bound = std::max( bound, depth[index] );
+  } );
+
+  for ( auto it = gates.rbegin(); it != gates.rend(); ++it )
+  {
+    const auto index = ntk.node_to_index( *it );
+    if ( !needed[index] )
+      continue;
+
+    if ( !is_output[index] )
+      bound = std::max( bound, uncompute[index] );
+
+    ntk.foreach_fanin( *it, [&]( auto const& f ) {
+      const auto child = ntk.node_to_index( ntk.get_node( f ) );
+      if ( !is_gate[child] )
+        return;
+
+      needed[child] = true;
+      uncompute[child] = std::max( uncompute[child], depth[index] );
+      if ( !is_output[index] )
+        uncompute[child] = std::max( uncompute[child], uncompute[index] + 1u );
+    } );
+  }
+
+  return bound;
+}
+
+} // namespace detail
+
+/*! \brief Finds a pebbling strategy with the least number of steps.
+ *
+ * If the solver implements `reset_pebbles`, a single solver instance is used
+ * for all pebble limits tried when `increment_pebbles_on_failure` or
+ * `decrement_pebbles_on_success` is set: the unrolled steps and learned
+ * clauses are kept and the pebble limit is passed as an assumption.  When
+ * decrementing, the search resumes from the last satisfiable step, since
+ * fewer pebbles can never require fewer steps.
+ *
+ * Steps below `detail::pebbling_step_lower_bound` are unrolled without calling
+ * the solver (`step_lower_bound`); `step_search` selects between the linear
+ * scan and an exponential/binary search over the unrolled steps.
+ */
 template <typename Solver, typename Ntk>
-inline Steps<Ntk> pebble (Ntk ntk, pebbling_mapping_strategy_params const& ps = {})
+inline Steps<Ntk> pebble (Ntk const& ntk, pebbling_mapping_strategy_params const& ps = {})
 {
   assert( !ps.decrement_pebbles_on_success || !ps.increment_pebbles_on_failure );
   assert( !ps.decrement_pebbles_on_success || !ps.optimize_weight );
@@ -60,61 +174,138 @@ inline Steps<Ntk> pebble (Ntk ntk, pebbling_mapping_strategy_params const& ps =
   auto limit = ps.pebble_limit;
   
   auto start = high_resolution_clock::now(); 
+  const auto timed_out = [&]() {
+    return duration_cast<seconds>(high_resolution_clock::now() - start).count() > ps.search_timeout;
+  };
+
+  const auto lower_bound = ps.step_lower_bound ? std::min( detail::pebbling_step_lower_bound( ntk ), ps.max_steps ) : 0u;
 
   Steps<Ntk> steps;
+  std::unique_ptr<Solver> solver;
+  uint32_t restart_step{0u};
   while ( true )
   {
-    Solver solver( ntk, limit, ps.conflict_limit, ps.solver_timeout);
-    typename Solver::result result;
-
-    solver.init();
+    if ( !solver || !detail::has_reset_pebbles_v<Solver> )
+    {
+      solver = std::make_unique<Solver>( ntk, limit, ps.conflict_limit, ps.solver_timeout );
+      solver->init();
+    }
+    else if constexpr ( detail::has_reset_pebbles_v<Solver> )
+    {
+      solver->reset_pebbles( limit, restart_step );
+    }
+    typename Solver::result result = solver->unknown();
 
     mockturtle::progress_bar bar( 100, "|{0}| current step = {1}", ps.progress );
 
-    do
+    /* no strategy has fewer steps than the lower bound */
+    while ( solver->current_step() + 1u < lower_bound )
+    {
+      solver->add_step();
+    }
+
+    if constexpr ( detail::has_reset_pebbles_v<Solver> )
     {
-      if ( solver.current_step() >= ps.max_steps )
+      if ( ps.step_search == pebbling_step_search::exponential )
       {
-        result = solver.unknown();
-        break;
+        /* all steps up to `lo` are unsatisfiable, `hi` is satisfiable */
+        auto lo = solver->current_step(), hi = lo, delta = 1u;
+
+        do
+        {
+          if ( lo >= ps.max_steps )
+          {
+            result = solver->unknown();
+            break;
+          }
+
+          hi = std::min( lo + delta, ps.max_steps );
+          bar( std::min<uint32_t>( hi, 100 ), hi );
+
+          while ( solver->current_step() < hi )
+            solver->add_step();
+          result = solver->solve();
+
+          if ( result == solver->unsat() )
+          {
+            lo = hi;
+            delta *= 2u;
+          }
+        } while ( result == solver->unsat() && !timed_out() );
+
+        while ( result == solver->sat() && hi - lo > 1u && !timed_out() )
+        {
+          const auto mid = lo + ( hi - lo ) / 2u;
+          solver->reset_pebbles( limit, mid - 1u );
+          solver->add_step();
+
+          const auto mid_result = solver->solve();
+          if ( mid_result == solver->sat() )
+            hi = mid;
+          else if ( mid_result == solver->unsat() )
+            lo = mid;
+          else
+            break;
+        }
+
+        /* restore the model of the least satisfiable step found */
+        if ( result == solver->sat() && solver->current_step() != hi )
+        {
+          solver->reset_pebbles( limit, hi - 1u );
+          solver->add_step();
+          result = solver->solve();
+        }
       }
+    }
 
-      bar( std::min<uint32_t>( solver.current_step(), 100 ), solver.current_step() );
+    if ( !detail::has_reset_pebbles_v<Solver> || ps.step_search == pebbling_step_search::linear )
+    {
+      do
+      {
+        if ( solver->current_step() >= ps.max_steps )
+        {
+          result = solver->unknown();
+          break;
+        }
 
-      solver.add_step();
-      result = solver.solve(); 
+        bar( std::min<uint32_t>( solver->current_step(), 100 ), solver->current_step() );
 
-    } while ( result == solver.unsat() && 
-        duration_cast<seconds>(high_resolution_clock::now() - start).count() <= ps.search_timeout);
+        solver->add_step();
+        result = solver->solve(); 
+
+      } while ( result == solver->unsat() && !timed_out() );
+    }
 
-    if ( result == solver.unknown() || result == solver.unsat() )
+    if ( result == solver->unknown() || result == solver->unsat() )
     {
-      if ( ps.increment_pebbles_on_failure )
+      if ( ps.increment_pebbles_on_failure && ( ps.max_pebble_limit == 0u || limit < ps.max_pebble_limit ) )
       {
         limit++;
+        restart_step = 0u;
         continue;
       }
     }
-    else if ( result == solver.sat() )
+    else if ( result == solver->sat() )
     {
-      solver.save_model();
+      solver->save_model();
       #ifdef USE_Z3
              
       if(ps.optimize_weight)
       {
         if constexpr (std::is_same_v<Solver, z3_pebble_solver<Ntk>>)
         { 
-          solver.optimize_solution();
+          solver->optimize_solution();
         }
       }
 
       #endif
 
-      steps = solver.extract_result();
+      steps = solver->extract_result();
 
       if ( ps.decrement_pebbles_on_success && limit > 1)
       {
         limit--;
+        restart_step = solver->current_step() - 1u;
         continue;
       }
 
@@ -95,12 +95,24 @@ public:
 		slv.add(mk_and(invar));
 		slv.add(!mk_or(curr.a));
 		slv.add(!mk_or(curr.i));
-
+		states.push_back(curr.s);
 	}
 
 	uint32_t current_step()
 	{
-		return num_steps;
+		return search_step;
+	}
+
+	/*! \brief Changes the pebble limit, keeping the unrolled steps.
+	 *
+	 * The step search restarts at `step`: following calls to `add_step`
+	 * reuse the transition relation of already unrolled steps.
+	 */
+	void reset_pebbles( int pebbles, uint32_t step = 0u )
+	{
+		pop_final_clauses();
+		_pebbles = pebbles + _net.num_pis() + 1;
+		search_step = std::min( step, num_steps );
 	}
 
 	result unsat() { return result::unsat; }
@@ -111,7 +123,14 @@ public:
 
 	void add_step()
 	{
+		if ( search_step < num_steps )
+		{
+			search_step+=1;
+			return;
+		}
+
 		num_steps+=1;
+		search_step = num_steps;
 
 		next.s = new_variable_set("s");
 		next.a = new_variable_set("a");
@@ -207,8 +226,10 @@ public:
 				slv.add( !next.i[var] );
 		}
 
-		if(_pebbles != 0)	
-			slv.add(atmost(next.s, _pebbles));
+		for ( auto const& [pebbles, sel] : limit_selectors )
+			slv.add( implies( sel, atmost( next.s, pebbles ) ) );
+
+		states.push_back(next.s);
 		curr = next;
 	}
 
@@ -217,7 +238,7 @@ public:
 	expr_vector weight_expr()
 	{
 		expr_vector clause (ctx);
-		for (uint32_t k=0; k<num_steps+1; k++)
+		for (uint32_t k=0; k<search_step+1; k++)
 		{
 			for (uint32_t i=0; i<curr.s.size(); i++)
 			{
@@ -234,26 +255,31 @@ public:
 	{
 		std::vector<uint32_t> o_nodes;
 
+		pop_final_clauses();
+		auto assumptions = limit_assumptions();
+
 		slv.push();
+		has_final_clauses = true;
 		_net.foreach_po([&](auto po_sign)
 		{
 			o_nodes.push_back(_net.get_node(po_sign));
 		});
 
 		/* add final clauses */
-		for (auto var=0u ; var<next.s.size(); var++)
+		auto const& final_s = states[search_step];
+		for (auto var=0u ; var<final_s.size(); var++)
 		{
 			if(std::find(o_nodes.begin(), o_nodes.end(), var) != o_nodes.end())
 			{
-				slv.add(curr.s[var]);
+				slv.add(final_s[var]);
 			}
 			else if ( var < _net.num_pis() + 1)
 			{
-				slv.add(curr.s[var]);
+				slv.add(final_s[var]);
 			}
 			else
 			{
-				slv.add(!curr.s[var]);
+				slv.add(!final_s[var]);
 			}
 			
 		}
@@ -265,16 +291,49 @@ public:
 		}
 
 		/* check result (drop final clauses if unsat)*/
-		auto result = slv.check();
+		auto result = slv.check(assumptions);
 		if (result == unsat())
 		{
-			slv.pop();
+			pop_final_clauses();
 		}
 
 		return result;
 	}
 
 
+	/* selector literal enabling the cardinality constraints of the current pebble limit */
+	expr pebble_limit_selector()
+	{
+		for ( auto const& [pebbles, sel] : limit_selectors )
+		{
+			if ( pebbles == _pebbles ) return sel;
+		}
+
+		auto sel = ctx.bool_const( fmt::format( "limit_{}", _pebbles ).c_str() );
+		for ( auto k = 1u; k < states.size(); k++ )
+			slv.add( implies( sel, atmost( states[k], _pebbles ) ) );
+
+		limit_selectors.emplace_back( _pebbles, sel );
+		return sel;
+	}
+
+	expr_vector limit_assumptions()
+	{
+		expr_vector assumptions (ctx);
+		if(_pebbles != 0) assumptions.push_back( pebble_limit_selector() );
+		return assumptions;
+	}
+
+	/* drop the final clauses of the last call to solve */
+	void pop_final_clauses()
+	{
+		if ( has_final_clauses )
+		{
+			slv.pop();
+			has_final_clauses = false;
+		}
+	}
+
 	void print()
 	{
 
@@ -283,7 +342,7 @@ public:
 		for(uint32_t n=0; n<curr.s.size(); n++)
 		{
 			std::cout << std::endl;
-			for(uint32_t k =0; k<num_steps+1; k++)
+			for(uint32_t k =0; k<search_step+1; k++)
 			{
 				auto s = fmt::format("s_{}_{}", k, n);
 				auto s_var = solution_model.eval(ctx.bool_const(s.c_str()));
@@ -309,7 +368,7 @@ public:
 		std::cout << "a var\n";
 		for(uint32_t n=0; n<curr.s.size(); n++)
 		{
-			for(uint32_t k =0; k<num_steps+1; k++)
+			for(uint32_t k =0; k<search_step+1; k++)
 			{
 				auto a = fmt::format("a_{}_{}", k, n);
 				auto a_var = solution_model.eval(ctx.bool_const(a.c_str()));
@@ -324,7 +383,7 @@ public:
 		for(uint32_t n=0; n<curr.s.size(); n++)
 		{
 			std::cout << n << " ";
-			for(uint32_t k =0; k<num_steps+1; k++)
+			for(uint32_t k =0; k<search_step+1; k++)
 			{
 				auto i = fmt::format("i_{}_{}", k, n);
 				auto i_var = solution_model.eval(ctx.bool_const(i.c_str()));
@@ -341,7 +400,7 @@ public:
 
 		std::vector<std::pair<mockturtle::node<pebbling_view<Ntk>>, mapping_strategy_action>> steps;
 
-		for (uint32_t k = 0; k <num_steps+1; k++)
+		for (uint32_t k = 0; k <search_step+1; k++)
 		{
 			/* pair<node, ? computing : uncomputing> */
 			std::vector<uint32_t> comp_act;
@@ -432,17 +491,23 @@ public:
 
 
 private:
-const Ntk _net;
-const int _pebbles;
+Ntk const& _net;
+int _pebbles;
 const int _max_weight;
 
 context ctx;
 solver slv;
 model solution_model;
 uint32_t num_steps = 0;
+uint32_t search_step = 0;
+bool has_final_clauses = false;
 variables curr;
 variables next;
 
+/* state variables of all unrolled steps and selectors of the pebble limits used so far */
+std::vector<expr_vector> states;
+std::vector<std::pair<int, expr>> limit_selectors;
+
 };
 
 
@@ -73,7 +73,7 @@ class z3_pebble_solver
 		auto w = 0u;
 		for(uint32_t n=0; n< current.s.size(); n++)
 		{
-			for(uint32_t k =0; k< num_steps+1; k++)
+			for(uint32_t k =0; k< search_step+1; k++)
 			{
 				auto a_var = solution_model.eval(ctx.bool_const(fmt::format("a_{}_{}", k, n).c_str()));
 				if (a_var.is_true()) 
@@ -88,6 +88,39 @@ class z3_pebble_solver
 		return w;
 	}
 
+	/* selector literal enabling the cardinality constraints of the current pebble limit */
+	expr pebble_limit_selector()
+	{
+		for ( auto const& [pebbles, sel] : limit_selectors )
+		{
+			if ( pebbles == _pebbles ) return sel;
+		}
+
+		auto sel = ctx.bool_const( fmt::format( "limit_{}", _pebbles ).c_str() );
+		for ( auto k = 1u; k < states.size(); k++ )
+			slv.add( implies( sel, atmost( states[k], _pebbles ) ) );
+
+		limit_selectors.emplace_back( _pebbles, sel );
+		return sel;
+	}
+
+	expr_vector limit_assumptions()
+	{
+		expr_vector assumptions (ctx);
+		if(_pebbles != 0) assumptions.push_back( pebble_limit_selector() );
+		return assumptions;
+	}
+
+	/* drop the final clauses of the last call to solve */
+	void pop_final_clauses()
+	{
+		if ( has_final_clauses )
+		{
+			slv.pop();
+			has_final_clauses = false;
+		}
+	}
+
 public:
 
 	using node = typename Ntk::node;
@@ -95,7 +128,7 @@ public:
 
 	uint32_t node_to_var( node n ) { return n - detail::resp_num_pis(_net); }
 	node var_to_node(uint32_t var) { return var + detail::resp_num_pis(_net); }
-	uint32_t current_step() { return num_steps; }
+	uint32_t current_step() { return search_step; }
 	result unsat() { return result::unsat; }
 	result sat() { return result::sat; }
 	result unknown() { return result::unknown; }
@@ -123,13 +156,31 @@ public:
 
 		slv.add(!mk_or(current.a));
 		slv.add(!mk_or(current.s));
+		states.push_back(current.s);
 	}
 
-	
+	/*! \brief Changes the pebble limit, keeping the unrolled steps.
+	 *
+	 * The step search restarts at `step`: following calls to `add_step`
+	 * reuse the transition relation of already unrolled steps.
+	 */
+	void reset_pebbles( int pebbles, uint32_t step = 0u )
+	{
+		pop_final_clauses();
+		_pebbles = pebbles;
+		search_step = std::min( step, num_steps );
+	}
 
 	void add_step()
 	{
+		if ( search_step < num_steps )
+		{
+			search_step+=1;
+			return;
+		}
+
 		num_steps+=1;
+		search_step = num_steps;
 
 		next.s = new_variable_set("s");
 		next.a = new_variable_set("a");
@@ -148,14 +199,17 @@ public:
 			slv.add( implies( current.s[var] == next.s[var], !next.a[var] ) );
 		}
 
-		if(_pebbles != 0)	slv.add(atmost(next.s, _pebbles));
+		for ( auto const& [pebbles, sel] : limit_selectors )
+			slv.add( implies( sel, atmost( next.s, pebbles ) ) );
+
+		states.push_back(next.s);
 		current = next;
 	}
 
 	expr_vector weight_expr()
 	{
 		expr_vector clause (ctx);
-		for (uint32_t k=0; k<num_steps+1; k++)
+		for (uint32_t k=0; k<search_step+1; k++)
 		{
 			for (uint32_t i=0; i<current.s.size(); i++)
 			{
@@ -177,29 +231,32 @@ public:
 
 	result solve()
 	{
-		
+		pop_final_clauses();
+		auto assumptions = limit_assumptions();
+
 		slv.push();
+		has_final_clauses = true;
 
 		/* add final clauses */
-		for (auto var=0u ; var<next.s.size(); var++)
+		auto const& final_s = states[search_step];
+		for (auto var=0u ; var<final_s.size(); var++)
 		{
 			if(std::find(o_nodes.begin(), o_nodes.end(), var_to_node(var)) == o_nodes.end())
 			{
-				slv.add( !current.s[var] );
+				slv.add( !final_s[var] );
 			}
 			else
 			{
-				slv.add(current.s[var]);
+				slv.add(final_s[var]);
 			}
 		}
 
 		/* check result (drop final clauses if unsat)*/
-		auto result = slv.check();
+		auto result = slv.check(assumptions);
 
-		
 		if (result == unsat())
 		{
-			slv.pop();
+			pop_final_clauses();
 		}
 
 		return result;
@@ -214,7 +271,7 @@ public:
 		{
 			slv.push();	
 			slv.add(atmost(w_expr, w - 1));
-			auto res = slv.check();
+			auto res = slv.check(limit_assumptions());
 
 			if(res == sat())
 			{
@@ -240,7 +297,7 @@ public:
 		std::cout << "\nState variables:" << std::endl;
 		for(uint32_t n=0; n<current.s.size(); n++)
 		{
-			for(uint32_t k =0; k<num_steps+1; k++)
+			for(uint32_t k =0; k<search_step+1; k++)
 			{
 				auto s = fmt::format("s_{}_{}", k, n);
 				auto s_var = solution_model.eval(ctx.bool_const(s.c_str()));
@@ -253,7 +310,7 @@ public:
 		std::cout << "\nActivation variables:" << std::endl;
 		for(uint32_t n=0; n<current.s.size(); n++)
 		{
-			for(uint32_t k =0; k<num_steps+1; k++)
+			for(uint32_t k =0; k<search_step+1; k++)
 			{
 				auto a = fmt::format("a_{}_{}", k, n);
 				auto a_var = solution_model.eval(ctx.bool_const(a.c_str()));
@@ -285,7 +342,7 @@ public:
 	{
 		std::vector<std::pair<mockturtle::node<pebbling_view<Ntk>>, mapping_strategy_action>> steps;
 
-		for (uint32_t k = 0; k <num_steps+1; k++)
+		for (uint32_t k = 0; k <search_step+1; k++)
 		{
 			std::vector<uint32_t> comp_act;
 			std::vector<uint32_t> uncomp_act;
@@ -340,19 +397,25 @@ public:
 	}
 
 private:
-	const Ntk _net;
+	Ntk const& _net;
 	std::vector<uint32_t> o_nodes;
 
-	const int _pebbles;
+	int _pebbles;
 
 	context ctx;
 	solver slv;
 	model solution_model;
 
 	uint32_t num_steps = 0;
+	uint32_t search_step = 0;
+	bool has_final_clauses = false;
 	variables current;
 	variables next;
 
+	/* state variables of all unrolled steps and selectors of the pebble limits used so far */
+	std::vector<expr_vector> states;
+	std::vector<std::pair<int, expr>> limit_selectors;
+
 };
 
 
@@ -0,0 +1,387 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstdint>
+#include <fmt/format.h>
+#include <functional>
+#include <iostream>
+#include <ostream>
+#include <tweedledum/gates/gate_base.hpp>
+#include <tweedledum/gates/gate_set.hpp>
+#include <tweedledum/networks/qubit.hpp>
+#include <vector>
+
+namespace caterpillar
+{
+
+/*! \brief Gate counts of a streamed circuit. */
+struct circuit_sink_stats
+{
+  /*! \brief Number of gates. */
+  uint64_t num_gates{0u};
+
+  /*! \brief Number of single-qubit gates. */
+  uint64_t num_single_qubit{0u};
+
+  /*! \brief Number of CNOT gates. */
+  uint64_t num_cnots{0u};
+
+  /*! \brief Number of multiple-controlled Toffoli gates. */
+  uint64_t num_mcx{0u};
+
+  /*! \brief Number of T and T-dagger gates. */
+  uint64_t num_t{0u};
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] gates = {} (single-qubit = {}, CNOT = {}, MCX = {}, T = {})\n",
+                              num_gates, num_single_qubit, num_cnots, num_mcx, num_t );
+  }
+};
+
+/*! \brief Quantum circuit which forwards gates instead of storing them.
+ *
+ * Implements the part of the network interface that is needed by
+ * `logic_network_synthesis` (`add_qubit`, `num_qubits`, and `add_gate`), such
+ * that a circuit can be emitted gate by gate while it is synthesized.  Only
+ * the number of qubits is stored.  Derived classes consume the gates in
+ * `on_gate`, where all gates are normalized to lists of controls and targets.
+ *
+ * Since the gates are not stored, circuits written to a sink cannot be
+ * checked by `logic_network_synthesis`.
+ */
+class circuit_sink
+{
+public:
+  explicit circuit_sink( bool count_gates = true )
+      : count_gates( count_gates )
+  {
+  }
+
+  virtual ~circuit_sink() = default;
+
+  uint32_t add_qubit()
+  {
+    on_qubit( _num_qubits );
+    return _num_qubits++;
+  }
+
+  uint32_t num_qubits() const
+  {
+    return _num_qubits;
+  }
+
+  void add_gate( tweedledum::gate_base const& op, tweedledum::qubit_id target )
+  {
+    _controls.clear();
+    _targets.assign( 1u, target );
+    emit( op );
+  }
+
+  void add_gate( tweedledum::gate_base const& op, tweedledum::qubit_id control, tweedledum::qubit_id target )
+  {
+    _controls.assign( 1u, control );
+    _targets.assign( 1u, target );
+    emit( op );
+  }
+
+  void add_gate( tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& controls,
+                 std::vector<tweedledum::qubit_id> const& targets )
+  {
+    _controls.assign( controls.begin(), controls.end() );
+    _targets.assign( targets.begin(), targets.end() );
+    emit( op );
+  }
+
+  /*! \brief Gate counts (empty if counting is disabled). */
+  circuit_sink_stats const& stats() const
+  {
+    return _stats;
+  }
+
+protected:
+  virtual void on_qubit( uint32_t qubit )
+  {
+    (void)qubit;
+  }
+
+  virtual void on_gate( tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& controls,
+                        std::vector<tweedledum::qubit_id> const& targets ) = 0;
+
+private:
+  void emit( tweedledum::gate_base const& op )
+  {
+    if ( count_gates )
+    {
+      ++_stats.num_gates;
+      switch ( op.operation() )
+      {
+      case tweedledum::gate_set::cx:
+        ++_stats.num_cnots;
+        break;
+      case tweedledum::gate_set::mcx:
+        ++_stats.num_mcx;
+        break;
+      case tweedledum::gate_set::t:
+      case tweedledum::gate_set::t_dagger:
+        ++_stats.num_t;
+        ++_stats.num_single_qubit;
+        break;
+      default:
+        if ( op.is_single_qubit() )
+          ++_stats.num_single_qubit;
+        break;
+      }
+    }
+    on_gate( op, _controls, _targets );
+  }
+
+private:
+  bool count_gates;
+  uint32_t _num_qubits{0u};
+  circuit_sink_stats _stats;
+
+  /* reused for every gate to avoid allocations */
+  std::vector<tweedledum::qubit_id> _controls;
+  std::vector<tweedledum::qubit_id> _targets;
+};
+
+/*! \brief Circuit sink which passes every gate to a function.
+ *
+ * The function is called as `fn( op, controls, targets )`; the control and
+ * target lists are only valid during the call.
+ */
+class function_sink : public circuit_sink
+{
+public:
+  using gate_fn_t = std::function<void( tweedledum::gate_base const&, std::vector<tweedledum::qubit_id> const&,
+                                        std::vector<tweedledum::qubit_id> const& )>;
+
+  explicit function_sink( gate_fn_t const& fn, bool count_gates = true )
+      : circuit_sink( count_gates ), fn( fn )
+  {
+  }
+
+protected:
+  void on_gate( tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& controls,
+                std::vector<tweedledum::qubit_id> const& targets ) override
+  {
+    fn( op, controls, targets );
+  }
+
+private:
+  gate_fn_t fn;
+};
+
+/*! \brief Circuit sink which writes OPENQASM 2.0.
+ *
+ * Gates are written in the same way as by `tweedledum::write_qasm`, but into
+ * a buffer which is flushed to the stream whenever it exceeds `buffer_size`
+ * bytes.  Since the number of qubits is only known at the end, the `qreg`
+ * and `creg` declarations are written with a placeholder, which is
+ * overwritten by `finish` (or the destructor); the declarations are then
+ * padded with trailing spaces.  This requires a seekable
+ * stream, such as a file; for other streams, the number of qubits must be
+ * passed to the constructor.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      std::ofstream os( "circuit.qasm" );
+      qasm_sink sink( os );
+      logic_network_synthesis( sink, xag, strategy );
+      sink.finish();
+      sink.stats().report();
+   \endverbatim
+ */
+class qasm_sink : public circuit_sink
+{
+public:
+  /*! \brief Constructor.
+   *
+   * \param os Output stream
+   * \param num_qubits Number of declared qubits (0 means that they are
+   *                   declared by `finish`)
+   * \param count_gates Count gates on the fly
+   * \param buffer_size Size of the write buffer in bytes
+   */
+  explicit qasm_sink( std::ostream& os, uint32_t num_qubits = 0u, bool count_gates = true, uint32_t buffer_size = 1u << 16 )
+      : circuit_sink( count_gates ), os( os ), declared_qubits( num_qubits ), buffer_size( buffer_size )
+  {
+    fmt::format_to( buffer, "OPENQASM 2.0;\ninclude \"qelib1.inc\";\n" );
+    if ( declared_qubits == 0u )
+    {
+      flush();
+      header_pos = os.tellp();
+    }
+    write_registers( declared_qubits );
+  }
+
+  ~qasm_sink() override
+  {
+    finish();
+  }
+
+  /*! \brief Flushes the buffer and declares the qubits.
+   *
+   * Returns false if the qubits cannot be declared, i.e., if the stream is
+   * not seekable or more qubits are used than passed to the constructor.
+   */
+  bool finish()
+  {
+    flush();
+    if ( finished )
+      return result;
+    finished = true;
+
+    if ( declared_qubits != 0u )
+    {
+      result = num_qubits() <= declared_qubits;
+    }
+    else if ( header_pos == std::streampos( -1 ) )
+    {
+      result = false;
+    }
+    else
+    {
+      const auto end = os.tellp();
+      os.seekp( header_pos );
+      write_registers( num_qubits() );
+      flush();
+      os.seekp( end );
+      result = static_cast<bool>( os );
+    }
+    return result;
+  }
+
+protected:
+  void on_gate( tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& controls,
+                std::vector<tweedledum::qubit_id> const& targets ) override
+  {
+    using tweedledum::gate_set;
+
+    switch ( op.operation() )
+    {
+    default:
+      std::cerr << "[w] unsupported gate type\n";
+      break;
+
+    case gate_set::hadamard:
+      write_single( "h", targets );
+      break;
+    case gate_set::pauli_x:
+      write_single( "x", targets );
+      break;
+    case gate_set::pauli_z:
+      write_single( "z", targets );
+      break;
+    case gate_set::phase:
+      write_single( "s", targets );
+      break;
+    case gate_set::phase_dagger:
+      write_single( "sdg", targets );
+      break;
+    case gate_set::t:
+      write_single( "t", targets );
+      break;
+    case gate_set::t_dagger:
+      write_single( "tdg", targets );
+      break;
+    case gate_set::rotation_z:
+      write_rotation( "rz", op, targets );
+      break;
+    case gate_set::rotation_y:
+      write_rotation( "ry", op, targets );
+      break;
+    case gate_set::rotation_x:
+      write_rotation( "rx", op, targets );
+      break;
+
+    case gate_set::cx:
+    case gate_set::mcx:
+      write_negations( controls );
+      switch ( controls.size() )
+      {
+      default:
+        std::cerr << "[w] unsupported control size\n";
+        break;
+      case 0u:
+        write_single( "x", targets );
+        break;
+      case 1u:
+        /* same spacing as write_qasm, which differs for CX and MCX gates */
+        for ( auto t : targets )
+          fmt::format_to( buffer, op.operation() == gate_set::cx ? "cx q[{}], q[{}];\n" : "cx q[{}],q[{}];\n", controls[0].index(), t.index() );
+        break;
+      case 2u:
+        for ( auto i = 1u; i < targets.size(); ++i )
+          fmt::format_to( buffer, "cx q[{}], q[{}];\n", targets[0].index(), targets[i].index() );
+        fmt::format_to( buffer, "ccx q[{}], q[{}], q[{}];\n", controls[0].index(), controls[1].index(), targets[0].index() );
+        for ( auto i = 1u; i < targets.size(); ++i )
+          fmt::format_to( buffer, "cx q[{}], q[{}];\n", targets[0].index(), targets[i].index() );
+        break;
+      }
+      write_negations( controls );
+      break;
+    }
+
+    if ( buffer.size() >= buffer_size )
+      flush();
+  }
+
+private:
+  void write_single( char const* name, std::vector<tweedledum::qubit_id> const& targets )
+  {
+    for ( auto t : targets )
+      fmt::format_to( buffer, "{} q[{}];\n", name, t.index() );
+  }
+
+  void write_rotation( char const* name, tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& targets )
+  {
+    for ( auto t : targets )
+      fmt::format_to( buffer, "{}({}) q[{}];\n", name, op.rotation_angle().numeric_value(), t.index() );
+  }
+
+  void write_negations( std::vector<tweedledum::qubit_id> const& controls )
+  {
+    for ( auto c : controls )
+      if ( c.is_complemented() )
+        fmt::format_to( buffer, "x q[{}];\n", c.index() );
+  }
+
+  void write_registers( uint32_t n )
+  {
+    if ( declared_qubits == 0u )
+    {
+      /* fixed width with trailing spaces, such that the placeholder can be overwritten */
+      fmt::format_to( buffer, "{:<19}\n{:<19}\n", fmt::format( "qreg q[{}];", n ), fmt::format( "creg c[{}];", n ) );
+    }
+    else
+    {
+      fmt::format_to( buffer, "qreg q[{}];\ncreg c[{}];\n", n, n );
+    }
+  }
+
+  void flush()
+  {
+    os.write( buffer.data(), buffer.size() );
+    buffer.clear();
+  }
+
+private:
+  std::ostream& os;
+  uint32_t declared_qubits;
+  uint32_t buffer_size;
+  fmt::memory_buffer buffer;
+  std::streampos header_pos{-1};
+  bool finished{false};
+  bool result{false};
+};
+
+} // namespace caterpillar
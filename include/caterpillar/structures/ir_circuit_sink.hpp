@@ -0,0 +1,158 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "circuit_sink.hpp"
+#include "stg_gate.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <tweedledum/IR/Circuit.h>
+#include <tweedledum/IR/Qubit.h>
+#include <tweedledum/Operators/Standard.h>
+#include <tweedledum/gates/gate_set.hpp>
+#include <tweedledum/networks/netlist.hpp>
+#include <vector>
+
+namespace caterpillar
+{
+
+/*! \brief Circuit sink which appends gates to a `tweedledum::Circuit`.
+ *
+ * Bridges the `netlist<stg_gate>` based synthesis in caterpillar and the
+ * passes of tweedledum which operate on the `Circuit` IR, such as
+ * `phase_folding`.  Gates are translated in the same way as by `qasm_sink`:
+ * complemented controls are realized by X gates around the controlled gate,
+ * and a controlled gate with several targets becomes one X gate per target.
+ * Gates with control functions are not supported.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      tweedledum::Circuit circuit;
+      ir_circuit_sink sink( circuit );
+      logic_network_synthesis( sink, xag, strategy );
+      circuit = tweedledum::phase_folding( circuit );
+   \endverbatim
+ */
+class ir_circuit_sink : public circuit_sink
+{
+public:
+  explicit ir_circuit_sink( tweedledum::Circuit& circuit, bool count_gates = true )
+      : circuit_sink( count_gates ), circuit( circuit )
+  {
+  }
+
+protected:
+  void on_qubit( uint32_t qubit ) override
+  {
+    (void)qubit;
+    qubits.push_back( circuit.create_qubit() );
+  }
+
+  void on_gate( tweedledum::gate_base const& op, std::vector<tweedledum::qubit_id> const& controls,
+                std::vector<tweedledum::qubit_id> const& targets ) override
+  {
+    using tweedledum::gate_set;
+    namespace Op = tweedledum::Op;
+
+    switch ( op.operation() )
+    {
+    default:
+      std::cerr << "[w] unsupported gate type\n";
+      break;
+
+    case gate_set::hadamard:
+      apply_single( Op::H(), targets );
+      break;
+    case gate_set::pauli_x:
+      apply_single( Op::X(), targets );
+      break;
+    case gate_set::pauli_z:
+      apply_single( Op::Z(), targets );
+      break;
+    case gate_set::phase:
+      apply_single( Op::S(), targets );
+      break;
+    case gate_set::phase_dagger:
+      apply_single( Op::Sdg(), targets );
+      break;
+    case gate_set::t:
+      apply_single( Op::T(), targets );
+      break;
+    case gate_set::t_dagger:
+      apply_single( Op::Tdg(), targets );
+      break;
+    case gate_set::rotation_z:
+      apply_single( Op::Rz( op.rotation_angle().numeric_value() ), targets );
+      break;
+    case gate_set::rotation_y:
+      apply_single( Op::Ry( op.rotation_angle().numeric_value() ), targets );
+      break;
+    case gate_set::rotation_x:
+      apply_single( Op::Rx( op.rotation_angle().numeric_value() ), targets );
+      break;
+
+    case gate_set::cx:
+    case gate_set::mcx:
+      apply_negations( controls );
+      for ( auto t : targets )
+      {
+        _qubits.clear();
+        for ( auto c : controls )
+          _qubits.push_back( qubits[c.index()] );
+        _qubits.push_back( qubits[t.index()] );
+        circuit.apply_operator( Op::X(), _qubits );
+      }
+      apply_negations( controls );
+      break;
+    }
+  }
+
+private:
+  template<class OpT>
+  void apply_single( OpT const& optor, std::vector<tweedledum::qubit_id> const& targets )
+  {
+    for ( auto t : targets )
+      circuit.apply_operator( optor, { qubits[t.index()] } );
+  }
+
+  void apply_negations( std::vector<tweedledum::qubit_id> const& controls )
+  {
+    for ( auto c : controls )
+      if ( c.is_complemented() )
+        circuit.apply_operator( tweedledum::Op::X(), { qubits[c.index()] } );
+  }
+
+private:
+  tweedledum::Circuit& circuit;
+  std::vector<tweedledum::Qubit> qubits;
+
+  /* reused for every gate to avoid allocations */
+  std::vector<tweedledum::Qubit> _qubits;
+};
+
+/*! \brief Converts a circuit of `stg_gate`s into a `tweedledum::Circuit`.
+ *
+ * Gates are translated as by `ir_circuit_sink`.
+ */
+inline tweedledum::Circuit to_ir_circuit( tweedledum::netlist<stg_gate> const& netlist )
+{
+  tweedledum::Circuit circuit;
+  ir_circuit_sink sink( circuit, false );
+  for ( auto i = 0u; i < netlist.num_qubits(); ++i )
+  {
+    sink.add_qubit();
+  }
+  netlist.foreach_cgate( [&]( auto const& node ) {
+    sink.add_gate( node.gate, node.gate.controls(), node.gate.targets() );
+  } );
+  return circuit;
+}
+
+} // namespace caterpillar
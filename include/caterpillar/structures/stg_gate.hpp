@@ -65,6 +65,12 @@ public:
     return td::gate_base::is_unitary_gate() || operation() == td::gate_set::num_defined_ops;
   }
 
+  /*! \brief Control function (empty unless the gate was created from a function). */
+  kitty::dynamic_truth_table const& function() const
+  {
+    return _function;
+  }
+
   uint32_t num_controls() const
   {
     return _controls.size();
@@ -6,10 +6,13 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 #include "../structures/stg_gate.hpp"
+#include "../verification/simulate_circuit.hpp"
 #include "strategies/mapping_strategy.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <deque>
 #include <fmt/format.h>
 #include <mockturtle/algorithms/cut_enumeration/spectr_cut.hpp>
 #include <mockturtle/traits.hpp>
@@ -17,8 +20,10 @@
 #include <mockturtle/utils/stopwatch.hpp>
 #include <mockturtle/views/topo_view.hpp>
 #include <tweedledum/algorithms/synthesis/stg.hpp>
+#include <optional>
 #include <stack>
 #include <fmt/format.h>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -30,6 +35,17 @@ namespace caterpillar
 
 namespace mt = mockturtle;
 
+/*! \brief Policy to choose among the released ancillae. */
+enum class ancilla_allocation
+{
+  /*! \brief Most recently released ancilla first. */
+  lifo,
+  /*! \brief Least recently released ancilla first (round-robin). */
+  fifo,
+  /*! \brief Ancilla with the lowest current depth first. */
+  depth_aware
+};
+
 struct logic_network_synthesis_params
 {
   /*! \brief Be verbose. */
@@ -37,6 +53,22 @@ struct logic_network_synthesis_params
 
   bool low_tdepth_AND{false};
 
+  /*! \brief Reuse policy for released ancillae.
+   *
+   * LIFO hands out the ancilla that was just released, such that its next
+   * use depends on all gates that were just applied on it.  FIFO and the
+   * depth-aware policy trade this false dependency for a larger spread over
+   * the available ancillae, and hence usually a lower depth.  The number of
+   * qubits is not affected by the policy, as long as there are free
+   * ancillae a new qubit is never added.
+   */
+  ancilla_allocation ancillae{ancilla_allocation::lifo};
+
+  /*! \brief Check the circuit against the logic network by simulation. */
+  bool verify{true};
+
+  /*! \brief Parameters for the simulation-based check. */
+  circuit_simulation_params verification;
 };
 
 struct logic_network_synthesis_stats
@@ -47,21 +79,48 @@ struct logic_network_synthesis_stats
   /*! \brief Required number of ancilla. */
   uint32_t required_ancillae{0u};
 
+  /*! \brief Number of qubits in the circuit. */
+  uint32_t num_qubits{0u};
+
+  /*! \brief Depth of the circuit (every gate counts as one layer). */
+  uint32_t depth{0u};
+
   /*! \brief output qubits. */
   std::vector<uint32_t> o_indexes;
 
   /*! \brief input qubits. */
   std::vector<uint32_t> i_indexes;
 
+  /*! \brief Result of the simulation-based check (unset if not checked). */
+  std::optional<bool> verified;
+
+  /*! \brief Runtime for the simulation-based check. */
+  mockturtle::stopwatch<>::duration time_verification{0};
+
   void report() const
   {
+    std::cout << fmt::format( "[i] qubits = {} ({} ancillae), depth = {}\n", num_qubits, required_ancillae, depth );
     std::cout << fmt::format( "[i] total time = {:>5.2f} secs\n", mockturtle::to_seconds( time_total ) );
+    if ( verified )
+    {
+      std::cout << fmt::format( "[i] verification = {} ({:>5.2f} secs)\n", *verified ? "passed" : "FAILED", mockturtle::to_seconds( time_verification ) );
+    }
   }
 };
 
 namespace detail
 {
 
+template<class QuantumNetwork, class = void>
+struct has_foreach_cgate : std::false_type
+{
+};
+
+template<class QuantumNetwork>
+struct has_foreach_cgate<QuantumNetwork, std::void_t<decltype( std::declval<QuantumNetwork>().foreach_cgate( std::declval<void( int )>() ) )>> : std::true_type
+{
+};
+
 template<class QuantumNetwork, class LogicNetwork, class SingleTargetGateSynthesisFn>
 class logic_network_synthesis_impl
 {
@@ -204,6 +263,9 @@ public:
     } );
 
     prepare_outputs();
+
+    st.num_qubits = qnet.num_qubits();
+    st.depth = qubit_level.empty() ? 0u : *std::max_element( qubit_level.begin(), qubit_level.end() );
     return true;
   }
 
@@ -234,7 +296,7 @@ private:
     node_to_qubit[n].push( qnet.num_qubits() );
     qnet.add_qubit();
     if ( v )
-      qnet.add_gate( tweedledum::gate::pauli_x, node_to_qubit[n].top() );
+      add_gate( tweedledum::gate::pauli_x, node_to_qubit[n].top() );
   }
 
   uint32_t request_ancilla()
@@ -246,12 +308,65 @@ private:
       qnet.add_qubit();
       return r;
     }
-    else
+
+    auto it = free_ancillae.end() - 1;
+    switch ( ps.ancillae )
     {
-      const auto r = free_ancillae.top();
-      free_ancillae.pop();
-      return r;
+    case ancilla_allocation::lifo:
+      break;
+    case ancilla_allocation::fifo:
+      it = free_ancillae.begin();
+      break;
+    case ancilla_allocation::depth_aware:
+      /* ties are broken in favor of the least recently released ancilla */
+      it = std::min_element( free_ancillae.begin(), free_ancillae.end(), [&]( auto a, auto b ) {
+        return level_of( a ) < level_of( b );
+      } );
+      break;
     }
+    const auto r = *it;
+    free_ancillae.erase( it );
+    return r;
+  }
+
+  uint32_t level_of( uint32_t q ) const
+  {
+    return q < qubit_level.size() ? qubit_level[q] : 0u;
+  }
+
+  /* adds a gate to qnet and keeps track of the depth of all qubits it acts on */
+  template<typename... Qubits>
+  void add_gate( tweedledum::gate_base const& op, Qubits const&... qubits )
+  {
+    qnet.add_gate( op, qubits... );
+
+    uint32_t level{0u};
+    ( foreach_qubit( qubits, [&]( uint32_t q ) { level = std::max( level, level_of( q ) ); } ), ... );
+    ++level;
+    ( foreach_qubit( qubits, [&]( uint32_t q ) {
+        if ( q >= qubit_level.size() )
+          qubit_level.resize( q + 1, 0u );
+        qubit_level[q] = level;
+      } ), ... );
+  }
+
+  template<typename Fn>
+  static void foreach_qubit( SetQubits const& qubits, Fn&& fn )
+  {
+    for ( auto const& q : qubits )
+      fn( q.index() );
+  }
+
+  template<typename Fn>
+  static void foreach_qubit( Qubit const& q, Fn&& fn )
+  {
+    fn( q.index() );
+  }
+
+  template<typename Fn>
+  static void foreach_qubit( uint32_t q, Fn&& fn )
+  {
+    fn( q );
   }
 
   void prepare_outputs()
@@ -264,10 +379,10 @@ private:
       {
         auto new_i = request_ancilla();
 
-        qnet.add_gate( tweedledum::gate::cx, node_to_qubit[ntk.node_to_index( node )].top(), new_i );
+        add_gate( tweedledum::gate::cx, node_to_qubit[ntk.node_to_index( node )].top(), new_i );
         if ( ntk.is_complemented( s ) != ntk.is_complemented( node_to_signals[node] ) )
         {
-          qnet.add_gate( tweedledum::gate::pauli_x, new_i );
+          add_gate( tweedledum::gate::pauli_x, new_i );
         }
         st.o_indexes.push_back( new_i );
       }
@@ -275,7 +390,7 @@ private:
       {
         if ( ntk.is_complemented( s ) )
         {
-          qnet.add_gate( tweedledum::gate::pauli_x, node_to_qubit[ntk.node_to_index( node )].top() );
+          add_gate( tweedledum::gate::pauli_x, node_to_qubit[ntk.node_to_index( node )].top() );
         }
         node_to_signals[node] = s;
         st.o_indexes.push_back( node_to_qubit[ntk.node_to_index( node )].top() );
@@ -285,7 +400,7 @@ private:
 
   void release_ancilla( uint32_t q )
   {
-    free_ancillae.push( q );
+    free_ancillae.push_back( q );
   }
 
   template<int Fanin>
@@ -315,7 +430,7 @@ private:
       auto c =  node_to_qubit[control].top();
       if (c != t)
       {     
-        qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c ), tweedledum::qubit_id( t ) );
+        add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c ), tweedledum::qubit_id( t ) );
       }
     }
   }
@@ -527,59 +642,59 @@ private:
 
   void compute_and( SetQubits controls, uint32_t t )
   {
-    qnet.add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
+    add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
   }
 
   void compute_or( SetQubits controls, uint32_t t )
   {
-    qnet.add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
-    qnet.add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
+    add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
   }
 
   void compute_xor( uint32_t c1, uint32_t c2, bool inv, uint32_t t)
   {
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), tweedledum::qubit_id( t ) );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( t ) );
     if ( inv )
-      qnet.add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
+      add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
   }
 
   void compute_xor3( uint32_t c1, uint32_t c2, uint32_t c3, bool inv, uint32_t t )
   {
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), tweedledum::qubit_id( t ) );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( t ) );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( t ) );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), tweedledum::qubit_id( t ) );
     if ( inv )
-      qnet.add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
+      add_gate( tweedledum::gate::pauli_x, tweedledum::qubit_id( t ) );
   }
 
   void compute_maj( uint32_t c1, uint32_t c2, uint32_t c3, bool p1, bool p2, bool p3, uint32_t t )
   {
     if ( p1 )
-      qnet.add_gate( tweedledum::gate::pauli_x, c1 );
+      add_gate( tweedledum::gate::pauli_x, c1 );
     if ( !p2 ) /* control 2 behaves opposite */
-      qnet.add_gate( tweedledum::gate::pauli_x, c2 );
+      add_gate( tweedledum::gate::pauli_x, c2 );
     if ( p3 )
-      qnet.add_gate( tweedledum::gate::pauli_x, c3 );
+      add_gate( tweedledum::gate::pauli_x, c3 );
 
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c1 );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), t );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c1 );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), t );
 
     SetQubits controls;
     controls.push_back( tweedledum::qubit_id( c1 ) );
     controls.push_back( tweedledum::qubit_id( c2 ) );
-    qnet.add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
+    add_gate( tweedledum::gate::mcx, controls, SetQubits{{t}} );
 
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c1 );
-    qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c1 );
+    add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
 
     if ( p3 )
-      qnet.add_gate( tweedledum::gate::pauli_x, c3 );
+      add_gate( tweedledum::gate::pauli_x, c3 );
     if ( !p2 )
-      qnet.add_gate( tweedledum::gate::pauli_x, c2 );
+      add_gate( tweedledum::gate::pauli_x, c2 );
     if ( p1 )
-      qnet.add_gate( tweedledum::gate::pauli_x, c1 );
+      add_gate( tweedledum::gate::pauli_x, c1 );
   }
 
   void compute_xor_block( SetQubits const& controls, Qubit t )
@@ -587,7 +702,7 @@ private:
     for ( auto c : controls )
     {
       if ( c != t )
-        qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c ), t );
+        add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c ), t );
     }
   }
 
@@ -604,47 +719,47 @@ private:
 
     if ( c1 == t && c2 != t)
     {
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), c1 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), c1 );
     }
     else if ( c2 == t && c1 !=t)
     {
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
     }
     else if (c1 != t && c2!= t && c1 != c2)
     {
       //std::cerr << "[e] target does not match any control in in-place\n";
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), t );
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), t );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), t );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), t );
     }
     if ( inv )
-      qnet.add_gate( tweedledum::gate::pauli_x, t );
+      add_gate( tweedledum::gate::pauli_x, t );
   }
 
   void compute_xor3_inplace( uint32_t c1, uint32_t c2, uint32_t c3, bool inv, uint32_t t )
   {
     if ( c1 == t )
     {
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( c1 ) );
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), tweedledum::qubit_id( c1 ) );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), tweedledum::qubit_id( c1 ) );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), tweedledum::qubit_id( c1 ) );
     }
     else if ( c2 == t )
     {
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c2 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c2 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c3 ), c2 );
     }
     else if ( c3 == t )
     {
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c3 );
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), c3 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), c3 );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), c3 );
     }
     else
     {
       //std::cerr << "[e] target does not match any control in in-place\n";
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), t );
-      qnet.add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), t );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c1 ), t );
+      add_gate( tweedledum::gate::cx, tweedledum::qubit_id( c2 ), t );
     }
     if ( inv )
-      qnet.add_gate( tweedledum::gate::pauli_x, t );
+      add_gate( tweedledum::gate::pauli_x, t );
   }
 
   /*  
@@ -707,7 +822,7 @@ private:
         
         for (auto c : cone.copies)
         {
-          qnet.add_gate(tweedledum::gate::cx, tweedledum::qubit_id( node_to_qubit[c].top() ), tcp );
+          add_gate(tweedledum::gate::cx, tweedledum::qubit_id( node_to_qubit[c].top() ), tcp );
         }
         release_ancilla(tcp);
       }
@@ -859,7 +974,9 @@ private:
   logic_network_synthesis_params const& ps;
   logic_network_synthesis_stats& st;
   std::unordered_map<uint32_t, std::stack<uint32_t>> node_to_qubit;
-  std::stack<uint32_t> free_ancillae;
+  std::deque<uint32_t> free_ancillae;
+  /* depth of each qubit after the last gate acting on it */
+  std::vector<uint32_t> qubit_level;
   /* stores for each root of the cone a queue of qubits where its copies are and its previous location */
   std::unordered_map<uint32_t, std::queue<uint32_t>> copies;
 }; // namespace detail
@@ -875,6 +992,15 @@ private:
  * computed out-of-place or in-place is determined by a separate mapper
  * component `MappingStrategy` that is passed as template parameter to the
  * function.
+ *
+ * Unless `verify` is disabled, the resulting circuit is checked against the
+ * logic network with `check_circuit_simulation`, and the function returns
+ * false if they do not match.  Circuits with non-classical gates are not
+ * checked.
+ *
+ * `QuantumNetwork` may also be a `circuit_sink`, such as `qasm_sink`, which
+ * emits the gates while they are synthesized instead of storing them.
+ * Such circuits are not checked.
  */
 template<class QuantumNetwork, class LogicNetwork,
          class SingleTargetGateSynthesisFn = tweedledum::stg_from_pprm>
@@ -892,7 +1018,26 @@ bool logic_network_synthesis( QuantumNetwork& qnet, LogicNetwork const& ntk,
                                                                                                         strategy,
                                                                                                         stg_fn,
                                                                                                         ps, st );
-  const auto result = impl.run();
+  auto result = impl.run();
+
+  if constexpr ( mt::has_compute_v<LogicNetwork, kitty::partial_truth_table> && detail::has_foreach_cgate<QuantumNetwork>::value )
+  {
+    if ( result && ps.verify )
+    {
+      mockturtle::stopwatch t( st.time_verification );
+      st.verified = check_circuit_simulation( qnet, ntk, st.i_indexes, st.o_indexes, ps.verification );
+      if ( !st.verified )
+      {
+        std::cout << "[w] synthesized circuit contains non-classical gates, verification skipped\n";
+      }
+      else if ( !*st.verified )
+      {
+        std::cout << "[e] synthesized circuit does not match the logic network\n";
+        result = false;
+      }
+    }
+  }
+
   if ( ps.verbose )
   {
     st.report();
@@ -0,0 +1,148 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#if defined( BILL_HAS_Z3 )
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+#include <tweedledum/networks/netlist.hpp>
+
+#include "../details/utils.hpp"
+#include "../solvers/solver_manager.hpp"
+#include "../solvers/z3_inplace_solver.hpp"
+#include "../structures/pebbling_view.hpp"
+#include "../structures/stg_gate.hpp"
+#include "lhrs.hpp"
+#include "strategies/pebbling_mapping_strategy.hpp"
+
+namespace caterpillar
+{
+
+struct parallel_compilation_params
+{
+  /*! \brief Parameters for the pebbling strategy of every variant. */
+  pebbling_mapping_strategy_params pebbling;
+
+  /*! \brief Parameters for logic network synthesis of every variant. */
+  logic_network_synthesis_params synthesis;
+
+  /*! \brief Number of worker threads (0 means hardware concurrency). */
+  uint32_t num_threads{0u};
+};
+
+/*! \brief Compilation result of one network variant. */
+struct compilation_report
+{
+  /*! \brief Whether a pebbling strategy was found. */
+  bool success{false};
+
+  /*! \brief Number of qubits. */
+  uint32_t qubits{0u};
+
+  /*! \brief Number of T gates (Toffoli gates on clean helper lines count 4). */
+  uint32_t t_count{0u};
+
+  /*! \brief T-depth. */
+  uint32_t t_depth{0u};
+
+  /*! \brief Number of CNOT gates. */
+  uint32_t cnots{0u};
+
+  /*! \brief Runtime for pebbling and synthesis. */
+  mockturtle::stopwatch<>::duration time_total{0};
+
+  void report( std::string const& name = {} ) const
+  {
+    std::cout << fmt::format( "[i] {:<10} qubits = {:>5}  T-count = {:>6}  T-depth = {:>5}  CNOTs = {:>6}  time = {:>5.2f} secs{}\n",
+                              name, qubits, t_count, t_depth, cnots, mockturtle::to_seconds( time_total ), success ? "" : "  (failed)" );
+  }
+};
+
+/*! \brief Compiles several network variants into quantum circuits concurrently.
+ *
+ * Each variant is wrapped into a `pebbling_view`, mapped with a
+ * `pebbling_mapping_strategy` using `Solver`, and synthesized with
+ * `logic_network_synthesis`.  The variants are distributed over a pool of
+ * worker threads; every variant gets its own solver and thus its own Z3
+ * context.  The resulting circuits are stored in `circuits`, if given, in the
+ * same order as `variants`.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      std::vector<tweedledum::netlist<stg_gate>> circuits;
+      const auto reports = compile_variants( std::vector<xag_network>{xag1, xag2}, {}, &circuits );
+      for ( auto i = 0u; i < circuits.size(); ++i )
+        tweedledum::writeqasm( circuits[i], fmt::format( "variant{}.qasm", i ) );
+   \endverbatim
+ */
+template<class Ntk = mockturtle::xag_network, class Solver = z3_pebble_inplace_solver<pebbling_view<Ntk>>>
+std::vector<compilation_report> compile_variants( std::vector<Ntk> const& variants,
+                                                  parallel_compilation_params const& ps = {},
+                                                  std::vector<tweedledum::netlist<stg_gate>>* circuits = nullptr )
+{
+  using network_t = pebbling_view<Ntk>;
+
+  std::vector<compilation_report> reports( variants.size() );
+  std::vector<tweedledum::netlist<stg_gate>> qnets( variants.size() );
+
+  std::atomic<uint32_t> next{0u};
+  const auto worker = [&]() {
+    for ( auto i = next++; i < variants.size(); i = next++ )
+    {
+      auto& rep = reports[i];
+      mockturtle::stopwatch<> t( rep.time_total );
+
+      network_t pntk{variants[i]};
+      pebbling_mapping_strategy<network_t, Solver> strategy( ps.pebbling );
+      rep.success = logic_network_synthesis( qnets[i], pntk, strategy, {}, ps.synthesis );
+      if ( !rep.success )
+        continue;
+
+      const auto [cnots, t_count, t_depth] = detail::qc_stats( qnets[i] );
+      rep.qubits = qnets[i].num_qubits();
+      rep.t_count = t_count;
+      rep.t_depth = t_depth;
+      rep.cnots = cnots;
+    }
+  };
+
+  const auto num_threads = std::max<uint32_t>( 1u, std::min<uint32_t>( ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency(),
+                                                                        static_cast<uint32_t>( variants.size() ) ) );
+  std::vector<std::thread> threads;
+  for ( auto i = 1u; i < num_threads; ++i )
+  {
+    threads.emplace_back( worker );
+  }
+  worker();
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  if ( circuits )
+  {
+    *circuits = std::move( qnets );
+  }
+  return reports;
+}
+
+} // namespace caterpillar
+
+#endif
@@ -20,7 +20,11 @@
 #include <tweedledum/networks/netlist.hpp>
 #include <caterpillar/details/depth_costs.hpp>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <iterator>
+#include <limits>
+#include <utility>
 #include <fmt/format.h>
 using namespace std::chrono;
 
@@ -36,42 +40,35 @@ using SolverType = z3_pebble_solver<abstract_network>;
 #endif
 
 
-inline std::vector<uint32_t> sym_diff(std::vector<uint32_t> first, std::vector<uint32_t> second)
+inline std::vector<uint32_t> sym_diff(std::vector<uint32_t> const& first, std::vector<uint32_t> const& second)
 {
   std::vector<uint32_t> diff;
   /* this one works on sorted ranges */
-  for(int i = 0; i< (int)(first.size()) - 1; i++)
-    assert(first[i] < first[i+1]);
-  
-  for(int i = 0; i< (int)(second.size() - 1); i++)
-    assert(second[i] < second[i+1]);
-  
+  assert( std::is_sorted( first.begin(), first.end() ) );
+  assert( std::is_sorted( second.begin(), second.end() ) );
+
+  diff.reserve( first.size() + second.size() );
   std::set_symmetric_difference( first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(diff) );
   return diff;
 }
 
-inline bool is_included(std::vector<uint32_t> first, std::vector<uint32_t> second)
+inline bool is_included(std::vector<uint32_t> const& first, std::vector<uint32_t> const& second)
 {
-  /* if second is included in first */
-  bool is_included = true;
-  for(auto l : first)
-  {
-    if (std::find( second.begin(), second.end(), l) == second.end())
-    {
-      is_included = false;
-      break;
-    }
-  }
-  return is_included;
+  /* if first is included in second (both sorted) */
+  return std::includes( second.begin(), second.end(), first.begin(), first.end() );
 }
 
 
 inline void update_fi( node_t node, xag_network const& xag, std::vector<std::vector<uint32_t>>& fi, std::vector<node_t> const& drivers )
 {
+  if ( xag.is_constant( node ) )
+  {
+    return;
+  }
 
   if ( xag.is_and( node ) || xag.is_pi(node) || (std::find(drivers.begin(), drivers.end(), node) != drivers.end()))
   {
-    fi[ xag.node_to_index(node) ] = { xag.node_to_index(node) };
+    fi[ xag.node_to_index(node) ] = { static_cast<uint32_t>( xag.node_to_index(node) ) };
   }
 
   else
@@ -95,14 +92,142 @@ static inline  std::vector<std::vector<uint32_t>> get_fi (xag_network const& xag
   return fi;
 }
 
-inline  std::vector<cone_t> get_cones( node_t node, xag_network const& xag, std::vector<std::vector<uint32_t>> const& fi, bool include_root = true )
+/*! \brief Linear fanin cones of an XAG, computed on demand.
+ *
+ * The linear fanin of a node is the sorted set of AND nodes, primary inputs
+ * and output drivers (the leaves) whose XOR is the node's function.  In
+ * contrast to `get_fi`, which stores the linear fanin of every node, sets are
+ * only computed for the fanins of the cones that are actually requested, and
+ * every set is released as soon as all its fanouts have read it.  Hence only
+ * the sets on the frontier between processed and unprocessed nodes are kept
+ * in memory.
+ */
+class xag_linear_fanins
+{
+public:
+  xag_linear_fanins( xag_network const& xag, std::vector<node_t> const& drivers )
+      : _xag( xag ),
+        _drivers( xag.size() ),
+        _sets( xag.size() ),
+        _computed( xag.size(), false ),
+        _refs( xag.size(), 0u )
+  {
+    for ( auto const& d : drivers )
+    {
+      _drivers[xag.node_to_index( d )] = true;
+    }
+
+    /* every gate reads the linear fanin of each of its fanins exactly once */
+    xag.foreach_gate( [&]( auto const& n ) {
+      xag.foreach_fanin( n, [&]( auto const& f ) {
+        ++_refs[xag.node_to_index( xag.get_node( f ) )];
+      } );
+    } );
+  }
+
+  bool is_driver( node_t n ) const
+  {
+    return _drivers[_xag.node_to_index( n )];
+  }
+
+  /*! \brief Whether the node is a leaf of linear cones (AND, PI, or output driver). */
+  bool is_leaf( node_t n ) const
+  {
+    return _xag.is_and( n ) || _xag.is_pi( n ) || is_driver( n );
+  }
+
+  /*! \brief Returns the linear fanin of `n`, computing it if needed. */
+  std::vector<uint32_t> const& operator[]( node_t n )
+  {
+    if ( is_computed( n ) )
+    {
+      return _sets[_xag.node_to_index( n )];
+    }
+
+    /* iterative post-order traversal, XOR chains can be very long */
+    std::vector<node_t> stack{ n };
+    while ( !stack.empty() )
+    {
+      const auto m = stack.back();
+      auto& set = _sets[_xag.node_to_index( m )];
+      if ( is_computed( m ) )
+      {
+        stack.pop_back();
+        continue;
+      }
+
+      if ( is_leaf( m ) )
+      {
+        set = { static_cast<uint32_t>( _xag.node_to_index( m ) ) };
+        _computed[_xag.node_to_index( m )] = true;
+        stack.pop_back();
+        continue;
+      }
+
+      std::array<node_t, 2> children;
+      auto i = 0u;
+      bool ready = true;
+      _xag.foreach_fanin( m, [&]( auto const& f ) {
+        children[i++] = _xag.get_node( f );
+        if ( !is_computed( children[i - 1] ) )
+        {
+          stack.push_back( children[i - 1] );
+          ready = false;
+        }
+      } );
+      if ( !ready )
+      {
+        continue;
+      }
+
+      /* the set is empty if both fanins have the same linear fanin */
+      set = sym_diff( _sets[_xag.node_to_index( children[0] )], _sets[_xag.node_to_index( children[1] )] );
+      _computed[_xag.node_to_index( m )] = true;
+      stack.pop_back();
+      release( children[0] );
+      release( children[1] );
+    }
+
+    return _sets[_xag.node_to_index( n )];
+  }
+
+  /*! \brief Signals that one fanout of `n` does not need its linear fanin anymore. */
+  void release( node_t n )
+  {
+    auto& refs = _refs[_xag.node_to_index( n )];
+    if ( refs != 0u && --refs == 0u )
+    {
+      std::vector<uint32_t>().swap( _sets[_xag.node_to_index( n )] );
+      _computed[_xag.node_to_index( n )] = false;
+    }
+  }
+
+private:
+  /* an empty set does not mean that the set was not computed */
+  bool is_computed( node_t n ) const
+  {
+    return _computed[_xag.node_to_index( n )] || _xag.is_constant( n );
+  }
+
+  xag_network const& _xag;
+  std::vector<bool> _drivers;
+  std::vector<std::vector<uint32_t>> _sets;
+  std::vector<bool> _computed;
+  std::vector<uint32_t> _refs;
+};
+
+namespace detail
+{
+
+template<class FaninFn>
+inline std::vector<cone_t> get_cones( node_t node, xag_network const& xag, FaninFn&& fanin_cone, bool include_root )
 {
   std::vector<cone_t> cones; 
 
   xag.foreach_fanin( node, [&]( auto si ) {
     auto fanin = xag.get_node( si );
 
-    auto set = cone_t(fanin, fi[xag.node_to_index( fanin )], xag.is_complemented(si) ) ; 
+    auto set = cone_t(fanin, fanin_cone( fanin ), xag.is_complemented(si) ) ; 
     cones.push_back( set ); 
   } );
   assert( cones.size() == 2 );
@@ -127,39 +252,83 @@ inline  std::vector<cone_t> get_cones( node_t node, xag_network const& xag, std:
   }
   else 
   {
-    if ( is_included(fi[xag.node_to_index(cones[1].root)], fi[xag.node_to_index(cones[0].root)]) )
+    if ( is_included(cones[1].leaves, cones[0].leaves) )
     { 
       std::reverse(cones.begin(), cones.end());
     }
 
-    auto left = xag.node_to_index(cones[0].root);
-    auto right = xag.node_to_index(cones[1].root);
-
+    auto const& left = cones[0].leaves;
+    auto const& right = cones[1].leaves;
 
     /* search a target for first */
     /* empty if left is included TODO: remove this */
-    std::set_difference(fi[left].begin(), fi[left].end(), 
-      fi[right].begin(), fi[right].end(), std::inserter(cones[0].target, cones[0].target.begin()));
+    std::set_difference(left.begin(), left.end(), 
+      right.begin(), right.end(), std::back_inserter(cones[0].target));
 
     /* set difference */
-    std::set_difference(fi[right].begin(), fi[right].end(), 
-      fi[left].begin(), fi[left].end(), std::inserter(cones[1].target, cones[1].target.begin()));
+    std::set_difference(right.begin(), right.end(), 
+      left.begin(), left.end(), std::back_inserter(cones[1].target));
     
     /* the first may be included */
-    if( include_root && is_included(fi[left], fi[right] ) )
+    if( include_root && is_included(left, right) )
     {
       /* add the top of the cone to the right */
       cones[1].target.push_back( cones[0].root ); 
       cones[1].leaves = cones[1].target;
 
       /* anything can be chosen as target */ 
-      cones[0].target = fi[left];
+      cones[0].target = cones[0].leaves;
     }
   }
 
   return cones;
 }
 
+/* AND-level of every node, where AND nodes and output drivers cost one level */
+inline std::pair<std::vector<uint32_t>, uint32_t> get_and_levels( xag_network const& xag, xag_linear_fanins const& fi )
+{
+  std::vector<uint32_t> level( xag.size(), 0u );
+  xag.foreach_gate( [&]( auto n ) {
+    uint32_t l{0u};
+    xag.foreach_fanin( n, [&]( auto const& f ) {
+      l = std::max( l, level[xag.node_to_index( xag.get_node( f ) )] );
+    } );
+    level[xag.node_to_index( n )] = ( xag.is_and( n ) || fi.is_driver( n ) ) ? l + 1u : l;
+  } );
+
+  uint32_t depth{0u};
+  xag.foreach_po( [&]( auto const& f ) {
+    depth = std::max( depth, level[xag.node_to_index( xag.get_node( f ) )] );
+  } );
+  return {level, depth};
+}
+
+/* prepends compute steps followed by the uncompute blocks in reverse order to `steps` */
+inline void merge_steps( steps_xag_t& steps, steps_xag_t&& compute, std::vector<steps_xag_t>&& uncompute )
+{
+  for ( auto it = uncompute.rbegin(); it != uncompute.rend(); ++it )
+  {
+    compute.insert( compute.end(), std::make_move_iterator( it->begin() ), std::make_move_iterator( it->end() ) );
+  }
+  steps.insert( steps.begin(), std::make_move_iterator( compute.begin() ), std::make_move_iterator( compute.end() ) );
+}
+
+} // namespace detail
+
+inline  std::vector<cone_t> get_cones( node_t node, xag_network const& xag, std::vector<std::vector<uint32_t>> const& fi, bool include_root = true )
+{
+  return detail::get_cones( node, xag, [&]( node_t n ) -> std::vector<uint32_t> const& { return fi[xag.node_to_index( n )]; }, include_root );
+}
+
+inline  std::vector<cone_t> get_cones( node_t node, xag_network const& xag, xag_linear_fanins& fi, bool include_root = true )
+{
+  auto cones = detail::get_cones( node, xag, [&]( node_t n ) -> std::vector<uint32_t> const& { return fi[n]; }, include_root );
+  xag.foreach_fanin( node, [&]( auto const& f ) {
+    fi.release( xag.get_node( f ) );
+  } );
+  return cones;
+}
+
 static inline steps_xag_t gen_steps( node_t node, std::vector<cone_t> cones, bool compute)
 {
   steps_xag_t comp_steps;
@@ -217,90 +386,67 @@ static inline steps_xag_t gen_steps( node_t node, std::vector<cone_t> cones, boo
 }
 
 
-static inline std::vector<std::vector<node_t>> get_levels_asap( xag_network const& xag_t, std::vector<node_t> const& drivers)
+static inline std::vector<std::vector<node_t>> get_levels_asap( xag_network const& xag, xag_linear_fanins const& fi )
 {
-  mockturtle::depth_view<xag_network, xag_depth_cost<xag_network>> xag {xag_t};
+  const auto [level, depth] = detail::get_and_levels( xag, fi );
 
-  std::vector<std::vector<node_t>>levels (xag.depth());
+  std::vector<std::vector<node_t>>levels (depth);
                                                                  
   xag.foreach_gate( [&]( auto n ) {
-    if( xag.is_and(n) || std::find( drivers.begin(), drivers.end(), n ) != drivers.end() ) 
-      levels[xag.level(n)-1].push_back(n);
+    if( xag.is_and(n) || fi.is_driver( n ) ) 
+      levels[level[xag.node_to_index( n )]-1].push_back(n);
   });
 
   return levels;
 }
 
+static inline std::vector<std::vector<node_t>> get_levels_asap( xag_network const& xag, std::vector<node_t> const& drivers)
+{
+  return get_levels_asap( xag, xag_linear_fanins( xag, drivers ) );
+}
+
 /* get nodes per level (ALAP) */
-static inline std::vector<std::vector<node_t>> get_levels_alap( xag_network const& xag_t, std::vector<node_t> const& drivers)
+static inline std::vector<std::vector<node_t>> get_levels_alap( xag_network const& xag, xag_linear_fanins const& fi )
 {
   /* AND nodes per level */
-  mockturtle::depth_view<xag_network, xag_depth_cost<xag_network>> xag {xag_t};
-
-  std::vector<std::vector<node_t>>levels (xag.depth());
-
-  /* compute AND inputs of each nodes */
-  std::vector<std::vector<node_t>> fanin_set (xag.size());
+  const auto depth = detail::get_and_levels( xag, fi ).second;
 
-  xag.foreach_gate( [&]( auto n ) {
-    if(xag.is_and(n) || (std::find(drivers.begin(), drivers.end(), n) != drivers.end()) )
-    {
-      fanin_set[n] = {n};
-    }
-    else 
-    {
-      std::vector<uint32_t> fanin;
-      xag.foreach_fanin(n, [&]( auto si ) {
-        fanin.push_back(xag.get_node(si));
-      });
-      
-      std::copy(fanin_set[fanin[1]].begin(),fanin_set[fanin[1]].end(), std::back_inserter(fanin_set[n]));
-
-      std::remove_copy_if( fanin_set[fanin[0]].begin(),fanin_set[fanin[0]].end(), std::back_inserter(fanin_set[n]), [&](auto i) 
-      {
-        return std::find(fanin_set[fanin[1]].begin(), fanin_set[fanin[1]].end(), i) != fanin_set[fanin[1]].end();
-      });
-
-    }
-  });
-
-  /* compute parents of and nodes */
-  mockturtle::node_map<std::vector<uint32_t>, xag_network> parents( xag );
-  xag.foreach_gate( [&]( auto const& n ) {
-    if ( !( xag.is_and( n ) || (std::find(drivers.begin(), drivers.end(), n) != drivers.end()) ) ) return;
-
-    xag.foreach_fanin( n, [&]( auto const& f ) {
-      const auto child = xag.get_node( f );
-      for(auto l : fanin_set[child])
-      {
-        parents[l].push_back(n);
-      }
-    });
-  } );
+  std::vector<std::vector<node_t>>levels (depth);
 
-  /* reverse TOPO */
-  mockturtle::node_map<uint32_t, xag_network> level( xag );
+  /* reverse TOPO: the level of an AND node is one below the lowest AND node
+     that is reachable through XOR nodes, `required` propagates this bound
+     through the linear fanin cones */
+  std::vector<uint32_t> required( xag.size(), std::numeric_limits<uint32_t>::max() );
   for ( auto n = xag.size() - 1u; n > xag.num_pis(); --n )
   {
-    if ( !( xag.is_and( n ) || (std::find(drivers.begin(), drivers.end(), n) != drivers.end()) ) ) continue;
-    
-    if ( parents[n].empty() )
+    if ( xag.is_dead( n ) ) continue;
+
+    if ( xag.is_and( n ) || fi.is_driver( n ) )
     {
-      const auto l = xag.depth() - 1u;
+      const auto l = ( required[n] == std::numeric_limits<uint32_t>::max() ? depth : required[n] ) - 1u;
       levels[l].push_back( n );
-      level[n] = l;
+      xag.foreach_fanin( n, [&]( auto const& f ) {
+        auto& r = required[xag.get_node( f )];
+        r = std::min( r, l );
+      } );
     }
     else
     {
-      const auto l = level[*std::min_element( parents[n].begin(), parents[n].end(), [&]( auto n1, auto n2 ) { return level[n1] < level[n2]; } )] - 1u;
-      levels[l].push_back( n );
-      level[n] = l;
+      xag.foreach_fanin( n, [&]( auto const& f ) {
+        auto& r = required[xag.get_node( f )];
+        r = std::min( r, required[n] );
+      } );
     }
   }
 
   return levels;
 }
 
+static inline std::vector<std::vector<node_t>> get_levels_alap( xag_network const& xag, std::vector<node_t> const& drivers)
+{
+  return get_levels_alap( xag, xag_linear_fanins( xag, drivers ) );
+}
+
 /*!
   \verbatim embed:rst
     This strategy is dedicated to XAG graphs and fault tolerant quantum computing.
@@ -321,12 +467,15 @@ public:
     mockturtle::topo_view xag {ntk};
 
     auto drivers = detail::get_outputs(xag);                                                     
-    auto fi  = get_fi(xag, drivers);
-    auto it = steps().begin();
+    xag_linear_fanins fi( xag, drivers );
+
+    /* uncompute steps are collected in blocks and appended in reverse order */
+    steps_xag_t comp_steps;
+    std::vector<steps_xag_t> uncomp_steps;
 
     xag.foreach_gate( [&]( auto node ) {
       
-      if ( xag.is_and( node ) || std::find( drivers.begin(), drivers.end(), node ) != drivers.end() )
+      if ( xag.is_and( node ) || fi.is_driver( node ) )
       {
         auto cones = get_cones(  node, xag, fi );
 
@@ -334,26 +483,25 @@ public:
         {
           /* compute step */
           auto cc = gen_steps( node , cones,  true);
-          it = steps().insert( it, cc.begin(), cc.end() );
-          it = it + cc.size();
+          comp_steps.insert( comp_steps.end(), cc.begin(), cc.end() );
 
-          if ( std::find( drivers.begin(), drivers.end(), node ) == drivers.end()  )
+          if ( !fi.is_driver( node ) )
           { 
-            auto uc = gen_steps( node , cones, false);
-            it = steps().insert( it, uc.begin(), uc.end() );
+            uncomp_steps.push_back( gen_steps( node , cones, false) );
           }
         }
         /* node is an XOR output */
         else 
         {
           auto xc = gen_steps( node, cones, true);
-          it = steps().insert( it, xc.begin(), xc.end() );
-          it = it + xc.size();
+          comp_steps.insert( comp_steps.end(), xc.begin(), xc.end() );
         }
       }
 
     } );
 
+    detail::merge_steps( steps(), std::move( comp_steps ), std::move( uncomp_steps ) );
+
     return true;
   }
 };
@@ -367,11 +515,13 @@ public:
     mockturtle::topo_view xag {ntk};
 
     auto drivers = detail::get_outputs(xag);                                                     
-    auto fi  = get_fi(xag, drivers);
-    auto levels = get_levels_asap(xag, drivers);
-    auto it = steps().begin();
+    xag_linear_fanins fi( xag, drivers );
+    auto levels = get_levels_asap(xag, fi);
+
+    steps_xag_t comp_steps;
+    std::vector<steps_xag_t> uncomp_steps;
 
-    for(auto lvl : levels)
+    for(auto const& lvl : levels)
     { 
       /* store two action sets for each node in the level */
       std::vector<std::pair<uint32_t, std::vector<cone_t>>> node_and_action;      
@@ -381,20 +531,21 @@ public:
       {
         /* this strategy does not support symplification of an included fanin cone, hence the false flag */
         auto cones = get_cones(n, xag, fi, false);
-        node_and_action.push_back({n, cones});
+        node_and_action.push_back({n, std::move( cones )});
       }
 
-      it = steps().insert(it, {lvl[0], compute_level_action{node_and_action}});
-      it = it + 1;
-      
-      for(auto node : node_and_action)
+      for(auto const& node : node_and_action)
       {
-        if(std::find(drivers.begin(), drivers.end(), node.first) == drivers.end())
+        if(!fi.is_driver(node.first))
         to_be_uncomputed.push_back(node);
       }
-      it = steps().insert(it, {lvl[0], uncompute_level_action{to_be_uncomputed}});
+
+      comp_steps.push_back({lvl[0], compute_level_action{std::move( node_and_action )}});
+      uncomp_steps.push_back({{lvl[0], uncompute_level_action{std::move( to_be_uncomputed )}}});
     }
 
+    detail::merge_steps( steps(), std::move( comp_steps ), std::move( uncomp_steps ) );
+
     return true;
   }
 };
@@ -441,21 +592,21 @@ class xag_pebbling_mapping_strategy : public mapping_strategy<xag_network>
     });
 
     auto drivers = detail::get_outputs(xag);
-    auto fi = get_fi (xag, drivers);
+    xag_linear_fanins fi( xag, drivers );
+
+    easy::utils::dynamic_bitset<> visited;
+    visited.resize(xag.size());
 
     xag.foreach_gate([&] (auto node)
     {
-      if(xag.is_and(node) || std::find(drivers.begin(), drivers.end(), node) != drivers.end())
+      if(xag.is_and(node) || fi.is_driver(node))
       {
         /* collect all the input signals of the box */
         std::vector<abstract_network::signal> box_ins;
 
-        easy::utils::dynamic_bitset<> visited;
-        visited.resize(xag.size());
-
         auto cones = get_cones(  node, xag, fi );
         auto tot_leaves = cones[0].leaves.size() + cones[1].leaves.size();
-        for( auto c : cones)
+        for( auto const& c : cones)
         {
           for (auto l : c.leaves)
           {
@@ -464,6 +615,13 @@ class xag_pebbling_mapping_strategy : public mapping_strategy<xag_network>
             visited.set_bit(l);
           }
         }
+        for( auto const& c : cones)
+        {
+          for (auto l : c.leaves)
+          {
+            visited.reset_bit(l);
+          }
+        }
         
         
         auto box_node_s = use_w ? box_ntk.create_node(box_ins, (int)tot_leaves) : box_ntk.create_node(box_ins);
@@ -474,7 +632,7 @@ class xag_pebbling_mapping_strategy : public mapping_strategy<xag_network>
         box_to_action[box_node] = {node, cones};
        
         
-        if(std::find(drivers.begin(), drivers.end(), node) != drivers.end())
+        if(fi.is_driver(node))
         {
           box_ntk.create_po(box_node_s);
         }
@@ -541,7 +699,7 @@ class xag_low_depth_mapping_strategy : public mapping_strategy<xag_network>
         }
       }
     }
-    for(auto cone : cones)
+    for(auto const& cone : cones)
     {
       for(auto l : cone.leaves )
       {
@@ -564,23 +722,25 @@ public:
 
     auto drivers = detail::get_outputs(xag);
 
-    /* iterate the xag to extract transitive fanin cones for all nodes */
-    auto fi = get_fi(xag, drivers);
+    /* transitive linear fanin cones are extracted on demand */
+    xag_linear_fanins fi( xag, drivers );
 
     /* each m_level is filled with AND nodes and XOR outputs */
-    auto levels = _alap ? get_levels_alap(xag, drivers) : get_levels_asap(xag, drivers);
-    auto it = steps().begin();
+    auto levels = _alap ? get_levels_alap(xag, fi) : get_levels_asap(xag, fi);
+
+    steps_xag_t comp_steps;
+    std::vector<steps_xag_t> uncomp_steps;
 
-    for(auto lvl : levels){ if(lvl.size() != 0)
+    easy::utils::dynamic_bitset<> visited;
+    visited.resize(xag.size());
+
+    for(auto const& lvl : levels){ if(lvl.size() != 0)
     {
 
       /* store two action sets for each node in the level */
       std::vector<std::pair<uint32_t, std::vector<cone_t>>> node_and_action;      
       std::vector<std::pair<uint32_t, std::vector<cone_t>>> to_be_uncomputed;
 
-      easy::utils::dynamic_bitset<> visited;
-      visited.resize(xag.size());
-
       for(auto n : lvl)
       {
         /* this strategy does not support symplification of an included fanin cone, hence the false flag */
@@ -590,22 +750,36 @@ public:
           /* modifies cones.leaves and cones.copies according to visited */
           eval_copies(cones, visited);
         }
-        node_and_action.push_back({n, cones});
+        node_and_action.push_back({n, std::move( cones )});
       }
 
-      it = steps().insert(it, {lvl[0], compute_level_action{node_and_action}});
-      it = it + 1;
-      
-      for(auto node : node_and_action)
+      /* clear visited leaves for the next level */
+      for(auto const& node : node_and_action)
       {
-        if(std::find(drivers.begin(), drivers.end(), node.first) == drivers.end())
+        if(!xag.is_and(node.first)) continue;
+        for(auto const& cone : node.second)
+        {
+          for(auto l : cone.leaves)
+          {
+            visited.reset_bit(l);
+          }
+        }
+      }
+
+      for(auto const& node : node_and_action)
+      {
+        if(!fi.is_driver(node.first))
         to_be_uncomputed.push_back(node);
       }
-      it = steps().insert(it, {lvl[0], uncompute_level_action{to_be_uncomputed}});
-      
+
+      comp_steps.push_back({lvl[0], compute_level_action{std::move( node_and_action )}});
+      uncomp_steps.push_back({{lvl[0], uncompute_level_action{std::move( to_be_uncomputed )}}});
     }
     
     }
+
+    detail::merge_steps( steps(), std::move( comp_steps ), std::move( uncomp_steps ) );
+
     return true;
   }
 };
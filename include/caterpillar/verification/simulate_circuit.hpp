@@ -0,0 +1,377 @@
+/*------------------------------------------------------------------------------
+| This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/partial_truth_table.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/traits.hpp>
+#include <tweedledum/gates/gate_base.hpp>
+
+namespace caterpillar
+{
+
+struct circuit_simulation_params
+{
+  /*! \brief Number of random input patterns (rounded up to a multiple of 64). */
+  uint32_t num_patterns{512u};
+
+  /*! \brief Simulate all input assignments if there are at most this many inputs (at most 24). */
+  uint32_t max_exhaustive_inputs{9u};
+
+  /*! \brief Seed for the random input patterns. */
+  uint32_t seed{1u};
+
+  /*! \brief Check that ancillae end in a constant state and inputs are restored. */
+  bool check_ancillae{true};
+};
+
+namespace detail
+{
+
+/* gates with a control function, such as `stg_gate` */
+template<class Gate, class = void>
+struct has_control_function : std::false_type
+{
+};
+
+template<class Gate>
+struct has_control_function<Gate, std::void_t<decltype( std::declval<Gate const&>().function().num_vars() )>> : std::true_type
+{
+};
+
+/* A reversible circuit as a list of multiple-controlled NOT gates, each
+ * control is stored as `( qubit << 1 ) | complemented`.  Single-target gates
+ * with a control function flip the target if the function evaluates to true
+ * for the controls, where the i-th control is the i-th variable. */
+struct packed_reversible_circuit
+{
+  static constexpr uint32_t no_function = 0xffffffffu;
+
+  struct gate
+  {
+    uint32_t target;
+    uint32_t controls_begin;
+    uint32_t controls_end;
+    uint32_t function;
+  };
+
+  uint32_t num_qubits{0u};
+  std::vector<gate> gates;
+  std::vector<uint32_t> controls;
+  std::vector<kitty::dynamic_truth_table> functions;
+};
+
+template<class QuantumCircuit>
+std::optional<packed_reversible_circuit> pack_reversible_circuit( QuantumCircuit const& circ )
+{
+  using namespace tweedledum;
+
+  packed_reversible_circuit packed;
+  packed.num_qubits = circ.num_qubits();
+
+  bool error{false};
+  circ.foreach_cgate( [&]( auto const& n ) {
+    if constexpr ( has_control_function<std::decay_t<decltype( n.gate )>>::value )
+    {
+      if ( n.gate.operation() == gate_set::num_defined_ops )
+      {
+        if ( n.gate.num_targets() != 1u || n.gate.function().num_vars() != n.gate.num_controls() )
+        {
+          error = true;
+          return false;
+        }
+        const auto begin = static_cast<uint32_t>( packed.controls.size() );
+        n.gate.foreach_control( [&]( auto c ) {
+          packed.controls.push_back( ( c.index() << 1 ) | ( c.is_complemented() ? 1u : 0u ) );
+        } );
+        const auto end = static_cast<uint32_t>( packed.controls.size() );
+        n.gate.foreach_target( [&]( auto t ) {
+          packed.gates.push_back( {t.index(), begin, end, static_cast<uint32_t>( packed.functions.size() )} );
+        } );
+        packed.functions.push_back( n.gate.function() );
+        return true;
+      }
+    }
+
+    /* diagonal gates do not change the classical state */
+    if ( n.gate.is_one_of( gate_set::identity, gate_set::rotation_z, gate_set::t, gate_set::t_dagger, gate_set::phase,
+                           gate_set::phase_dagger, gate_set::pauli_z, gate_set::cz, gate_set::mcz ) )
+    {
+      return true;
+    }
+    if ( !n.gate.is_one_of( gate_set::pauli_x, gate_set::cx, gate_set::mcx ) )
+    {
+      error = true;
+      return false;
+    }
+
+    const auto begin = static_cast<uint32_t>( packed.controls.size() );
+    n.gate.foreach_control( [&]( auto c ) {
+      packed.controls.push_back( ( c.index() << 1 ) | ( c.is_complemented() ? 1u : 0u ) );
+    } );
+    const auto end = static_cast<uint32_t>( packed.controls.size() );
+    n.gate.foreach_target( [&]( auto t ) {
+      packed.gates.push_back( {t.index(), begin, end, packed_reversible_circuit::no_function} );
+    } );
+    return true;
+  } );
+
+  if ( error )
+  {
+    return std::nullopt;
+  }
+  return packed;
+}
+
+} // namespace detail
+
+/*! \brief Bit-parallel classical simulation of a reversible circuit.
+ *
+ * Qubit `inputs[i]` is initialized with the values in `patterns[i]`, all other
+ * qubits with 0.  The circuit is simulated for all patterns at once, in
+ * blocks of 512 patterns: each gate is applied to 8 64-bit words per qubit, a
+ * loop that compilers vectorize.  Diagonal gates (Z rotations, CZ, MCZ) are
+ * ignored, since they only change the phase.  Single-target gates with a
+ * control function (see `stg_gate`) are evaluated pattern by pattern.
+ *
+ * Returns the final value of each qubit, or `std::nullopt` if the circuit
+ * contains a gate which is not classical (e.g., a Hadamard gate).
+ *
+ * \param circ Reversible quantum circuit
+ * \param inputs Qubits which are initialized with patterns
+ * \param patterns Input patterns, all of the same length
+ */
+template<class QuantumCircuit>
+std::optional<std::vector<kitty::partial_truth_table>> simulate_circuit( QuantumCircuit const& circ, std::vector<uint32_t> const& inputs, std::vector<kitty::partial_truth_table> const& patterns )
+{
+  assert( inputs.size() == patterns.size() );
+
+  const auto packed = detail::pack_reversible_circuit( circ );
+  if ( !packed )
+  {
+    return std::nullopt;
+  }
+
+  constexpr uint32_t block_words = 8u;
+  const auto num_bits = patterns.empty() ? 64u : patterns.front().num_bits();
+  const auto num_words = ( num_bits + 63u ) / 64u;
+
+  std::vector<kitty::partial_truth_table> result( packed->num_qubits, kitty::partial_truth_table( num_bits ) );
+  std::vector<uint64_t> state( packed->num_qubits * block_words );
+
+  for ( auto offset = 0u; offset < num_words; offset += block_words )
+  {
+    const auto words = std::min( block_words, num_words - offset );
+
+    std::fill( state.begin(), state.end(), uint64_t( 0 ) );
+    for ( auto i = 0u; i < inputs.size(); ++i )
+    {
+      std::copy_n( patterns[i].begin() + offset, words, state.begin() + inputs[i] * block_words );
+    }
+
+    for ( auto const& g : packed->gates )
+    {
+      if ( g.function != detail::packed_reversible_circuit::no_function )
+      {
+        /* evaluate the control function bit by bit */
+        auto const& function = packed->functions[g.function];
+        auto* target = &state[g.target * block_words];
+        for ( auto w = 0u; w < words; ++w )
+        {
+          for ( auto b = 0u; b < 64u; ++b )
+          {
+            uint64_t index{0u};
+            for ( auto j = g.controls_begin; j < g.controls_end; ++j )
+            {
+              const auto c = packed->controls[j];
+              const auto value = ( ( state[( c >> 1 ) * block_words + w] >> b ) ^ c ) & 1u;
+              index |= value << ( j - g.controls_begin );
+            }
+            if ( kitty::get_bit( function, index ) )
+            {
+              target[w] ^= uint64_t( 1 ) << b;
+            }
+          }
+        }
+        continue;
+      }
+
+      uint64_t acc[block_words];
+      std::fill_n( acc, block_words, ~uint64_t( 0 ) );
+      for ( auto j = g.controls_begin; j < g.controls_end; ++j )
+      {
+        const auto c = packed->controls[j];
+        const auto mask = ( c & 1u ) ? ~uint64_t( 0 ) : uint64_t( 0 );
+        const auto* values = &state[( c >> 1 ) * block_words];
+        for ( auto w = 0u; w < block_words; ++w )
+        {
+          acc[w] &= values[w] ^ mask;
+        }
+      }
+      auto* target = &state[g.target * block_words];
+      for ( auto w = 0u; w < block_words; ++w )
+      {
+        target[w] ^= acc[w];
+      }
+    }
+
+    for ( auto q = 0u; q < packed->num_qubits; ++q )
+    {
+      std::copy_n( state.begin() + q * block_words, words, result[q].begin() + offset );
+    }
+  }
+
+  for ( auto& tt : result )
+  {
+    tt.mask_bits();
+  }
+  return result;
+}
+
+/*! \brief Checks a compiled reversible circuit against its logic network.
+ *
+ * The logic network is simulated with `mockturtle::bit_packed_simulator` and
+ * the circuit with `simulate_circuit`, where the primary inputs and outputs
+ * are mapped to the qubits `inputs` and `outputs` (e.g.,
+ * `logic_network_synthesis_stats::i_indexes` and `o_indexes`).  All input
+ * assignments are simulated if there are few primary inputs, otherwise
+ * `num_patterns` random ones.  If `check_ancillae` is set, all other qubits
+ * must end in a constant state and input qubits which are not outputs must be
+ * restored.
+ *
+ * Returns whether the circuit matches the network for all simulated
+ * patterns, or `std::nullopt` if the circuit contains non-classical gates.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      logic_network_synthesis_stats st;
+      logic_network_synthesis( qnet, xag, strategy, {}, {}, &st );
+      const auto ok = check_circuit_simulation( qnet, xag, st.i_indexes, st.o_indexes );
+   \endverbatim
+ */
+template<class QuantumCircuit, class LogicNetwork>
+std::optional<bool> check_circuit_simulation( QuantumCircuit const& circ, LogicNetwork const& ntk,
+                                              std::vector<uint32_t> const& inputs, std::vector<uint32_t> const& outputs,
+                                              circuit_simulation_params const& ps = {} )
+{
+  static_assert( mockturtle::is_network_type_v<LogicNetwork>, "LogicNetwork is not a network type" );
+  static_assert( mockturtle::has_compute_v<LogicNetwork, kitty::partial_truth_table>, "LogicNetwork does not implement the compute method for partial_truth_table" );
+
+  if ( inputs.size() != ntk.num_pis() || outputs.size() != ntk.num_pos() )
+  {
+    return false;
+  }
+
+  if ( ntk.num_pis() == 0u )
+  {
+    /* all qubits are initialized with 0 */
+    const auto qubits = simulate_circuit( circ, inputs, {} );
+    if ( !qubits )
+    {
+      return std::nullopt;
+    }
+    const auto po_values = mockturtle::simulate<bool>( ntk, mockturtle::default_simulator<bool>( std::vector<bool>{} ) );
+    for ( auto i = 0u; i < outputs.size(); ++i )
+    {
+      if ( kitty::get_bit( ( *qubits )[outputs[i]], 0 ) != po_values[i] )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  mockturtle::bit_packed_simulator sim;
+  /* bounds the number of exhaustive patterns to 2^24 */
+  if ( ntk.num_pis() <= std::min( ps.max_exhaustive_inputs, 24u ) )
+  {
+    const auto num_bits = std::max( 64u, 1u << ntk.num_pis() );
+    std::vector<kitty::partial_truth_table> patterns;
+    for ( auto i = 0u; i < ntk.num_pis(); ++i )
+    {
+      kitty::partial_truth_table tt( num_bits );
+      for ( auto b = 0u; b < num_bits; ++b )
+      {
+        if ( ( b >> i ) & 1 )
+        {
+          kitty::set_bit( tt, b );
+        }
+      }
+      patterns.push_back( tt );
+    }
+    sim = mockturtle::bit_packed_simulator( patterns );
+  }
+  else
+  {
+    sim = mockturtle::bit_packed_simulator( ntk.num_pis(), ( std::max( ps.num_patterns, 1u ) + 63u ) & ~63u, ps.seed );
+  }
+  const auto patterns = sim.get_patterns();
+
+  const auto qubits = simulate_circuit( circ, inputs, patterns );
+  if ( !qubits )
+  {
+    return std::nullopt;
+  }
+
+  const auto po_values = mockturtle::simulate<kitty::partial_truth_table>( ntk, sim );
+  for ( auto i = 0u; i < outputs.size(); ++i )
+  {
+    if ( ( *qubits )[outputs[i]] != po_values[i] )
+    {
+      return false;
+    }
+  }
+
+  if ( ps.check_ancillae )
+  {
+    std::vector<int32_t> input_of( qubits->size(), -1 );
+    for ( auto i = 0u; i < inputs.size(); ++i )
+    {
+      input_of[inputs[i]] = i;
+    }
+    std::vector<bool> is_output( qubits->size(), false );
+    for ( auto q : outputs )
+    {
+      is_output[q] = true;
+    }
+
+    for ( auto q = 0u; q < qubits->size(); ++q )
+    {
+      auto const& tt = ( *qubits )[q];
+      if ( is_output[q] )
+      {
+        continue;
+      }
+      if ( input_of[q] != -1 )
+      {
+        if ( tt != patterns[input_of[q]] )
+        {
+          return false;
+        }
+      }
+      else if ( !kitty::is_const0( tt ) && !kitty::is_const0( ~tt ) )
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace caterpillar
@@ -36,11 +36,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include <kitty/constructors.hpp>
@@ -76,6 +81,9 @@ struct cut_enumeration_params
   /*! \brief Prune cuts by removing don't cares. */
   bool minimize_truth_table{ false };
 
+  /*! \brief Number of threads for `cut_enumeration` (level-parallel if > 1). */
+  uint32_t num_threads{ 1u };
+
   /*! \brief Be verbose. */
   bool verbose{ false };
 
@@ -287,28 +295,105 @@ private:
 namespace detail
 {
 
+/* Cut database as seen by `cut_enumeration_update_cut` in the level-parallel
+ * mode, in which the truth tables of a node's cuts are kept aside until they
+ * are inserted into the truth table cache in topological order. */
+template<typename NetworkCuts>
+struct pending_network_cuts
+{
+  using cut_t = typename NetworkCuts::cut_t;
+  using cut_set_t = typename NetworkCuts::cut_set_t;
+
+  static constexpr uint32_t pending_mask = 0x80000000;
+
+  cut_set_t const& cuts( uint32_t node_index ) const { return _cuts.cuts( node_index ); }
+
+  /* only valid for cuts of the node which is updated */
+  auto truth_table( cut_t const& cut ) const
+  {
+    return ( cut->func_id & pending_mask ) ? _pending[cut->func_id & ~pending_mask] : _cuts.truth_table( cut );
+  }
+
+  auto nodes_size() const { return _cuts.nodes_size(); }
+
+  NetworkCuts const& _cuts;
+  std::vector<kitty::dynamic_truth_table> const& _pending;
+};
+
+class cut_enumeration_barrier
+{
+public:
+  explicit cut_enumeration_barrier( uint32_t num_threads ) : num_threads( num_threads ) {}
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    const auto generation = current_generation;
+    if ( ++num_waiting == num_threads )
+    {
+      num_waiting = 0u;
+      ++current_generation;
+      cv.notify_all();
+    }
+    else
+    {
+      cv.wait( lock, [&]() { return generation != current_generation; } );
+    }
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t num_threads;
+  uint32_t num_waiting{ 0u };
+  uint64_t current_generation{ 0u };
+};
+
 template<typename Ntk, bool ComputeTruth, typename CutData>
 class cut_enumeration_impl
 {
 public:
   using cut_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_t;
   using cut_set_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_set_t;
+  using pending_cuts_t = pending_network_cuts<network_cuts<Ntk, ComputeTruth, CutData>>;
 
   explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts<Ntk, ComputeTruth, CutData>& cuts )
       : ntk( ntk ),
         ps( ps ),
         st( st ),
-        cuts( cuts )
+        cuts( cuts ),
+        parallel( ps.num_threads > 1u )
   {
     assert( ps.cut_limit < cuts.max_cut_num && "cut_limit exceeds the compile-time limit for the maximum number of cuts" );
   }
 
+private:
+  /* merge state of one thread */
+  struct worker_t
+  {
+    std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+    std::array<uint32_t, Ntk::max_fanin_size> fanins;
+    std::vector<cut_t const*> vcuts;
+    std::vector<kitty::dynamic_truth_table> tts;
+
+    uint32_t total_tuples{ 0u };
+    std::size_t total_cuts{ 0u };
+    stopwatch<>::duration time_truth_table{ 0 };
+  };
+
 public:
   void run()
   {
     stopwatch t( st.time_total );
 
-    ntk.foreach_node( [this]( auto node ) {
+    if ( parallel )
+    {
+      run_parallel();
+      return;
+    }
+
+    worker_t w;
+    ntk.foreach_node( [&]( auto node ) {
       const auto index = ntk.node_to_index( node );
 
       if ( ps.very_verbose )
@@ -326,31 +411,197 @@ public:
       }
       else
       {
-        if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+        compute_cuts( index, w );
+      }
+    } );
+    collect_stats( w );
+  }
+
+private:
+  /* Nodes are grouped by their level and the cuts of all nodes in a level are
+   * computed concurrently.  The truth tables of the new cuts are kept with
+   * their node and, after each level, inserted into the truth table cache in
+   * the order of `foreach_node` for all nodes whose predecessors in that order
+   * are done.  Hence, the cuts and their function ids are the same as in the
+   * sequential mode. */
+  void run_parallel()
+  {
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> levels( ntk.size(), 0u );
+    std::vector<std::vector<uint32_t>> level_nodes( 1u );
+
+    order.reserve( ntk.size() );
+    ntk.foreach_node( [&]( auto node ) {
+      const auto index = ntk.node_to_index( node );
+      order.push_back( index );
+
+      if ( ntk.is_constant( node ) )
+      {
+        cuts.add_zero_cut( index );
+      }
+      else if ( ntk.is_ci( node ) )
+      {
+        cuts.add_unit_cut( index );
+      }
+      else
+      {
+        uint32_t level{ 0u };
+        ntk.foreach_fanin( node, [&]( auto const& f ) {
+          level = std::max( level, levels[ntk.node_to_index( ntk.get_node( f ) )] );
+        } );
+        levels[index] = ++level;
+        if ( level_nodes.size() <= level )
         {
-          merge_cuts2( index );
+          level_nodes.resize( level + 1u );
         }
-        else
+        level_nodes[level].push_back( index );
+      }
+    } );
+
+    if constexpr ( ComputeTruth )
+    {
+      pending.resize( ntk.size() );
+    }
+
+    const auto num_threads = ps.num_threads;
+    std::vector<worker_t> workers( num_threads );
+    cut_enumeration_barrier barrier( num_threads );
+    std::atomic<uint32_t> next{ 0u };
+    uint32_t committed{ 0u };
+
+    const auto work = [&]( uint32_t thread_id ) {
+      auto& w = workers[thread_id];
+      for ( auto level = 1u; level < level_nodes.size(); ++level )
+      {
+        auto const& nodes = level_nodes[level];
+        while ( true )
         {
-          merge_cuts( index );
+          const auto first = next.fetch_add( chunk_size );
+          if ( first >= nodes.size() )
+          {
+            break;
+          }
+          const auto last = std::min<std::size_t>( first + chunk_size, nodes.size() );
+          for ( auto i = first; i < last; ++i )
+          {
+            compute_cuts( nodes[i], w );
+          }
         }
+
+        barrier.wait();
+        if ( thread_id == 0u )
+        {
+          if ( ps.very_verbose )
+          {
+            std::cout << fmt::format( "[i] computed cuts for {} nodes at level {}\n", nodes.size(), level );
+          }
+          commit( order, levels, level, committed );
+          next = 0u;
+        }
+        barrier.wait();
       }
-    } );
+    };
+
+    std::vector<std::thread> threads;
+    for ( auto i = 1u; i < num_threads; ++i )
+    {
+      threads.emplace_back( work, i );
+    }
+    work( 0u );
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+
+    for ( auto const& w : workers )
+    {
+      collect_stats( w );
+    }
   }
 
-private:
-  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  /* inserts the truth tables of all nodes up to the first one above `level` */
+  void commit( std::vector<uint32_t> const& order, std::vector<uint32_t> const& levels, uint32_t level, uint32_t& committed )
   {
-    stopwatch t( st.time_truth_table );
+    if constexpr ( ComputeTruth )
+    {
+      std::vector<uint32_t> func_ids;
+      for ( ; committed < order.size() && levels[order[committed]] <= level; ++committed )
+      {
+        const auto index = order[committed];
+        auto& tts = pending[index];
+        if ( tts.empty() )
+        {
+          continue;
+        }
 
-    std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
-    auto i = 0;
-    for ( auto const& cut : vcuts )
+        func_ids.resize( tts.size() );
+        for ( auto i = 0u; i < tts.size(); ++i )
+        {
+          func_ids[i] = cuts._truth_tables.insert( tts[i] );
+        }
+        for ( auto& cut : cuts.cuts( index ) )
+        {
+          if ( ( *cut )->func_id & pending_cuts_t::pending_mask )
+          {
+            ( *cut )->func_id = func_ids[( *cut )->func_id & ~pending_cuts_t::pending_mask];
+          }
+        }
+        std::vector<kitty::dynamic_truth_table>().swap( tts );
+      }
+    }
+    else
     {
-      tt[i] = kitty::extend_to( cuts._truth_tables[( *cut )->func_id], res.size() );
-      const auto supp = cuts.compute_truth_table_support( *cut, res );
+      (void)order;
+      (void)levels;
+      (void)level;
+      (void)committed;
+    }
+  }
+
+  void collect_stats( worker_t const& w )
+  {
+    cuts._total_tuples += w.total_tuples;
+    cuts._total_cuts += w.total_cuts;
+    st.time_truth_table += w.time_truth_table;
+  }
+
+  void compute_cuts( uint32_t index, worker_t& w )
+  {
+    if constexpr ( Ntk::min_fanin_size == 2 && Ntk::max_fanin_size == 2 )
+    {
+      merge_cuts2( index, w );
+    }
+    else
+    {
+      merge_cuts( index, w );
+    }
+  }
+
+  void update_cut( cut_t& cut, uint32_t index )
+  {
+    if ( ComputeTruth && parallel )
+    {
+      cut_enumeration_update_cut<CutData>::apply( cut, pending_cuts_t{ cuts, pending[index] }, ntk, ntk.index_to_node( index ) );
+    }
+    else
+    {
+      cut_enumeration_update_cut<CutData>::apply( cut, cuts, ntk, ntk.index_to_node( index ) );
+    }
+  }
+
+  uint32_t compute_truth_table( uint32_t index, worker_t& w, cut_t& res )
+  {
+    stopwatch t( w.time_truth_table );
+
+    auto& tt = w.tts;
+    tt.resize( w.vcuts.size() );
+    for ( auto i = 0u; i < w.vcuts.size(); ++i )
+    {
+      auto const& cut = *w.vcuts[i];
+      const auto func_id = cut->func_id;
+      tt[i] = kitty::extend_to( ( func_id & pending_cuts_t::pending_mask ) ? pending[w.fanins[i]][func_id & ~pending_cuts_t::pending_mask] : cuts._truth_tables[func_id], res.size() );
+      const auto supp = cuts.compute_truth_table_support( cut, res );
       kitty::expand_inplace( tt[i], supp );
-      ++i;
     }
 
     auto tt_res = ntk.compute( ntk.index_to_node( index ), tt.begin(), tt.end() );
@@ -371,34 +622,45 @@ private:
           *it_leaves++ = leaves_before[*it_support++];
         }
         res.set_leaves( leaves_after.begin(), leaves_after.end() );
-        return cuts._truth_tables.insert( tt_res_shrink );
+        return insert_truth_table( index, tt_res_shrink );
       }
     }
 
-    return cuts._truth_tables.insert( tt_res );
+    return insert_truth_table( index, tt_res );
   }
 
-  void merge_cuts2( uint32_t index )
+  uint32_t insert_truth_table( uint32_t index, kitty::dynamic_truth_table const& tt )
+  {
+    if ( parallel )
+    {
+      pending[index].push_back( tt );
+      return static_cast<uint32_t>( pending[index].size() - 1u ) | pending_cuts_t::pending_mask;
+    }
+    return cuts._truth_tables.insert( tt );
+  }
+
+  void merge_cuts2( uint32_t index, worker_t& w )
   {
     const auto fanin = 2;
 
     uint32_t pairs{ 1 };
-    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs]( auto child, auto i ) {
-      lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
-      pairs *= static_cast<uint32_t>( lcuts[i]->size() );
+    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs, &w]( auto child, auto i ) {
+      w.fanins[i] = ntk.node_to_index( ntk.get_node( child ) );
+      w.lcuts[i] = &cuts.cuts( w.fanins[i] );
+      pairs *= static_cast<uint32_t>( w.lcuts[i]->size() );
     } );
-    lcuts[2] = &cuts.cuts( index );
-    auto& rcuts = *lcuts[fanin];
+    w.lcuts[2] = &cuts.cuts( index );
+    auto& rcuts = *w.lcuts[fanin];
     rcuts.clear();
 
     cut_t new_cut;
 
-    std::vector<cut_t const*> vcuts( fanin );
+    w.vcuts.resize( fanin );
 
-    cuts._total_tuples += pairs;
-    for ( auto const& c1 : *lcuts[0] )
+    w.total_tuples += pairs;
+    for ( auto const& c1 : *w.lcuts[0] )
     {
-      for ( auto const& c2 : *lcuts[1] )
+      for ( auto const& c2 : *w.lcuts[1] )
       {
         if ( !c1->merge( *c2, new_cut, ps.cut_size ) )
         {
@@ -412,12 +674,12 @@ private:
 
         if constexpr ( ComputeTruth )
         {
-          vcuts[0] = c1;
-          vcuts[1] = c2;
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          w.vcuts[0] = c1;
+          w.vcuts[1] = c2;
+          new_cut->func_id = compute_truth_table( index, w, new_cut );
         }
 
-        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, index );
+        update_cut( new_cut, index );
 
         rcuts.insert( new_cut );
       }
@@ -426,7 +688,7 @@ private:
     /* limit the maximum number of cuts */
     rcuts.limit( ps.cut_limit - 1 );
 
-    cuts._total_cuts += rcuts.size();
+    w.total_cuts += rcuts.size();
 
     if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
     {
@@ -434,20 +696,21 @@ private:
     }
   }
 
-  void merge_cuts( uint32_t index )
+  void merge_cuts( uint32_t index, worker_t& w )
   {
     uint32_t pairs{ 1 };
     std::vector<uint32_t> cut_sizes;
-    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs, &cut_sizes]( auto child, auto i ) {
-      lcuts[i] = &cuts.cuts( ntk.node_to_index( ntk.get_node( child ) ) );
-      cut_sizes.push_back( static_cast<uint32_t>( lcuts[i]->size() ) );
+    ntk.foreach_fanin( ntk.index_to_node( index ), [this, &pairs, &cut_sizes, &w]( auto child, auto i ) {
+      w.fanins[i] = ntk.node_to_index( ntk.get_node( child ) );
+      w.lcuts[i] = &cuts.cuts( w.fanins[i] );
+      cut_sizes.push_back( static_cast<uint32_t>( w.lcuts[i]->size() ) );
       pairs *= cut_sizes.back();
     } );
 
     const auto fanin = cut_sizes.size();
-    lcuts[fanin] = &cuts.cuts( index );
+    w.lcuts[fanin] = &cuts.cuts( index );
 
-    auto& rcuts = *lcuts[fanin];
+    auto& rcuts = *w.lcuts[fanin];
 
     if ( fanin > 1 && fanin <= ps.fanin_limit )
     {
@@ -455,15 +718,16 @@ private:
 
       cut_t new_cut, tmp_cut;
 
-      std::vector<cut_t const*> vcuts( fanin );
+      auto& vcuts = w.vcuts;
+      vcuts.resize( fanin );
 
-      cuts._total_tuples += pairs;
+      w.total_tuples += pairs;
       foreach_mixed_radix_tuple( cut_sizes.begin(), cut_sizes.end(), [&]( auto begin, auto end ) {
         auto it = vcuts.begin();
         auto i = 0u;
         while ( begin != end )
         {
-          *it++ = &( ( *lcuts[i++] )[*begin++] );
+          *it++ = &( ( *w.lcuts[i++] )[*begin++] );
         }
 
         if ( !vcuts[0]->merge( *vcuts[1], new_cut, ps.cut_size ) )
@@ -487,10 +751,10 @@ private:
 
         if constexpr ( ComputeTruth )
         {
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          new_cut->func_id = compute_truth_table( index, w, new_cut );
         }
 
-        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
+        update_cut( new_cut, index );
 
         rcuts.insert( new_cut );
 
@@ -504,16 +768,18 @@ private:
     {
       rcuts.clear();
 
-      for ( auto const& cut : *lcuts[0] )
+      w.vcuts.resize( 1u );
+      for ( auto const& cut : *w.lcuts[0] )
       {
         cut_t new_cut = *cut;
 
         if constexpr ( ComputeTruth )
         {
-          new_cut->func_id = compute_truth_table( index, { cut }, new_cut );
+          w.vcuts[0] = cut;
+          new_cut->func_id = compute_truth_table( index, w, new_cut );
         }
 
-        cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
+        update_cut( new_cut, index );
 
         rcuts.insert( new_cut );
       }
@@ -522,18 +788,23 @@ private:
       rcuts.limit( ps.cut_limit - 1 );
     }
 
-    cuts._total_cuts += static_cast<uint32_t>( rcuts.size() );
+    w.total_cuts += static_cast<uint32_t>( rcuts.size() );
 
     cuts.add_unit_cut( index );
   }
 
 private:
+  /* number of nodes a thread takes at once in the level-parallel mode */
+  static constexpr uint32_t chunk_size = 16u;
+
   Ntk const& ntk;
   cut_enumeration_params const& ps;
   cut_enumeration_stats& st;
   network_cuts<Ntk, ComputeTruth, CutData>& cuts;
+  bool parallel;
 
-  std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+  /* truth tables of cuts which are not yet in the cache (level-parallel mode) */
+  std::vector<std::vector<kitty::dynamic_truth_table>> pending;
 };
 } /* namespace detail */
 /*! \endcond */
@@ -560,6 +831,14 @@ private:
  * application specific cut data can be found in the files contained in the
  * directory `include/mockturtle/algorithms/cut_enumeration`.
  *
+ * If `num_threads` is larger than 1, the nodes are grouped by their level and
+ * the cuts of the nodes in one level are computed concurrently, each thread
+ * with its own merge state.  The resulting cuts, including the function ids
+ * of their truth tables, are the same as in the sequential mode.  This
+ * requires that the network's `const` methods can be called concurrently.
+ * The `cuts` passed to `cut_enumeration_update_cut::apply` then only provide
+ * `cuts`, `nodes_size`, and `truth_table` for the updated cut.
+ *
  * **Required network functions:**
  * - `is_constant`
  * - `is_ci`
@@ -33,12 +33,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include <bill/sat/interface/abc_bsat2.hpp>
 #include <bill/sat/interface/common.hpp>
+#include <bill/sat/interface/ghack.hpp>
 #include <bill/sat/interface/glucose.hpp>
+#include <bill/sat/interface/z3.hpp>
 #include <kitty/bit_operations.hpp>
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
@@ -65,6 +76,14 @@ struct exact_mc_synthesis_params
   /*! \brief Use CEGAR based solving strategy. */
   bool use_cegar{ false };
 
+  /*! \brief Reuse one solver instance when increasing the number of AND gates.
+   *
+   * Constraints on AND gates are kept in the solver, and constraints on the
+   * output are guarded by an activation literal.  Learned clauses and (in
+   * CEGAR mode) asserted bits are carried over to the next attempt.
+   */
+  bool incremental{ false };
+
   /*! \brief Use subset symmetry breaking. */
   bool break_subset_symmetries{ true };
 
@@ -89,6 +108,19 @@ struct exact_mc_synthesis_params
   /*! \brief Conflict limit for the SAT solver. */
   uint32_t conflict_limit{ 0u };
 
+  /*! \brief Flag to cancel synthesis from another thread.
+   *
+   * If set, the SAT solver is called with a conflict limit of
+   * `stop_check_conflicts` repeatedly, and the flag is checked in between.
+   * Synthesis returns without a solution once the flag is raised, i.e.,
+   * `exact_mc_synthesis` returns an empty network and
+   * `exact_mc_synthesis_multiple` an empty vector.
+   */
+  std::atomic<bool> const* stop{ nullptr };
+
+  /*! \brief Number of conflicts between two checks of `stop`. */
+  uint32_t stop_check_conflicts{ 1000u };
+
   /*! \brief Use conflict limit only when searching for multiple solutions
    *
    * The conflict limit will be ignored for the first call.
@@ -132,6 +164,63 @@ struct exact_mc_synthesis_stats
   }
 };
 
+/*! \brief Solver configuration in a portfolio. */
+struct exact_mc_synthesis_portfolio_entry
+{
+  /*! \brief SAT solver backend. */
+  bill::solvers solver{ bill::solvers::glucose_41 };
+
+  /*! \brief Synthesis parameters (`stop` is set by the portfolio).
+   *
+   * Each configuration keeps its synthesis engine while the number of AND
+   * gates is increased, hence `incremental` configurations reuse their
+   * solver, also after being stopped by another configuration.
+   */
+  exact_mc_synthesis_params ps{};
+};
+
+struct exact_mc_synthesis_portfolio_params
+{
+  /*! \brief Configurations raced for each number of AND gates.
+   *
+   * If empty, a default portfolio of solvers and symmetry breaking
+   * configurations is used.
+   */
+  std::vector<exact_mc_synthesis_portfolio_entry> configurations;
+
+  /*! \brief Number of threads.
+   *
+   * If 0, one thread per configuration is used, but not more than the
+   * hardware concurrency.
+   */
+  uint32_t num_threads{ 0u };
+
+  /*! \brief Minimum number of AND gates. */
+  uint32_t min_and_gates{ 0u };
+
+  /*! \brief Be verbose. */
+  bool verbose{ false };
+};
+
+struct exact_mc_synthesis_portfolio_stats
+{
+  /*! \brief Total time. */
+  stopwatch<>::duration time_total{};
+
+  /*! \brief Number of AND gate counts decided by each configuration. */
+  std::vector<uint32_t> num_decided;
+
+  /*! \brief Prints report. */
+  void report() const
+  {
+    fmt::print( "[i] total time    = {:>5.2f} secs\n", to_seconds( time_total ) );
+    for ( auto i = 0u; i < num_decided.size(); ++i )
+    {
+      fmt::print( "[i] configuration {} decided {} times\n", i, num_decided[i] );
+    }
+  }
+};
+
 namespace detail
 {
 
@@ -153,63 +242,97 @@ struct exact_mc_synthesis_impl
 
   std::vector<Ntk> run()
   {
-    stopwatch<> t( st_.time_total );
-
-    std::vector<Ntk> ntks;
-    const auto degree = kitty::polynomial_degree( func_ );
-    uint32_t num_ands = std::max( ps_.min_and_gates, degree == 0u ? degree : degree - 1u );
-
+    uint32_t num_ands = lower_bound();
     while ( true )
     {
-      if ( ps_.verbose )
+      if ( auto ntks = run_with( num_ands ); !ntks.empty() || stopped() )
       {
-        fmt::print( "try with {} AND gates\n", num_ands );
+        return ntks;
       }
+      ++num_ands;
+    }
+  }
+
+  /*! \brief Lower bound on the number of AND gates. */
+  uint32_t lower_bound() const
+  {
+    const auto degree = kitty::polynomial_degree( func_ );
+    return std::max( ps_.min_and_gates, degree == 0u ? degree : degree - 1u );
+  }
 
+  /*! \brief Searches for solutions with exactly `num_ands` AND gates.
+   *
+   * Returns an empty vector if no solution exists, or if the search was
+   * stopped (due to the conflict limit or the stop flag).  In incremental
+   * mode, the number of AND gates must not decrease between calls.
+   */
+  std::vector<Ntk> run_with( uint32_t num_ands )
+  {
+    stopwatch<> t( st_.time_total );
+
+    std::vector<Ntk> ntks;
+    if ( ps_.verbose )
+    {
+      fmt::print( "try with {} AND gates\n", num_ands );
+    }
+
+    if ( !pntk_ || !ps_.incremental )
+    {
       cnf_view_params cvps;
       cvps.write_dimacs = ps_.write_dimacs;
-      problem_network_t pntk( cvps );
-      reset( pntk );
+      pntk_ = std::make_unique<problem_network_t>( cvps );
+      reset( *pntk_ );
+    }
+    auto& pntk = *pntk_;
 
-      for ( auto i = 0u; i < num_ands; ++i )
-      {
-        add_gate( pntk );
-      }
-      add_output( pntk );
-      if ( ps_.heuristic_xor_bound || ps_.auto_update_xor_bound )
+    if ( ltfi_vars_.size() % 2u == 1u )
+    {
+      /* disable the output of the previous attempt */
+      pntk.add_clause( !activation_ );
+      ltfi_vars_.pop_back();
+    }
+    if ( ps_.incremental )
+    {
+      activation_ = pntk.create_pi();
+    }
+
+    while ( ltfi_vars_.size() / 2u < num_ands )
+    {
+      add_gate( pntk );
+    }
+    add_output( pntk );
+    if ( ps_.heuristic_xor_bound || ps_.auto_update_xor_bound )
+    {
+      add_xor_counter( pntk );
+    }
+
+    // TODO use LUT mapping before CNF generation
+    if ( const auto sol = ps_.use_cegar ? solve_with_cegar( pntk ) : solve_direct( pntk ); sol )
+    {
+      ntks.push_back( *sol );
+      if ( ps_.very_verbose )
       {
-        add_xor_counter( pntk );
+        debug_solution( pntk );
       }
-
-      // TODO use LUT mapping before CNF generation
-      if ( const auto sol = ps_.use_cegar ? solve_with_cegar( pntk ) : solve_direct( pntk ); sol )
+      while ( ntks.size() < num_solutions_ )
       {
-        ntks.push_back( *sol );
-        if ( ps_.very_verbose )
-        {
-          debug_solution( pntk );
-        }
-        while ( ntks.size() < num_solutions_ )
+        block( pntk );
+        if ( const auto result = solve( pntk, false ); result && *result )
         {
-          block( pntk );
-          if ( const auto result = solve( pntk, false ); result && *result )
+          ntks.push_back( extract_network( pntk ) );
+          if ( ps_.very_verbose )
           {
-            ntks.push_back( extract_network( pntk ) );
-            if ( ps_.very_verbose )
-            {
-              debug_solution( pntk );
-              fmt::print( "[i] found {} solutions so far\n", ntks.size() );
-            }
-          }
-          else
-          {
-            break;
+            debug_solution( pntk );
+            fmt::print( "[i] found {} solutions so far\n", ntks.size() );
           }
         }
-        return ntks;
+        else
+        {
+          break;
+        }
       }
-      ++num_ands;
     }
+    return ntks;
   }
 
 private:
@@ -222,8 +345,7 @@ private:
       constrain_assignment( pntk, b );
     }
 
-    st_.num_vars += pntk.num_vars();
-    st_.num_clauses += pntk.num_clauses();
+    update_stats( pntk );
     if ( const auto result = solve( pntk, true ); result && *result )
     {
       return extract_network( pntk );
@@ -238,7 +360,13 @@ private:
   {
     prune_search_space( pntk );
 
-    uint32_t num_ands = static_cast<uint32_t>( ltfi_vars_.size() ) / 2, bctr = 0u;
+    /* bits asserted in previous attempts (only in incremental mode) */
+    for ( auto b : cegar_bits_ )
+    {
+      constrain_assignment( pntk, b );
+    }
+
+    uint32_t num_ands = static_cast<uint32_t>( ltfi_vars_.size() ) / 2, bctr = static_cast<uint32_t>( cegar_bits_.size() );
     progress_bar pbar( static_cast<uint32_t>( func_.num_bits() ), "exact_mc_synthesis |{}| ANDs = {}   asserted bits = {}   SAT solving time = {:.2f} secs", ps_.progress );
     while ( true )
     {
@@ -248,22 +376,21 @@ private:
         const auto sol = extract_network( pntk );
         default_simulator<kitty::dynamic_truth_table> sim( num_vars_ );
         const auto simulated = simulate<kitty::dynamic_truth_table>( sol, sim )[0u];
-        if ( const auto bit = kitty::find_first_bit_difference( func_, simulated ); bit == -1 )
+        if ( const auto bit = kitty::find_first_bit_difference( func_, invert_ ? ~simulated : simulated ); bit == -1 )
         {
-          st_.num_vars += pntk.num_vars();
-          st_.num_clauses += pntk.num_clauses();
+          update_stats( pntk );
           return sol;
         }
         else
         {
           constrain_assignment( pntk, static_cast<uint32_t>( bit ) );
+          cegar_bits_.push_back( static_cast<uint32_t>( bit ) );
           bctr++;
         }
       }
       else
       {
-        st_.num_vars += pntk.num_vars();
-        st_.num_clauses += pntk.num_clauses();
+        update_stats( pntk );
         return std::nullopt;
       }
     }
@@ -276,6 +403,10 @@ private:
     pntk.foreach_po( [&]( auto const& f ) {
       assumptions.push_back( pntk.lit( f ) );
     } );
+    if ( ps_.incremental )
+    {
+      assumptions.push_back( pntk.lit( activation_ ) );
+    }
     if ( heuristic_xor_bound_ )
     {
       if ( int32_t pos = static_cast<int32_t>( xor_counter_.size() ) - *heuristic_xor_bound_ - 1; pos >= 0 )
@@ -283,7 +414,26 @@ private:
         assumptions.push_back( pntk.lit( !xor_counter_[pos] ) );
       }
     }
-    const auto res = pntk.solve( assumptions, ps_.ignore_conflict_limit_for_first_solution && first ? 0u : ps_.conflict_limit );
+    const auto limit = ps_.ignore_conflict_limit_for_first_solution && first ? 0u : ps_.conflict_limit;
+
+    std::optional<bool> res;
+    if ( !ps_.stop )
+    {
+      res = pntk.solve( assumptions, limit );
+    }
+    else
+    {
+      /* solve in slices to check the stop flag in between, learned clauses
+       * are kept in the solver */
+      for ( uint32_t spent = 0u; !stopped() && ( limit == 0u || spent < limit ); spent += ps_.stop_check_conflicts )
+      {
+        res = pntk.solve( assumptions, limit == 0u ? ps_.stop_check_conflicts : std::min( ps_.stop_check_conflicts, limit - spent ) );
+        if ( res )
+        {
+          break;
+        }
+      }
+    }
 
     if ( ps_.auto_update_xor_bound && res && *res )
     {
@@ -293,6 +443,25 @@ private:
     return res;
   }
 
+  bool stopped() const
+  {
+    return ps_.stop && ps_.stop->load();
+  }
+
+  void update_stats( problem_network_t const& pntk )
+  {
+    if ( ps_.incremental )
+    {
+      st_.num_vars = pntk.num_vars();
+      st_.num_clauses = pntk.num_clauses();
+    }
+    else
+    {
+      st_.num_vars += pntk.num_vars();
+      st_.num_clauses += pntk.num_clauses();
+    }
+  }
+
 private:
   Ntk extract_network( problem_network_t& pntk )
   {
@@ -338,10 +507,11 @@ private:
 
   void reset( problem_network_t const& pntk )
   {
-    // TODO: can we make this more iterative?
     ltfi_vars_.clear();
     truth_vars_.clear();
     truth_vars_.resize( func_.num_bits() );
+    cegar_bits_.clear();
+    num_pruned_gates_ = 0u;
 
     /* pre-assign truth_vars_ with primary inputs */
     for ( auto i = 0u; i < num_vars_; ++i )
@@ -383,45 +553,120 @@ private:
       return pntk.create_nary_xor( ltfi );
     };
 
-    for ( auto i = 0u; i < ltfi_vars_.size() / 2; ++i )
+    /* gates may already be constrained from a previous attempt */
+    for ( auto i = static_cast<uint32_t>( truth_vars_[bit].size() ) - num_vars_; i < ltfi_vars_.size() / 2; ++i )
     {
       truth_vars_[bit].push_back( pntk.create_and( create_xor_clause( ltfi_vars_[2 * i] ), create_xor_clause( ltfi_vars_[2 * i + 1] ) ) );
     }
 
     const auto po_signal = create_xor_clause( ltfi_vars_.back() );
-    pntk.create_po( kitty::get_bit( func_, bit ) ? po_signal : pntk.create_not( po_signal ) );
+    assert_output_constraint( pntk, kitty::get_bit( func_, bit ) ? po_signal : pntk.create_not( po_signal ) );
+  }
+
+  /* Constraints that involve the output depend on the number of AND gates.  In
+   * incremental mode, they are guarded by the activation literal of the current
+   * attempt. */
+  void add_output_clause( problem_network_t& pntk, std::vector<signal<problem_network_t>> clause )
+  {
+    if ( ps_.incremental )
+    {
+      clause.push_back( !activation_ );
+    }
+    pntk.add_clause( clause );
+  }
+
+  void assert_output_constraint( problem_network_t& pntk, signal<problem_network_t> const& f )
+  {
+    if ( ps_.incremental )
+    {
+      pntk.add_clause( !activation_, f );
+    }
+    else
+    {
+      pntk.create_po( f );
+    }
   }
 
   void prune_search_space( problem_network_t& pntk )
   {
+    /* constraints on AND gates do not depend on the output, in incremental mode
+     * they are only added once */
+    for ( ; num_pruned_gates_ < ltfi_vars_.size() / 2u; ++num_pruned_gates_ )
+    {
+      prune_gate( pntk, num_pruned_gates_ );
+    }
+
+    const auto out = static_cast<uint32_t>( ltfi_vars_.size() ) - 1u;
+
     // At least one element in LTFI
-    for ( auto const& ltfi : ltfi_vars_ )
+    add_output_clause( pntk, ltfi_vars_[out] );
+
+    // break on multi-level subset relation
+    if ( ps_.break_multi_level_subset_symmetries )
     {
-      pntk.add_clause( ltfi );
+      for ( auto const& f : multi_level_subset_constraints( pntk, out ) )
+      {
+        assert_output_constraint( pntk, f );
+      }
     }
 
-    // linear TFIs are no subset of each other
-    if ( ps_.break_subset_symmetries )
+    // break on symmetric variables
+    if ( ps_.break_symmetric_variables )
+    {
+      for ( const auto& [j, jj] : symmetric_variables() )
+      {
+        add_output_clause( pntk, symmetric_variables_clause( out, j, jj ) );
+      }
+    }
+
+    // ensure to use essential variables and gates
+    if ( ps_.ensure_to_use_gates )
     {
-      for ( auto i = 0u; i < ltfi_vars_.size() / 2u; ++i )
+      const auto num_ands = ltfi_vars_.size() / 2;
+      for ( auto j = 0u; j < num_vars_ + num_ands; ++j )
       {
-        auto const& ltfi1 = ltfi_vars_[2 * i];
-        auto const& ltfi2 = ltfi_vars_[2 * i + 1];
+        if ( j < num_vars_ && !kitty::has_var( func_, j ) )
+        {
+          continue;
+        }
 
-        std::vector<signal<problem_network_t>> ands( ltfi1.size() );
-        std::vector<signal<problem_network_t>> ands2( ltfi1.size() );
-        for ( auto j = 0u; j < ltfi1.size(); ++j )
+        std::vector<signal<problem_network_t>> clause;
+        for ( auto const& ltfi : ltfi_vars_ )
         {
-          ands[j] = pntk.create_and( ltfi1[j], pntk.create_not( ltfi2[j] ) );
-          ands2[j] = pntk.create_and( ltfi2[j], pntk.create_not( ltfi1[j] ) );
+          if ( j < ltfi.size() )
+          {
+            clause.push_back( ltfi[j] );
+          }
         }
-        pntk.add_clause( ands );
-        pntk.add_clause( ands2 );
+        add_output_clause( pntk, clause );
+      }
+    }
+  }
+
+  void prune_gate( problem_network_t& pntk, uint32_t i )
+  {
+    // At least one element in LTFI
+    pntk.add_clause( ltfi_vars_[2 * i] );
+    pntk.add_clause( ltfi_vars_[2 * i + 1] );
+
+    // linear TFIs are no subset of each other
+    if ( ps_.break_subset_symmetries )
+    {
+      auto const& ltfi1 = ltfi_vars_[2 * i];
+      auto const& ltfi2 = ltfi_vars_[2 * i + 1];
+
+      std::vector<signal<problem_network_t>> ands( ltfi1.size() );
+      std::vector<signal<problem_network_t>> ands2( ltfi1.size() );
+      for ( auto j = 0u; j < ltfi1.size(); ++j )
+      {
+        ands[j] = pntk.create_and( ltfi1[j], pntk.create_not( ltfi2[j] ) );
+        ands2[j] = pntk.create_and( ltfi2[j], pntk.create_not( ltfi1[j] ) );
       }
+      pntk.add_clause( ands );
+      pntk.add_clause( ands2 );
     }
 
     // left linear TFI is lexicographically smaller than right one
-    for ( auto i = 0u; i < ltfi_vars_.size() / 2u; ++i )
     {
       auto const& ltfi2 = ltfi_vars_[2 * i];
       auto const& ltfi1 = ltfi_vars_[2 * i + 1];
@@ -447,21 +692,11 @@ private:
     // break on multi-level subset relation
     if ( ps_.break_multi_level_subset_symmetries )
     {
-      for ( auto ii = 0u; ii < ltfi_vars_.size(); ++ii )
+      for ( auto ii = 2 * i; ii <= 2 * i + 1; ++ii )
       {
-        const auto& ltfi = ltfi_vars_[ii];
-        for ( auto i = 0u; i < ii / 2u; ++i )
+        for ( auto const& f : multi_level_subset_constraints( pntk, ii ) )
         {
-          const auto n = ltfi_vars_[2 * i].size();
-          std::vector<signal<problem_network_t>> ands_left, ands_right;
-          ands_left.push_back( ltfi[num_vars_ + i] );
-          for ( auto k = 0u; k < n; ++k )
-          {
-            ands_left.push_back( pntk.create_or( !ltfi[k], ltfi_vars_[2 * i][k] ) );
-            ands_left.push_back( pntk.create_or( !ltfi[k], ltfi_vars_[2 * i + 1][k] ) );
-            ands_right.push_back( pntk.create_xnor( ltfi[k], pntk.create_and( ltfi_vars_[2 * i][k], ltfi_vars_[2 * i + 1][k] ) ) );
-          }
-          pntk.create_po( pntk.create_or( !pntk.create_nary_and( ands_left ), pntk.create_nary_and( ands_right ) ) );
+          pntk.create_po( f );
         }
       }
     }
@@ -469,62 +704,73 @@ private:
     // break on symmetric variables
     if ( ps_.break_symmetric_variables )
     {
-      const auto break_symmetric_vars = [&]( auto j, auto jj ) {
-        if ( ps_.very_verbose )
-        {
-          fmt::print( "[i] symmetry breaking based on symmetric variables {} and {}\n", j, jj );
-        }
-        for ( auto ii = 0u; ii < ltfi_vars_.size(); ++ii )
-        {
-          std::vector<signal<problem_network_t>> clause;
-          clause.push_back( !ltfi_vars_[ii][jj] );
-          for ( auto i = 0u; i <= ii; ++i )
-          {
-            clause.push_back( ltfi_vars_[i][j] );
-          }
-          pntk.add_clause( clause );
-        }
-      };
+      for ( const auto& [j, jj] : symmetric_variables() )
+      {
+        pntk.add_clause( symmetric_variables_clause( 2 * i, j, jj ) );
+        pntk.add_clause( symmetric_variables_clause( 2 * i + 1, j, jj ) );
+      }
+    }
+  }
+
+  std::vector<signal<problem_network_t>> multi_level_subset_constraints( problem_network_t& pntk, uint32_t ii )
+  {
+    std::vector<signal<problem_network_t>> constraints;
+
+    const auto& ltfi = ltfi_vars_[ii];
+    for ( auto i = 0u; i < ii / 2u; ++i )
+    {
+      const auto n = ltfi_vars_[2 * i].size();
+      std::vector<signal<problem_network_t>> ands_left, ands_right;
+      ands_left.push_back( ltfi[num_vars_ + i] );
+      for ( auto k = 0u; k < n; ++k )
+      {
+        ands_left.push_back( pntk.create_or( !ltfi[k], ltfi_vars_[2 * i][k] ) );
+        ands_left.push_back( pntk.create_or( !ltfi[k], ltfi_vars_[2 * i + 1][k] ) );
+        ands_right.push_back( pntk.create_xnor( ltfi[k], pntk.create_and( ltfi_vars_[2 * i][k], ltfi_vars_[2 * i + 1][k] ) ) );
+      }
+      constraints.push_back( pntk.create_or( !pntk.create_nary_and( ands_left ), pntk.create_nary_and( ands_right ) ) );
+    }
+
+    return constraints;
+  }
 
+  std::vector<std::pair<uint32_t, uint32_t>> const& symmetric_variables()
+  {
+    if ( !symmetric_variables_ )
+    {
+      symmetric_variables_.emplace();
       for ( auto jj = 1u; jj < num_vars_; ++jj )
       {
         for ( auto j = 0u; j < jj; ++j )
         {
           if ( kitty::is_symmetric_in( func_, j, jj ) )
           {
-            break_symmetric_vars( j, jj );
+            symmetric_variables_->emplace_back( j, jj );
           }
         }
       }
+      std::copy( ps_.custom_symmetric_variables.begin(), ps_.custom_symmetric_variables.end(), std::back_inserter( *symmetric_variables_ ) );
 
-      for ( const auto& [j, jj] : ps_.custom_symmetric_variables )
+      if ( ps_.very_verbose )
       {
-        break_symmetric_vars( j, jj );
+        for ( const auto& [j, jj] : *symmetric_variables_ )
+        {
+          fmt::print( "[i] symmetry breaking based on symmetric variables {} and {}\n", j, jj );
+        }
       }
     }
+    return *symmetric_variables_;
+  }
 
-    // ensure to use essential variables and gates
-    if ( ps_.ensure_to_use_gates )
+  std::vector<signal<problem_network_t>> symmetric_variables_clause( uint32_t ii, uint32_t j, uint32_t jj ) const
+  {
+    std::vector<signal<problem_network_t>> clause;
+    clause.push_back( !ltfi_vars_[ii][jj] );
+    for ( auto i = 0u; i <= ii; ++i )
     {
-      const auto num_ands = ltfi_vars_.size() / 2;
-      for ( auto j = 0u; j < num_vars_ + num_ands; ++j )
-      {
-        if ( j < num_vars_ && !kitty::has_var( func_, j ) )
-        {
-          continue;
-        }
-
-        std::vector<signal<problem_network_t>> clause;
-        for ( auto const& ltfi : ltfi_vars_ )
-        {
-          if ( j < ltfi.size() )
-          {
-            clause.push_back( ltfi[j] );
-          }
-        }
-        pntk.add_clause( clause );
-      }
+      clause.push_back( ltfi_vars_[i][j] );
     }
+    return clause;
   }
 
   void add_xor_counter( problem_network_t& pntk )
@@ -590,6 +836,11 @@ private:
   std::vector<std::vector<signal<problem_network_t>>> ltfi_vars_;
   std::vector<std::vector<signal<problem_network_t>>> truth_vars_;
   std::vector<signal<problem_network_t>> xor_counter_;
+  std::vector<uint32_t> cegar_bits_;
+  uint32_t num_pruned_gates_{ 0u };
+  signal<problem_network_t> activation_{};
+  std::optional<std::vector<std::pair<uint32_t, uint32_t>>> symmetric_variables_;
+  std::unique_ptr<problem_network_t> pntk_;
   kitty::dynamic_truth_table func_;
   bool invert_{ false };
   std::optional<uint32_t> heuristic_xor_bound_;
@@ -600,11 +851,18 @@ private:
 
 } // namespace detail
 
+/*! \brief Exact MC synthesis.
+ *
+ * Returns an XAG with the minimum number of AND gates that realizes `func`,
+ * or an empty network (without primary inputs) if synthesis is stopped by
+ * `ps.stop`.
+ */
 template<class Ntk = xag_network, bill::solvers Solver = bill::solvers::glucose_41>
 Ntk exact_mc_synthesis( kitty::dynamic_truth_table const& func, exact_mc_synthesis_params const& ps = {}, exact_mc_synthesis_stats* pst = nullptr )
 {
   exact_mc_synthesis_stats st;
-  const auto xag = detail::exact_mc_synthesis_impl<Ntk, Solver>{ func, 1u, ps, st }.run().front();
+  const auto xags = detail::exact_mc_synthesis_impl<Ntk, Solver>{ func, 1u, ps, st }.run();
+  const auto xag = xags.empty() ? Ntk{} : xags.front();
 
   if ( ps.verbose )
   {
@@ -636,4 +894,189 @@ std::vector<Ntk> exact_mc_synthesis_multiple( kitty::dynamic_truth_table const&
   return xags;
 }
 
+namespace detail
+{
+
+inline std::vector<exact_mc_synthesis_portfolio_entry> default_exact_mc_synthesis_portfolio()
+{
+  std::vector<exact_mc_synthesis_portfolio_entry> configurations;
+
+  configurations.emplace_back();
+
+  configurations.emplace_back();
+  configurations.back().ps.use_cegar = true;
+
+  configurations.emplace_back();
+  configurations.back().ps.break_multi_level_subset_symmetries = false;
+
+  configurations.emplace_back();
+  configurations.back().ps.break_subset_symmetries = false;
+  configurations.back().ps.break_multi_level_subset_symmetries = false;
+
+  configurations.emplace_back();
+  configurations.back().solver = bill::solvers::ghack;
+
+#if defined( BILL_HAS_Z3 )
+  configurations.emplace_back();
+  configurations.back().solver = bill::solvers::z3;
+#endif
+
+  return configurations;
+}
+
+inline bool is_exact_mc_synthesis_portfolio_solver( bill::solvers solver )
+{
+  switch ( solver )
+  {
+  case bill::solvers::glucose_41:
+  case bill::solvers::ghack:
+  case bill::solvers::bsat2:
+#if defined( BILL_HAS_Z3 )
+  case bill::solvers::z3:
+#endif
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* solvers must be checked with `is_exact_mc_synthesis_portfolio_solver`; `ps` and
+   `st` must outlive the returned function, which searches for solutions with a
+   given number of AND gates */
+template<class Ntk>
+std::function<std::vector<Ntk>( uint32_t )> make_exact_mc_synthesis_engine( bill::solvers solver, kitty::dynamic_truth_table const& func, exact_mc_synthesis_params const& ps, exact_mc_synthesis_stats& st )
+{
+  const auto make_engine = [&]( auto impl ) -> std::function<std::vector<Ntk>( uint32_t )> {
+    return [impl]( uint32_t num_ands ) { return impl->run_with( num_ands ); };
+  };
+
+  switch ( solver )
+  {
+  default:
+    throw std::invalid_argument( "unsupported solver in exact MC synthesis portfolio" );
+  case bill::solvers::glucose_41:
+    return make_engine( std::make_shared<exact_mc_synthesis_impl<Ntk, bill::solvers::glucose_41>>( func, 1u, ps, st ) );
+  case bill::solvers::ghack:
+    return make_engine( std::make_shared<exact_mc_synthesis_impl<Ntk, bill::solvers::ghack>>( func, 1u, ps, st ) );
+  case bill::solvers::bsat2:
+    return make_engine( std::make_shared<exact_mc_synthesis_impl<Ntk, bill::solvers::bsat2>>( func, 1u, ps, st ) );
+#if defined( BILL_HAS_Z3 )
+  case bill::solvers::z3:
+    return make_engine( std::make_shared<exact_mc_synthesis_impl<Ntk, bill::solvers::z3>>( func, 1u, ps, st ) );
+#endif
+  }
+}
+
+} // namespace detail
+
+/*! \brief Exact MC synthesis with a parallel portfolio of solvers.
+ *
+ * For each number of AND gates, starting from a lower bound, all
+ * configurations of the portfolio are run on a pool of threads.  The first
+ * configuration that finds a solution or proves that there is none decides
+ * the current number of AND gates, and all other configurations are stopped.
+ * Configurations that hit their conflict limit do not decide, unless all of
+ * them do, in which case the number of AND gates is increased.
+ *
+ * Throws `std::invalid_argument` if a configuration uses a solver that is
+ * not supported (see `bill::solvers`; Z3 requires `BILL_HAS_Z3`).
+ */
+template<class Ntk = xag_network>
+Ntk exact_mc_synthesis_portfolio( kitty::dynamic_truth_table const& func, exact_mc_synthesis_portfolio_params const& ps = {}, exact_mc_synthesis_portfolio_stats* pst = nullptr )
+{
+  exact_mc_synthesis_portfolio_stats st;
+  std::optional<Ntk> xag;
+
+  {
+    stopwatch<> t( st.time_total );
+
+    const auto configurations = ps.configurations.empty() ? detail::default_exact_mc_synthesis_portfolio() : ps.configurations;
+    for ( auto const& configuration : configurations )
+    {
+      if ( !detail::is_exact_mc_synthesis_portfolio_solver( configuration.solver ) )
+      {
+        throw std::invalid_argument( "unsupported solver in exact MC synthesis portfolio" );
+      }
+    }
+    const auto max_threads = ps.num_threads == 0u ? std::max( std::thread::hardware_concurrency(), 1u ) : ps.num_threads;
+    const auto num_threads = std::min<std::size_t>( max_threads, configurations.size() );
+    st.num_decided.resize( configurations.size() );
+
+    /* engines are kept across the numbers of AND gates, for incremental configurations */
+    std::atomic<bool> stop{ false };
+    std::vector<exact_mc_synthesis_params> cps( configurations.size() );
+    std::vector<exact_mc_synthesis_stats> cst( configurations.size() );
+    std::vector<std::function<std::vector<Ntk>( uint32_t )>> engines;
+    for ( auto i = 0u; i < configurations.size(); ++i )
+    {
+      cps[i] = configurations[i].ps;
+      cps[i].stop = &stop;
+      cps[i].verbose = cps[i].very_verbose = cps[i].progress = false;
+      engines.emplace_back( detail::make_exact_mc_synthesis_engine<Ntk>( configurations[i].solver, func, cps[i], cst[i] ) );
+    }
+
+    const auto degree = kitty::polynomial_degree( func );
+    for ( auto num_ands = std::max( ps.min_and_gates, degree == 0u ? degree : degree - 1u ); !xag; ++num_ands )
+    {
+      stop = false;
+      std::mutex mu;
+      uint32_t next{ 0u };
+
+      std::vector<std::thread> threads;
+      for ( auto t = 0u; t < num_threads; ++t )
+      {
+        threads.emplace_back( [&]() {
+          while ( true )
+          {
+            uint32_t i;
+            {
+              std::lock_guard<std::mutex> lock( mu );
+              if ( stop || next == configurations.size() )
+              {
+                return;
+              }
+              i = next++;
+            }
+
+            const auto ntks = engines[i]( num_ands );
+
+            std::lock_guard<std::mutex> lock( mu );
+            if ( stop || ( ntks.empty() && cps[i].conflict_limit != 0u ) )
+            {
+              continue;
+            }
+            if ( !ntks.empty() )
+            {
+              xag = ntks.front();
+            }
+            ++st.num_decided[i];
+            stop = true;
+
+            if ( ps.verbose )
+            {
+              fmt::print( "[i] {} AND gates {} by configuration {}\n", num_ands, ntks.empty() ? "refuted" : "realized", i );
+            }
+          }
+        } );
+      }
+
+      for ( auto& thread : threads )
+      {
+        thread.join();
+      }
+    }
+  }
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+
+  return *xag;
+}
+
 } /* namespace mockturtle */
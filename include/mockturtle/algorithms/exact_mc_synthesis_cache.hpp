@@ -0,0 +1,326 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file exact_mc_synthesis_cache.hpp
+  \brief Cache for exact MC synthesis based on affine classes
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/spectral.hpp>
+
+#include "../networks/xag.hpp"
+#include "../utils/index_list.hpp"
+#include "../utils/stopwatch.hpp"
+#include "cleanup.hpp"
+#include "equivalence_classes.hpp"
+#include "exact_mc_synthesis.hpp"
+
+namespace mockturtle
+{
+
+struct exact_mc_synthesis_cache_stats
+{
+  /*! \brief Number of cache hits. */
+  uint32_t cache_hits{};
+
+  /*! \brief Number of cache misses. */
+  uint32_t cache_misses{};
+
+  /*! \brief Time for spectral canonization. */
+  stopwatch<>::duration time_classify{};
+
+  /*! \brief Time for synthesis on cache misses. */
+  stopwatch<>::duration time_synthesis{};
+
+  /*! \brief Prints report. */
+  void report() const
+  {
+    fmt::print( "[i] cache hits      = {}\n", cache_hits );
+    fmt::print( "[i] cache misses    = {}\n", cache_misses );
+    fmt::print( "[i] classify time   = {:>5.2f} secs\n", to_seconds( time_classify ) );
+    fmt::print( "[i] synthesis time  = {:>5.2f} secs\n", to_seconds( time_synthesis ) );
+  }
+};
+
+/*! \brief Cache for exact MC synthesis
+ *
+ * Functions are classified into affine classes using
+ * `kitty::hybrid_exact_spectral_canonization`.  Only the representative of
+ * each class is synthesized; the network for a function is obtained from the
+ * representative's network by applying the spectral transformations, which
+ * does not change the number of AND gates.
+ *
+ * The cache can be stored in a binary file, which consists of one record per
+ * representative: the number of variables (`uint32_t`), the truth table
+ * (`uint64_t`), the length of the index list (`uint32_t`), and the index list
+ * in the same format as in `detail::minmc_xags` (`xag_index_list`).
+ *
+ * Functions with more than 6 variables are synthesized directly.
+ *
+ * If a cache file is given, it is loaded on construction and saved on
+ * destruction, but only if new representatives were synthesized.  The cache
+ * can be moved but not copied, such that the file is written at most once.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, "mc_cache.bin" );
+      const auto xag = cache( func );
+   \endverbatim
+ */
+template<class Ntk = xag_network>
+class exact_mc_synthesis_cache
+{
+public:
+  using synthesis_fn_t = std::function<Ntk( kitty::dynamic_truth_table const& )>;
+
+  /*! \brief Constructor using `exact_mc_synthesis` on cache misses. */
+  explicit exact_mc_synthesis_cache( exact_mc_synthesis_params const& ps = {}, std::string const& cache_filename = {} )
+      : exact_mc_synthesis_cache( [ps]( kitty::dynamic_truth_table const& func ) { return exact_mc_synthesis<Ntk>( func, ps ); }, cache_filename )
+  {
+  }
+
+  /*! \brief Constructor using a custom synthesis function on cache misses. */
+  explicit exact_mc_synthesis_cache( synthesis_fn_t const& synthesis_fn, std::string const& cache_filename = {} )
+      : synthesis_fn_( synthesis_fn ),
+        cache_filename_( cache_filename )
+  {
+    if ( !cache_filename_.empty() )
+    {
+      load( cache_filename_ );
+    }
+  }
+
+  exact_mc_synthesis_cache( exact_mc_synthesis_cache const& ) = delete;
+  exact_mc_synthesis_cache& operator=( exact_mc_synthesis_cache const& ) = delete;
+
+  exact_mc_synthesis_cache( exact_mc_synthesis_cache&& other ) noexcept
+      : synthesis_fn_( std::move( other.synthesis_fn_ ) ),
+        cache_filename_( std::move( other.cache_filename_ ) ),
+        db_( std::move( other.db_ ) ),
+        st_( other.st_ ),
+        dirty_( std::exchange( other.dirty_, false ) )
+  {
+  }
+
+  exact_mc_synthesis_cache& operator=( exact_mc_synthesis_cache&& other )
+  {
+    if ( this != &other )
+    {
+      save_if_dirty();
+      synthesis_fn_ = std::move( other.synthesis_fn_ );
+      cache_filename_ = std::move( other.cache_filename_ );
+      db_ = std::move( other.db_ );
+      st_ = other.st_;
+      dirty_ = std::exchange( other.dirty_, false );
+    }
+    return *this;
+  }
+
+  ~exact_mc_synthesis_cache()
+  {
+    save_if_dirty();
+  }
+
+  Ntk operator()( kitty::dynamic_truth_table const& func )
+  {
+    const auto num_vars = func.num_vars();
+    if ( num_vars > 6u )
+    {
+      ++st_.cache_misses;
+      stopwatch<> t( st_.time_synthesis );
+      return synthesis_fn_( func );
+    }
+
+    std::vector<kitty::detail::spectral_operation> trans;
+    uint64_t repr;
+    {
+      stopwatch<> t( st_.time_classify );
+      repr = *kitty::hybrid_exact_spectral_canonization( func, [&]( auto const& ops ) { trans = ops; } ).cbegin();
+    }
+
+    auto it = db_[num_vars].find( repr );
+    if ( it == db_[num_vars].end() )
+    {
+      ++st_.cache_misses;
+
+      kitty::dynamic_truth_table tt_repr( num_vars );
+      kitty::create_from_words( tt_repr, &repr, &repr + 1 );
+
+      xag_index_list il;
+      {
+        stopwatch<> t( st_.time_synthesis );
+        encode( il, cleanup_dangling( synthesis_fn_( tt_repr ) ) );
+      }
+      it = db_[num_vars].emplace( repr, il.raw() ).first;
+      dirty_ = true;
+    }
+    else
+    {
+      ++st_.cache_hits;
+    }
+
+    Ntk ntk;
+    std::vector<signal<Ntk>> pis( num_vars );
+    std::generate( pis.begin(), pis.end(), [&]() { return ntk.create_pi(); } );
+
+    const auto f = apply_spectral_transformations( ntk, trans, pis, [&]( Ntk& ntk, std::vector<signal<Ntk>> const& leaves ) {
+      xag_index_list il{ it->second };
+      std::vector<signal<Ntk>> pos;
+      insert( ntk, std::begin( leaves ), std::begin( leaves ) + il.num_pis(), il,
+              [&]( signal<Ntk> const& f ) {
+                pos.push_back( f );
+              } );
+      assert( pos.size() == 1u );
+      return pos[0u];
+    } );
+    ntk.create_po( f );
+
+    return ntk;
+  }
+
+  /*! \brief Loads representatives from a binary file (if it exists).
+   *
+   * A corrupt or truncated file is rejected as a whole.
+   */
+  void load( std::string const& filename )
+  {
+    std::ifstream in( filename, std::ifstream::in | std::ifstream::binary | std::ifstream::ate );
+    if ( !in.is_open() )
+    {
+      return;
+    }
+    uint64_t remaining = static_cast<uint64_t>( in.tellg() );
+    in.seekg( 0 );
+
+    constexpr uint64_t record_header_size = sizeof( uint32_t ) + sizeof( uint64_t ) + sizeof( uint32_t );
+    auto db = db_;
+    uint32_t num_vars, size;
+    uint64_t word;
+    while ( remaining != 0u )
+    {
+      if ( remaining < record_header_size )
+      {
+        fmt::print( "[w] corrupt exact MC synthesis cache {}\n", filename );
+        return;
+      }
+      in.read( reinterpret_cast<char*>( &num_vars ), sizeof( num_vars ) );
+      in.read( reinterpret_cast<char*>( &word ), sizeof( word ) );
+      in.read( reinterpret_cast<char*>( &size ), sizeof( size ) );
+      remaining -= record_header_size;
+
+      /* check the size before allocating the index list */
+      if ( !in || num_vars >= db.size() || size == 0u || size > remaining / sizeof( uint32_t ) )
+      {
+        fmt::print( "[w] corrupt exact MC synthesis cache {}\n", filename );
+        return;
+      }
+      std::vector<uint32_t> index_list( size );
+      in.read( reinterpret_cast<char*>( index_list.data() ), sizeof( uint32_t ) * size );
+      remaining -= sizeof( uint32_t ) * size;
+      if ( !in )
+      {
+        fmt::print( "[w] corrupt exact MC synthesis cache {}\n", filename );
+        return;
+      }
+      db[num_vars][word] = index_list;
+    }
+    db_ = std::move( db );
+  }
+
+  /*! \brief Saves all representatives to a binary file. */
+  void save( std::string const& filename ) const
+  {
+    std::ofstream out( filename, std::ofstream::out | std::ofstream::binary );
+    for ( auto num_vars = 0u; num_vars < db_.size(); ++num_vars )
+    {
+      for ( auto const& [word, index_list] : db_[num_vars] )
+      {
+        const auto size = static_cast<uint32_t>( index_list.size() );
+        out.write( reinterpret_cast<char const*>( &num_vars ), sizeof( num_vars ) );
+        out.write( reinterpret_cast<char const*>( &word ), sizeof( word ) );
+        out.write( reinterpret_cast<char const*>( &size ), sizeof( size ) );
+        out.write( reinterpret_cast<char const*>( index_list.data() ), sizeof( uint32_t ) * size );
+      }
+    }
+  }
+
+  /*! \brief Number of cached representatives. */
+  uint32_t size() const
+  {
+    uint32_t total{};
+    for ( auto const& m : db_ )
+    {
+      total += static_cast<uint32_t>( m.size() );
+    }
+    return total;
+  }
+
+  exact_mc_synthesis_cache_stats const& stats() const
+  {
+    return st_;
+  }
+
+  void report() const
+  {
+    fmt::print( "[i] cached classes  = {}\n", size() );
+    st_.report();
+  }
+
+private:
+  void save_if_dirty()
+  {
+    if ( dirty_ && !cache_filename_.empty() )
+    {
+      save( cache_filename_ );
+      dirty_ = false;
+    }
+  }
+
+private:
+  synthesis_fn_t synthesis_fn_;
+  std::string cache_filename_;
+  std::vector<std::unordered_map<uint64_t, std::vector<uint32_t>>> db_{ 7u };
+  exact_mc_synthesis_cache_stats st_;
+  bool dirty_{ false };
+};
+
+} /* namespace mockturtle */
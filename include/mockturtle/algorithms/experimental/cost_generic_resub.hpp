@@ -117,6 +117,9 @@ struct costfn_windowing_stats
   /*! \brief Accumulated runtime for don't care computation. */
   stopwatch<>::duration time_dont_care{ 0 };
 
+  /*! \brief Accumulated runtime for cost evaluation of windows. */
+  stopwatch<>::duration time_cost{ 0 };
+
   /*! \brief Total number of leaves. */
   uint64_t num_leaves{ 0u };
 
@@ -142,6 +145,7 @@ struct costfn_windowing_stats
     fmt::print( "      Divs      : {:>5.2f} secs\n", to_seconds( time_divs ) );
     fmt::print( "      Simulation: {:>5.2f} secs\n", to_seconds( time_sim ) );
     fmt::print( "      Dont cares: {:>5.2f} secs\n", to_seconds( time_dont_care ) );
+    fmt::print( "      Cost eval : {:>5.2f} secs\n", to_seconds( time_cost ) );
     // clang-format on
   }
 };
@@ -250,8 +254,10 @@ public:
       }
     } );
 
-    /* compute cost */
-    win.max_cost = ntk.get_cost( n, win.divs );
+    /* compute cost (contexts of the divisors are kept up to date by the cost view) */
+    win.max_cost = call_with_stopwatch( st.time_cost, [&]() {
+      return ntk.get_cost( n, win.divs );
+    } );
 
     st.num_windows++;
     st.num_leaves += leaves.size();
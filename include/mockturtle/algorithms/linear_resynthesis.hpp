@@ -35,20 +35,32 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <random>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "../algorithms/cleanup.hpp"
 #include "../algorithms/cnf.hpp"
 #include "../algorithms/simulation.hpp"
 #include "../networks/xag.hpp"
 #include "../traits.hpp"
+#include "../utils/bit_utils.hpp"
 #include "../utils/stopwatch.hpp"
 #include "../views/cnf_view.hpp"
 
 #include <fmt/format.h>
+#include <parallel_hashmap/phmap.h>
 
 namespace mockturtle
 {
@@ -92,6 +104,29 @@ private:
   uint32_t num_inputs_;
 };
 
+class linear_bitset_simulator
+{
+public:
+  linear_bitset_simulator( uint32_t num_inputs ) : num_words_( ( num_inputs + 63u ) >> 6 ) {}
+
+  std::vector<uint64_t> compute_constant( bool ) const { return std::vector<uint64_t>( num_words_, 0u ); }
+  std::vector<uint64_t> compute_pi( uint32_t index ) const
+  {
+    std::vector<uint64_t> row( num_words_, 0u );
+    row[index >> 6] = uint64_t( 1 ) << ( index & 63u );
+    return row;
+  }
+  std::vector<uint64_t> compute_not( std::vector<uint64_t> const& value ) const
+  {
+    assert( false && "No NOTs in linear forms allowed" );
+    std::abort();
+    return value;
+  }
+
+private:
+  uint32_t num_words_;
+};
+
 class linear_xag : public xag_network
 {
 public:
@@ -180,6 +215,37 @@ public:
       return result;
     }
   }
+
+  template<typename Iterator>
+  iterates_over_t<Iterator, std::vector<uint64_t>>
+  compute( node const& n, Iterator begin, Iterator end ) const
+  {
+    (void)end;
+
+    assert( n != 0 && !is_pi( n ) );
+
+    auto const& c1 = _storage->nodes[n].children[0];
+    auto const& c2 = _storage->nodes[n].children[1];
+
+    auto const& set1 = *begin++;
+    auto const& set2 = *begin++;
+
+    if ( c1.index < c2.index )
+    {
+      assert( false );
+      std::abort();
+      return {};
+    }
+    else
+    {
+      std::vector<uint64_t> result( set1.size() );
+      for ( auto i = 0u; i < result.size(); ++i )
+      {
+        result[i] = set1[i] ^ set2[i];
+      }
+      return result;
+    }
+  }
 };
 
 struct pair_hash
@@ -374,6 +440,548 @@ Ntk linear_resynthesis_paar( Ntk const& xag )
   return detail::linear_resynthesis_paar_impl<Ntk>( xag ).run();
 }
 
+/*! \brief Pair selection of `linear_resynthesis_multistart`. */
+enum class linear_resynthesis_selection
+{
+  /*! \brief Most frequent pair (Paar). */
+  paar,
+
+  /*! \brief Most frequent pair, ties are broken by the distance norm of Boyar and Peralta. */
+  boyar_peralta
+};
+
+struct linear_resynthesis_multistart_params
+{
+  /*! \brief Pair selection. */
+  linear_resynthesis_selection selection{ linear_resynthesis_selection::boyar_peralta };
+
+  /*! \brief Number of restarts, all but the first one break ties randomly. */
+  uint32_t num_restarts{ 1u };
+
+  /*! \brief Number of threads which run restarts (0 means hardware concurrency). */
+  uint32_t num_threads{ 1u };
+
+  /*! \brief Random seed, restart `i` uses `seed + i`. */
+  std::default_random_engine::result_type seed{ 1u };
+
+  /*! \brief Be verbose. */
+  bool verbose{ false };
+};
+
+struct linear_resynthesis_multistart_stats
+{
+  /*! \brief Total time. */
+  stopwatch<>::duration time_total{ 0 };
+
+  /*! \brief Number of XOR gates of the best restart. */
+  uint32_t num_xors{ 0u };
+
+  /*! \brief Index of the best restart. */
+  uint32_t best_restart{ 0u };
+
+  /*! \brief Prints report. */
+  void report() const
+  {
+    fmt::print( "[i] total time   = {:>5.2f} secs\n", to_seconds( time_total ) );
+    fmt::print( "[i] XOR gates    = {} (restart {})\n", num_xors, best_restart );
+  }
+};
+
+namespace detail
+{
+
+/* sequence of XOR steps over the inputs (signals `0` to `num_inputs - 1`) and
+ * previous steps (signal `num_inputs + i` for step `i`) */
+struct linear_program
+{
+  static constexpr uint32_t constant = std::numeric_limits<uint32_t>::max();
+
+  std::vector<std::pair<uint32_t, uint32_t>> steps;
+
+  /* signal of every output, or `constant` */
+  std::vector<uint32_t> outputs;
+};
+
+/* Greedy pair elimination on a bit-packed matrix
+ *
+ * Every signal owns a slot with its column, i.e., the bit-packed set of
+ * outputs whose equation still contains it.  The number of outputs which
+ * share a pair of signals is the popcount of the AND of their columns.  Only
+ * pairs which are shared by at least two outputs are stored, together with
+ * an upper bound on the maximum of every slot, and only the slots of the two
+ * replaced signals and of the new one are recounted after each step.  Slots
+ * of signals which no longer occur are reused.
+ */
+class linear_pair_elimination
+{
+public:
+  linear_pair_elimination( std::vector<std::vector<uint64_t>> const& rows, uint32_t num_inputs, linear_resynthesis_selection selection, bool randomize, std::default_random_engine::result_type seed )
+      : num_words_( std::max<uint32_t>( 1u, ( static_cast<uint32_t>( rows.size() ) + 63u ) >> 6 ) ),
+        num_inputs_( num_inputs ),
+        num_slots_( num_inputs ),
+        columns_( static_cast<std::size_t>( num_inputs ) * num_words_, 0u ),
+        col_size_( num_inputs, 0u ),
+        best_( num_inputs, 0u ),
+        dirty_( num_inputs, false ),
+        signal_( num_inputs ),
+        shared_( num_inputs ),
+        row_weight_( rows.size(), 0u ),
+        selection_( selection ),
+        randomize_( randomize ),
+        rng_( seed )
+  {
+    std::iota( signal_.begin(), signal_.end(), 0u );
+    for ( auto r = 0u; r < rows.size(); ++r )
+    {
+      for ( auto w = 0u; w < rows[r].size(); ++w )
+      {
+        for ( auto word = rows[r][w]; word; word &= word - 1u )
+        {
+          const auto i = ( w << 6 ) + ctz64( word );
+          column( i )[r >> 6] |= uint64_t( 1 ) << ( r & 63u );
+          ++row_weight_[r];
+        }
+      }
+    }
+
+    for ( auto a = 0u; a < num_slots_; ++a )
+    {
+      col_size_[a] = popcount_and( a, a );
+      if ( col_size_[a] == 0u )
+      {
+        free_slots_.push_back( a );
+      }
+      if ( col_size_[a] < 2u )
+      {
+        continue;
+      }
+      for ( auto b = 0u; b < a; ++b )
+      {
+        if ( col_size_[b] < 2u )
+        {
+          continue;
+        }
+        if ( const auto v = popcount_and( a, b ); v >= 2u )
+        {
+          shared_[a][b] = shared_[b][a] = v;
+          best_[a] = std::max( best_[a], v );
+          best_[b] = std::max( best_[b], v );
+        }
+      }
+    }
+  }
+
+  linear_program run()
+  {
+    while ( const auto p = select() )
+    {
+      replace( p->first, p->second );
+    }
+
+    linear_program program;
+    program.outputs = chain_remaining_rows();
+    program.steps = std::move( steps_ );
+    return program;
+  }
+
+private:
+  uint64_t* column( uint32_t s )
+  {
+    return &columns_[static_cast<std::size_t>( s ) * num_words_];
+  }
+
+  uint64_t const* column( uint32_t s ) const
+  {
+    return &columns_[static_cast<std::size_t>( s ) * num_words_];
+  }
+
+  uint32_t popcount_and( uint32_t a, uint32_t b ) const
+  {
+    auto const* ca = column( a );
+    auto const* cb = column( b );
+    uint32_t count{ 0u };
+    for ( auto w = 0u; w < num_words_; ++w )
+    {
+      count += popcount64( ca[w] & cb[w] );
+    }
+    return count;
+  }
+
+  uint32_t allocate_slot()
+  {
+    if ( !free_slots_.empty() )
+    {
+      const auto s = free_slots_.back();
+      free_slots_.pop_back();
+      return s;
+    }
+    columns_.resize( columns_.size() + num_words_, 0u );
+    col_size_.push_back( 0u );
+    best_.push_back( 0u );
+    dirty_.push_back( false );
+    signal_.push_back( 0u );
+    shared_.emplace_back();
+    return num_slots_++;
+  }
+
+  /* sum of the weights of all rows which contain `a` and `b` */
+  uint64_t distance_score( uint32_t a, uint32_t b ) const
+  {
+    auto const* ca = column( a );
+    auto const* cb = column( b );
+    uint64_t score{ 0u };
+    for ( auto w = 0u; w < num_words_; ++w )
+    {
+      for ( auto word = ca[w] & cb[w]; word; word &= word - 1u )
+      {
+        score += row_weight_[( w << 6 ) + ctz64( word )];
+      }
+    }
+    return score;
+  }
+
+  std::optional<std::pair<uint32_t, uint32_t>> select()
+  {
+    uint32_t max_count{ 0u };
+    for ( auto s = 0u; s < num_slots_; ++s )
+    {
+      if ( dirty_[s] )
+      {
+        best_[s] = 0u;
+        for ( auto const& [_, v] : shared_[s] )
+        {
+          best_[s] = std::max( best_[s], v );
+        }
+        dirty_[s] = false;
+      }
+      max_count = std::max( max_count, best_[s] );
+    }
+    if ( max_count < 2u )
+    {
+      /* no pair is shared anymore, see `chain_remaining_rows` */
+      return std::nullopt;
+    }
+
+    /* The distance of an output is its weight minus one.  Among the most
+     * frequent pairs, Boyar-Peralta prefers the one after which the vector of
+     * distances has the largest Euclidean norm, i.e., the one which shortens
+     * the outputs with the smallest total weight. */
+    std::pair<uint32_t, uint32_t> pair;
+    uint64_t best_score{ std::numeric_limits<uint64_t>::max() };
+    uint32_t num_ties{ 0u };
+    for ( auto a = 0u; a < num_slots_; ++a )
+    {
+      if ( best_[a] != max_count )
+      {
+        continue;
+      }
+      for ( auto const& [b, v] : shared_[a] )
+      {
+        if ( b < a || v != max_count )
+        {
+          continue;
+        }
+        if ( selection_ == linear_resynthesis_selection::paar && !randomize_ )
+        {
+          return std::make_pair( a, b );
+        }
+
+        const auto score = selection_ == linear_resynthesis_selection::boyar_peralta ? distance_score( a, b ) : 0u;
+        if ( score < best_score )
+        {
+          best_score = score;
+          pair = { a, b };
+          num_ties = 1u;
+        }
+        else if ( score == best_score && randomize_ && std::uniform_int_distribution<uint32_t>( 0u, num_ties++ )( rng_ ) == 0u )
+        {
+          pair = { a, b };
+        }
+      }
+    }
+    return pair;
+  }
+
+  void replace( uint32_t a, uint32_t b )
+  {
+    const auto c = allocate_slot();
+    signal_[c] = num_inputs_ + static_cast<uint32_t>( steps_.size() );
+    steps_.emplace_back( signal_[a], signal_[b] );
+
+    auto* ca = column( a );
+    auto* cb = column( b );
+    auto* cc = column( c );
+    for ( auto w = 0u; w < num_words_; ++w )
+    {
+      cc[w] = ca[w] & cb[w];
+      ca[w] &= ~cc[w];
+      cb[w] &= ~cc[w];
+      for ( auto word = cc[w]; word; word &= word - 1u )
+      {
+        --row_weight_[( w << 6 ) + ctz64( word )];
+      }
+    }
+
+    update_slot( a );
+    update_slot( b );
+    update_slot( c );
+  }
+
+  void update_slot( uint32_t s )
+  {
+    auto& row = shared_[s];
+    col_size_[s] = popcount_and( s, s );
+    if ( col_size_[s] < 2u )
+    {
+      /* the slot cannot share pairs anymore */
+      for ( auto const& [x, v] : row )
+      {
+        dirty_[x] = dirty_[x] || v == best_[x];
+        shared_[x].erase( s );
+      }
+      row.clear();
+      best_[s] = 0u;
+      dirty_[s] = false;
+      if ( col_size_[s] == 0u )
+      {
+        free_slots_.push_back( s );
+      }
+      return;
+    }
+
+    uint32_t best{ 0u };
+    for ( auto x = 0u; x < num_slots_; ++x )
+    {
+      if ( x == s || col_size_[x] < 2u )
+      {
+        continue;
+      }
+      const auto v = popcount_and( s, x );
+      const auto it = row.find( x );
+      const auto old = it == row.end() ? 0u : it->second;
+      if ( v >= 2u )
+      {
+        row[x] = shared_[x][s] = v;
+        best_[x] = std::max( best_[x], v );
+        best = std::max( best, v );
+      }
+      else if ( old != 0u )
+      {
+        row.erase( it );
+        shared_[x].erase( s );
+      }
+      if ( v < old && old == best_[x] )
+      {
+        dirty_[x] = true;
+      }
+    }
+    best_[s] = best;
+    dirty_[s] = false;
+  }
+
+  /* Once no pair is shared by two rows, every remaining row with weight
+   * `k` needs `k - 1` XOR gates independently of the order, and so these
+   * gates are chained without counting any pairs.  Returns the signal of
+   * every row. */
+  std::vector<uint32_t> chain_remaining_rows()
+  {
+    std::vector<uint32_t> outputs( row_weight_.size(), linear_program::constant );
+    for ( auto s = 0u; s < num_slots_; ++s )
+    {
+      if ( col_size_[s] == 0u )
+      {
+        continue;
+      }
+      auto const* col = column( s );
+      for ( auto w = 0u; w < num_words_; ++w )
+      {
+        for ( auto word = col[w]; word; word &= word - 1u )
+        {
+          auto& output = outputs[( w << 6 ) + ctz64( word )];
+          if ( output == linear_program::constant )
+          {
+            output = signal_[s];
+          }
+          else
+          {
+            steps_.emplace_back( output, signal_[s] );
+            output = num_inputs_ + static_cast<uint32_t>( steps_.size() ) - 1u;
+          }
+        }
+      }
+    }
+    return outputs;
+  }
+
+private:
+  uint32_t num_words_;
+  uint32_t num_inputs_;
+  uint32_t num_slots_;
+
+  std::vector<uint64_t> columns_;
+  std::vector<uint32_t> col_size_;
+  std::vector<uint32_t> best_;
+  std::vector<bool> dirty_;
+  std::vector<uint32_t> signal_;
+  std::vector<phmap::flat_hash_map<uint32_t, uint32_t>> shared_;
+  std::vector<uint32_t> free_slots_;
+  std::vector<uint32_t> row_weight_;
+  std::vector<std::pair<uint32_t, uint32_t>> steps_;
+
+  linear_resynthesis_selection selection_;
+  bool randomize_;
+  std::default_random_engine rng_;
+};
+
+template<class Ntk>
+struct linear_resynthesis_multistart_impl
+{
+public:
+  linear_resynthesis_multistart_impl( Ntk const& xag, linear_resynthesis_multistart_params const& ps, linear_resynthesis_multistart_stats& st )
+      : xag( xag ), ps( ps ), st( st )
+  {
+  }
+
+  Ntk run()
+  {
+    stopwatch t( st.time_total );
+
+    const auto values = simulate_nodes<std::vector<uint64_t>>( linear_xag{ xag }, linear_bitset_simulator{ xag.num_pis() } );
+    std::vector<std::vector<uint64_t>> rows;
+    xag.foreach_po( [&]( auto const& f ) {
+      rows.push_back( values[f] );
+    } );
+
+    const auto num_restarts = std::max( 1u, ps.num_restarts );
+    const auto num_threads = std::min( num_restarts, std::max( 1u, ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency() ) );
+
+    std::atomic<uint32_t> next{ 0u };
+    std::mutex mutex;
+    linear_program best;
+    uint32_t best_restart{ num_restarts };
+
+    const auto worker = [&]() {
+      for ( auto i = next++; i < num_restarts; i = next++ )
+      {
+        auto program = linear_pair_elimination( rows, xag.num_pis(), ps.selection, i > 0u, ps.seed + i ).run();
+
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( ps.verbose )
+        {
+          fmt::print( "[i] restart {:>4}: {} XOR gates\n", i, program.steps.size() );
+        }
+        if ( best_restart == num_restarts || program.steps.size() < best.steps.size() || ( program.steps.size() == best.steps.size() && i < best_restart ) )
+        {
+          best = std::move( program );
+          best_restart = i;
+        }
+      }
+    };
+
+    if ( num_threads == 1u )
+    {
+      worker();
+    }
+    else
+    {
+      std::vector<std::thread> threads;
+      for ( auto i = 0u; i < num_threads; ++i )
+      {
+        threads.emplace_back( worker );
+      }
+      for ( auto& thread : threads )
+      {
+        thread.join();
+      }
+    }
+
+    Ntk dest;
+    std::vector<signal<Ntk>> signals;
+    xag.foreach_pi( [&]( auto const& ) {
+      signals.push_back( dest.create_pi() );
+    } );
+    for ( auto const& [a, b] : best.steps )
+    {
+      signals.push_back( dest.create_xor( signals[a], signals[b] ) );
+    }
+    xag.foreach_po( [&]( auto const& f, auto i ) {
+      if ( best.outputs[i] == linear_program::constant )
+      {
+        dest.create_po( dest.get_constant( xag.is_complemented( f ) ) );
+      }
+      else
+      {
+        dest.create_po( signals[best.outputs[i]] ^ xag.is_complemented( f ) );
+      }
+    } );
+
+    st.num_xors = dest.num_gates();
+    st.best_restart = best_restart;
+    return dest;
+  }
+
+private:
+  Ntk const& xag;
+  linear_resynthesis_multistart_params const& ps;
+  linear_resynthesis_multistart_stats& st;
+};
+
+} // namespace detail
+
+/*! \brief Linear circuit resynthesis with restarts
+ *
+ * This algorithm works on an XAG that is only composed of XOR gates.  Like
+ * `linear_resynthesis_paar`, it greedily substitutes the most frequent pair
+ * of variables in the linear output equations by a new XOR gate, but it keeps
+ * the equations as bit-packed columns and counts pair occurrences with
+ * word-wise popcounts, such that it scales to linear layers with hundreds of
+ * inputs and outputs.
+ *
+ * With `boyar_peralta` selection, ties between the most frequent pairs are
+ * broken by the distance criterion of Boyar and Peralta, restricted to
+ * cancellation-free distances.  The first restart breaks the remaining ties
+ * deterministically, all further restarts break them randomly, and the
+ * circuit with the fewest XOR gates is returned.  Restarts can run on several
+ * threads; the result only depends on the seed and the number of restarts.
+ *
+ * The function can be passed as `linear_resyn` to
+ * `linear_resynthesis_optimization`.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      linear_resynthesis_multistart_params ps;
+      ps.num_restarts = 64u;
+      ps.num_threads = 8u;
+      const auto optimized = linear_resynthesis_optimization( xag, [&]( xag_network const& linear ) {
+        return linear_resynthesis_multistart( linear, ps );
+      } );
+   \endverbatim
+ *
+ * Reference: [J. Boyar and R. Peralta, SEA (2010), page 178-189]
+ */
+template<typename Ntk>
+Ntk linear_resynthesis_multistart( Ntk const& xag, linear_resynthesis_multistart_params const& ps = {}, linear_resynthesis_multistart_stats* pst = nullptr )
+{
+  static_assert( std::is_same_v<typename Ntk::base_type, xag_network>, "Ntk is not XAG-like" );
+
+  linear_resynthesis_multistart_stats st;
+  const auto dest = detail::linear_resynthesis_multistart_impl<Ntk>( xag, ps, st ).run();
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return dest;
+}
+
 struct exact_linear_synthesis_params
 {
   /*! \brief Upper bound on number of XOR gates. If used, best solution is found decreasing */
@@ -1005,4 +1613,453 @@ std::optional<Ntk> exact_linear_resynthesis( Ntk const& ntk, exact_linear_synthe
   return exact_linear_synthesis<Ntk, Solver>( linear_matrix, ps, pst );
 }
 
+struct windowed_exact_linear_resynthesis_params
+{
+  /*! \brief Maximum number of outputs (rows) of a window. */
+  uint32_t max_rows{ 6u };
+
+  /*! \brief Maximum number of leaves (columns) of a window, at most 64. */
+  uint32_t max_columns{ 6u };
+
+  /*! \brief Conflict limit for each SAT call (0 = no limit). */
+  int conflict_limit{ 10000 };
+
+  /*! \brief Maximum number of rounds (0 = until fixed point). */
+  uint32_t max_rounds{ 0u };
+
+  /*! \brief Number of threads which resynthesize windows (0 means hardware concurrency). */
+  uint32_t num_threads{ 1u };
+
+  /*! \brief Be verbose. */
+  bool verbose{ false };
+};
+
+struct windowed_exact_linear_resynthesis_stats
+{
+  /*! \brief Total time. */
+  stopwatch<>::duration time_total{ 0 };
+
+  /*! \brief Time for SAT solving (accumulated over all threads). */
+  stopwatch<>::duration time_solving{ 0 };
+
+  /*! \brief Number of rounds. */
+  uint32_t num_rounds{ 0u };
+
+  /*! \brief Number of resynthesized windows. */
+  uint32_t num_windows{ 0u };
+
+  /*! \brief Number of windows with fewer XOR gates after resynthesis. */
+  uint32_t num_improved{ 0u };
+
+  /*! \brief Prints report. */
+  void report() const
+  {
+    fmt::print( "[i] total time   = {:>5.2f} secs\n", to_seconds( time_total ) );
+    fmt::print( "[i] solving time = {:>5.2f} secs\n", to_seconds( time_solving ) );
+    fmt::print( "[i] rounds = {}, windows = {}, improved = {}\n", num_rounds, num_windows, num_improved );
+  }
+};
+
+namespace detail
+{
+
+template<class Ntk>
+struct linear_window
+{
+  /* XOR gates in topological order */
+  std::vector<node<Ntk>> gates;
+  std::vector<node<Ntk>> leaves;
+  std::vector<node<Ntk>> outputs;
+
+  /* rows over the leaves, one for each output */
+  std::vector<std::vector<bool>> matrix;
+
+  /* leaves outside of the transitive fanin of each output */
+  std::vector<std::vector<uint32_t>> ignore_inputs;
+
+  std::optional<Ntk> solution;
+};
+
+template<class Ntk, bill::solvers Solver>
+struct windowed_exact_linear_resynthesis_impl
+{
+public:
+  windowed_exact_linear_resynthesis_impl( Ntk const& ntk, windowed_exact_linear_resynthesis_params const& ps, windowed_exact_linear_resynthesis_stats& st )
+      : ntk_( ntk ), ps( ps ), st( st )
+  {
+  }
+
+  Ntk run()
+  {
+    stopwatch t( st.time_total );
+
+    auto ntk = cleanup_dangling( ntk_ );
+
+    /* windows are grown from the outputs in even rounds and from the inputs
+     * in odd rounds, such that they overlap with the windows of the previous
+     * round; a fixed point is reached after two rounds without improvement */
+    auto rounds_without_improvement = 0u;
+    for ( auto round = 0u; ( ps.max_rounds == 0u || round < ps.max_rounds ) && rounds_without_improvement < 2u; ++round )
+    {
+      ++st.num_rounds;
+
+      auto windows = collect_windows( ntk, round % 2u == 1u );
+      solve_windows( windows );
+
+      const auto num_improved = std::count_if( windows.begin(), windows.end(), [&]( auto const& w ) { return w.solution.has_value(); } );
+      st.num_windows += static_cast<uint32_t>( windows.size() );
+      st.num_improved += static_cast<uint32_t>( num_improved );
+      if ( num_improved == 0 )
+      {
+        ++rounds_without_improvement;
+        continue;
+      }
+      rounds_without_improvement = 0u;
+
+      ntk = cleanup_dangling( rebuild( ntk, windows ) );
+      if ( ps.verbose )
+      {
+        fmt::print( "[i] round {:>3}: {} windows, {} improved, {} gates\n", round, windows.size(), num_improved, ntk.num_gates() );
+      }
+    }
+
+    return ntk;
+  }
+
+private:
+  bool is_window_gate( Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    if ( !ntk.is_xor( n ) )
+    {
+      return false;
+    }
+    bool complemented{ false };
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      complemented = complemented || ntk.is_complemented( f );
+    } );
+    return !complemented;
+  }
+
+  std::vector<linear_window<Ntk>> collect_windows( Ntk const& ntk, bool from_inputs )
+  {
+    std::vector<node<Ntk>> roots;
+    ntk.foreach_gate( [&]( auto const& n ) {
+      roots.push_back( n );
+    } );
+    if ( !from_inputs )
+    {
+      std::reverse( roots.begin(), roots.end() );
+    }
+
+    node_map<std::vector<node<Ntk>>, Ntk> fanouts( ntk );
+    ntk.foreach_gate( [&]( auto const& n ) {
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        fanouts[f].push_back( n );
+      } );
+    } );
+
+    std::vector<linear_window<Ntk>> windows;
+    node_map<bool, Ntk> used( ntk, false );
+    for ( auto const& root : roots )
+    {
+      if ( used[root] || !is_window_gate( ntk, root ) )
+      {
+        continue;
+      }
+      if ( auto window = grow_window( ntk, root, fanouts, used ) )
+      {
+        windows.push_back( std::move( *window ) );
+      }
+    }
+    return windows;
+  }
+
+  /* grows a window from its root by adding fanins and fanouts of its gates
+   * and leaves, returns no window, if the window cannot be improved */
+  std::optional<linear_window<Ntk>> grow_window( Ntk const& ntk, node<Ntk> const& root, node_map<std::vector<node<Ntk>>, Ntk> const& fanouts, node_map<bool, Ntk>& used )
+  {
+    const auto max_columns = std::min( 64u, ps.max_columns );
+
+    linear_window<Ntk> window;
+    std::unordered_map<node<Ntk>, uint32_t> refs; /* references from window gates */
+    const auto is_gate = [&]( auto const& n ) { return std::find( window.gates.begin(), window.gates.end(), n ) != window.gates.end(); };
+    const auto is_leaf = [&]( auto const& n ) { return std::find( window.leaves.begin(), window.leaves.end(), n ) != window.leaves.end(); };
+    const auto is_output = [&]( auto const& n, uint32_t num_refs ) { return ntk.fanout_size( n ) > num_refs; };
+
+    std::vector<node<Ntk>> queue;
+    const auto add_gate = [&]( auto const& n ) {
+      used[n] = true;
+      window.gates.push_back( n );
+      window.leaves.erase( std::remove( window.leaves.begin(), window.leaves.end(), n ), window.leaves.end() );
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        const auto c = ntk.get_node( f );
+        ++refs[c];
+        if ( !is_gate( c ) && !is_leaf( c ) )
+        {
+          window.leaves.push_back( c );
+          queue.push_back( c );
+          std::copy( fanouts[c].begin(), fanouts[c].end(), std::back_inserter( queue ) );
+        }
+      } );
+      std::copy( fanouts[n].begin(), fanouts[n].end(), std::back_inserter( queue ) );
+    };
+
+    add_gate( root );
+    auto num_outputs = 1u;
+    for ( auto q = 0u; q < queue.size(); ++q )
+    {
+      const auto n = queue[q];
+      if ( used[n] || !is_window_gate( ntk, n ) )
+      {
+        continue;
+      }
+
+      auto num_leaves = static_cast<uint32_t>( window.leaves.size() ) - ( is_leaf( n ) ? 1u : 0u );
+      auto outputs = num_outputs + ( is_output( n, refs[n] ) ? 1u : 0u );
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        const auto c = ntk.get_node( f );
+        if ( is_gate( c ) )
+        {
+          /* an output of the window may become internal */
+          outputs -= ( is_output( c, refs[c] ) && !is_output( c, refs[c] + 1u ) ) ? 1u : 0u;
+        }
+        else if ( !is_leaf( c ) )
+        {
+          ++num_leaves;
+        }
+      } );
+      if ( num_leaves > max_columns || outputs > ps.max_rows )
+      {
+        continue;
+      }
+
+      add_gate( n );
+      num_outputs = outputs;
+    }
+
+    /* compute the linear functions over the leaves and their structural support */
+    std::sort( window.gates.begin(), window.gates.end() );
+    std::unordered_map<node<Ntk>, std::pair<uint64_t, uint64_t>> values;
+    for ( auto i = 0u; i < window.leaves.size(); ++i )
+    {
+      values[window.leaves[i]] = { uint64_t( 1 ) << i, uint64_t( 1 ) << i };
+    }
+    for ( auto const& n : window.gates )
+    {
+      auto& [function, support] = values[n];
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        auto const& [ff, fs] = values.at( ntk.get_node( f ) );
+        function ^= ff;
+        support |= fs;
+      } );
+      if ( is_output( n, refs[n] ) )
+      {
+        window.outputs.push_back( n );
+      }
+    }
+
+    /* every distinct row with more than one leaf needs its own gate */
+    std::vector<uint64_t> rows;
+    for ( auto const& n : window.outputs )
+    {
+      if ( popcount64( values[n].first ) > 1 )
+      {
+        rows.push_back( values[n].first );
+      }
+    }
+    std::sort( rows.begin(), rows.end() );
+    const auto lower_bound = std::unique( rows.begin(), rows.end() ) - rows.begin();
+    if ( static_cast<std::size_t>( lower_bound ) >= window.gates.size() )
+    {
+      for ( auto const& n : window.gates )
+      {
+        used[n] = false;
+      }
+      return std::nullopt;
+    }
+
+    for ( auto const& n : window.outputs )
+    {
+      auto const& [function, support] = values[n];
+      auto& row = window.matrix.emplace_back( window.leaves.size() );
+      auto& ignore = window.ignore_inputs.emplace_back();
+      for ( auto i = 0u; i < window.leaves.size(); ++i )
+      {
+        row[i] = ( function >> i ) & 1u;
+        if ( ( ( support >> i ) & 1u ) == 0u )
+        {
+          ignore.push_back( i );
+        }
+      }
+    }
+    return window;
+  }
+
+  void solve_windows( std::vector<linear_window<Ntk>>& windows )
+  {
+    const auto num_threads = std::min<uint32_t>( static_cast<uint32_t>( windows.size() ), std::max( 1u, ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency() ) );
+
+    std::atomic<uint32_t> next{ 0u };
+    std::mutex mutex;
+    const auto worker = [&]() {
+      for ( auto i = next++; i < windows.size(); i = next++ )
+      {
+        auto& window = windows[i];
+
+        exact_linear_synthesis_params eps;
+        eps.conflict_limit = ps.conflict_limit;
+        eps.upper_bound = static_cast<uint32_t>( window.gates.size() ) - 1u;
+        eps.ignore_inputs = window.ignore_inputs;
+
+        exact_linear_synthesis_stats est;
+        window.solution = exact_linear_synthesis<Ntk, Solver>( window.matrix, eps, &est );
+
+        std::lock_guard<std::mutex> lock( mutex );
+        st.time_solving += est.time_solving;
+      }
+    };
+
+    if ( num_threads <= 1u )
+    {
+      worker();
+    }
+    else
+    {
+      std::vector<std::thread> threads;
+      for ( auto i = 0u; i < num_threads; ++i )
+      {
+        threads.emplace_back( worker );
+      }
+      for ( auto& thread : threads )
+      {
+        thread.join();
+      }
+    }
+  }
+
+  /* Replaces the windows by their solutions.  Since every output of a
+   * solution only depends on leaves in the transitive fanin of the original
+   * output, it can be created as soon as the output is reached in
+   * topological order. */
+  Ntk rebuild( Ntk const& ntk, std::vector<linear_window<Ntk>> const& windows )
+  {
+    node_map<std::pair<uint32_t, uint32_t>, Ntk> position( ntk, { std::numeric_limits<uint32_t>::max(), 0u } );
+    for ( auto w = 0u; w < windows.size(); ++w )
+    {
+      if ( !windows[w].solution )
+      {
+        continue;
+      }
+      for ( auto const& n : windows[w].gates )
+      {
+        position[n] = { w, std::numeric_limits<uint32_t>::max() };
+      }
+      for ( auto j = 0u; j < windows[w].outputs.size(); ++j )
+      {
+        position[windows[w].outputs[j]] = { w, j };
+      }
+    }
+
+    Ntk dest;
+    node_map<signal<Ntk>, Ntk> old_to_new( ntk );
+    old_to_new[ntk.get_constant( false )] = dest.get_constant( false );
+    ntk.foreach_pi( [&]( auto const& n ) {
+      old_to_new[n] = dest.create_pi();
+    } );
+
+    std::vector<std::vector<std::optional<signal<Ntk>>>> copies( windows.size() );
+    ntk.foreach_gate( [&]( auto const& n ) {
+      const auto [w, j] = position[n];
+      if ( w == std::numeric_limits<uint32_t>::max() )
+      {
+        std::vector<signal<Ntk>> children;
+        ntk.foreach_fanin( n, [&]( auto const& f ) {
+          children.push_back( old_to_new[f] ^ ntk.is_complemented( f ) );
+        } );
+        old_to_new[n] = dest.clone_node( ntk, n, children );
+      }
+      else if ( j != std::numeric_limits<uint32_t>::max() )
+      {
+        auto const& window = windows[w];
+        auto const& solution = *window.solution;
+        copies[w].resize( solution.size() );
+        const auto f = solution.po_at( j );
+        old_to_new[n] = copy_cone( dest, solution, solution.get_node( f ), window, copies[w], old_to_new ) ^ solution.is_complemented( f );
+      }
+    } );
+
+    ntk.foreach_po( [&]( auto const& f ) {
+      dest.create_po( old_to_new[f] ^ ntk.is_complemented( f ) );
+    } );
+    return dest;
+  }
+
+  signal<Ntk> copy_cone( Ntk& dest, Ntk const& solution, node<Ntk> const& n, linear_window<Ntk> const& window, std::vector<std::optional<signal<Ntk>>>& copies, node_map<signal<Ntk>, Ntk>& old_to_new ) const
+  {
+    if ( solution.is_constant( n ) )
+    {
+      return dest.get_constant( false );
+    }
+    if ( solution.is_pi( n ) )
+    {
+      return old_to_new[window.leaves[solution.pi_index( n )]];
+    }
+
+    auto& copy = copies[solution.node_to_index( n )];
+    if ( !copy )
+    {
+      std::array<signal<Ntk>, 2> children;
+      solution.foreach_fanin( n, [&]( auto const& f, auto i ) {
+        children[i] = copy_cone( dest, solution, solution.get_node( f ), window, copies, old_to_new ) ^ solution.is_complemented( f );
+      } );
+      copy = dest.create_xor( children[0], children[1] );
+    }
+    return *copy;
+  }
+
+private:
+  Ntk const& ntk_;
+  windowed_exact_linear_resynthesis_params const& ps;
+  windowed_exact_linear_resynthesis_stats& st;
+};
+
+} // namespace detail
+
+/*! \brief Windowed exact linear circuit resynthesis (based on SAT)
+ *
+ * This algorithm resynthesizes the XOR gates of an XAG, which do not have
+ * complemented fanins, in bounded windows rather than as a whole.  A window
+ * is grown from a root gate over fanins and fanouts as long as it has at most
+ * `max_rows` outputs and `max_columns` leaves, and its linear matrix is
+ * resynthesized with `exact_linear_synthesis` with fewer XOR gates than the
+ * window has.  The windows of one round are disjoint and are resynthesized in
+ * parallel; improved windows are stitched back into the network.  Since every
+ * output of a window is only allowed to depend on leaves in its transitive
+ * fanin, the structural dependencies in the network never grow, which keeps
+ * the result acyclic when AND gates are merged back with
+ * `linear_resynthesis_optimization`.
+ *
+ * Windows are grown from the outputs and from the inputs in alternating
+ * rounds, such that they overlap with the windows of the previous round, until
+ * two rounds do not improve any window.
+ */
+template<class Ntk = xag_network, bill::solvers Solver = bill::solvers::glucose_41>
+Ntk windowed_exact_linear_resynthesis( Ntk const& ntk, windowed_exact_linear_resynthesis_params const& ps = {}, windowed_exact_linear_resynthesis_stats* pst = nullptr )
+{
+  static_assert( std::is_same_v<typename Ntk::base_type, xag_network>, "Ntk is not XAG-like" );
+
+  windowed_exact_linear_resynthesis_stats st;
+  const auto dest = detail::windowed_exact_linear_resynthesis_impl<Ntk, Solver>( ntk, ps, st ).run();
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return dest;
+}
+
 } /* namespace mockturtle */
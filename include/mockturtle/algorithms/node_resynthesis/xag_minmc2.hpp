@@ -35,11 +35,14 @@
 
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "../../networks/xag.hpp"
 #include "../../utils/index_list.hpp"
+#include "../../utils/minmc_database.hpp"
+#include "../../utils/spectral_canonization_cache.hpp"
 #include "../detail/minmc_xags.hpp"
 #include "../equivalence_classes.hpp"
 
@@ -69,7 +72,14 @@ template<class Ntk = xag_network>
 class xag_minmc_resynthesis
 {
 public:
-  xag_minmc_resynthesis()
+  /*! \brief Constructor.
+   *
+   * Canonizations are memoized in `cache`, which is thread-safe and can be
+   * shared between instances; copies of this object share their cache.  A
+   * new cache is created if none is given.
+   */
+  explicit xag_minmc_resynthesis( std::shared_ptr<spectral_canonization_cache> cache = nullptr )
+      : cache_( cache ? cache : std::make_shared<spectral_canonization_cache>() )
   {
     build_db();
   }
@@ -99,33 +109,100 @@ public:
     }
   }
 
+  /*! \brief Loads a 6-input database in binary format (see `minmc_database`).
+   *
+   * The file is memory-mapped rather than parsed; its entries take
+   * precedence over the built-in ones and those read by `load_from_file`.
+   */
+  bool load_from_binary_file( std::string const& filename )
+  {
+    auto db = std::make_shared<minmc_database>();
+    if ( !db->open( filename ) )
+    {
+      fmt::print( "[e] cannot open database {}\n", filename );
+      return false;
+    }
+    set_database( db );
+    return true;
+  }
+
+  /*! \brief Canonization cache, e.g., to report its statistics. */
+  spectral_canonization_cache& canonization_cache() const
+  {
+    return *cache_;
+  }
+
+  /*! \brief Uses a 6-input database which may be shared with other instances. */
+  void set_database( std::shared_ptr<minmc_database const> db )
+  {
+    mapped_db_ = db;
+    if ( ps_.verbose )
+    {
+      fmt::print( "[i] mapped db size = {:>5.2f} Kb, {} entries\n", mapped_db_->size_in_bytes() / 1024.0f, mapped_db_->num_entries() );
+    }
+  }
+
+  /*! \brief Hash of the database contents.
+   *
+   * Covers the built-in entries, those read by `load_from_file`, and the
+   * mapped database, such that `exact_library` does not load a library file
+   * which was built from a different database.  Runs in time linear in the
+   * size of the database.
+   */
+  uint64_t database_fingerprint() const
+  {
+    /* order-independent sum of entry hashes */
+    const auto hash_entry = []( uint64_t seed, uint64_t word, auto const& index_list ) {
+      uint64_t h = mix( seed ^ word );
+      for ( auto const& v : index_list )
+      {
+        h = mix( h ^ v );
+      }
+      return h;
+    };
+
+    uint64_t builtin{ 0u };
+    for ( auto i = 0u; i < db_.size(); ++i )
+    {
+      for ( auto const& [word, index_list] : db_[i] )
+      {
+        builtin += hash_entry( i, word, index_list );
+      }
+    }
+
+    uint64_t mapped{ 0u };
+    if ( mapped_db_ )
+    {
+      mapped_db_->foreach_entry( [&]( uint64_t word, minmc_database_entry const& entry ) {
+        mapped += hash_entry( 6u, word, entry );
+      } );
+    }
+
+    return mix( builtin ^ mix( mapped + ( mapped_db_ ? 1u : 0u ) ) );
+  }
+
   template<typename LeavesIterator, typename Fn>
   void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn ) const
   {
     const auto num_vars = function.num_vars();
-    uint64_t repr;
-    std::vector<kitty::detail::spectral_operation> trans;
+    const auto [repr, trans] = ( *cache_ )( function );
 
-    if ( const auto itCache = cache_[num_vars].find( *function.cbegin() ); itCache != cache_[num_vars].end() )
+    xag_index_list il;
+    if ( const auto entry = num_vars == 6u && mapped_db_ ? mapped_db_->find( repr ) : minmc_database_entry{}; entry )
     {
-      repr = itCache->second.first;
-      trans = itCache->second.second;
+      il = xag_index_list{ std::vector<uint32_t>( entry.begin(), entry.end() ) };
     }
-    else
+    else if ( const auto it = db_[num_vars].find( repr ); it != db_[num_vars].end() )
     {
-      repr = *kitty::hybrid_exact_spectral_canonization( function, [&]( auto const& ops ) { trans = ops; } ).cbegin();
-      cache_[num_vars][*function.cbegin()] = { repr, trans };
+      il = xag_index_list{ it->second };
     }
-
-    const auto it = db_[num_vars].find( repr );
-    if ( it == db_[num_vars].end() )
+    else
     {
       fmt::print( "[w] cannot find repr {:x} in database.\n", repr );
       return;
     }
 
     const auto f = apply_spectral_transformations( ntk, trans, std::vector<signal<Ntk>>( begin, end ), [&]( xag_network& ntk, std::vector<signal<Ntk>> const& leaves ) {
-      xag_index_list il{ it->second };
       std::vector<xag_network::signal> pos;
       insert( ntk, std::begin( leaves ), std::begin( leaves ) + il.num_pis(), il,
               [&]( xag_network::signal const& f ) {
@@ -139,6 +216,14 @@ public:
   }
 
 private:
+  /* splitmix64 finalizer */
+  static uint64_t mix( uint64_t h )
+  {
+    h = ( h ^ ( h >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    h = ( h ^ ( h >> 27 ) ) * 0x94d049bb133111ebull;
+    return h ^ ( h >> 31 );
+  }
+
   void build_db()
   {
     st_.db_size += sizeof( db_ );
@@ -162,7 +247,8 @@ private:
 
 private:
   std::vector<std::unordered_map<uint64_t, std::vector<uint32_t>>> db_{ 7u };
-  mutable std::vector<std::unordered_map<uint64_t, std::pair<uint64_t, std::vector<kitty::detail::spectral_operation>>>> cache_{ 7u };
+  std::shared_ptr<minmc_database const> mapped_db_;
+  std::shared_ptr<spectral_canonization_cache> cache_;
 
 private:
   xag_minmc_resynthesis_params ps_;
@@ -739,12 +739,12 @@ private:
 
         /* annotate hashing info */
         db.set_value( n, val->data );
-        return { area + ( ntk.fanout_size( ntk.get_node( *val ) ) > 0 ? 0 : cost_fn( ntk, n ) ), level + 1 };
+        return { area + ( ntk.fanout_size( ntk.get_node( *val ) ) > 0 ? 0 : cost_fn( ntk, ntk.get_node( *val ) ) ), level + 1 };
       }
     }
 
     db.set_value( n, UINT32_MAX );
-    return { area + cost_fn( ntk, n ), level + 1 };
+    return { area + cost_fn( db, n ), level + 1 };
   }
 
   void compute_required()
@@ -883,6 +883,24 @@ private:
  * The algorithm performs changes in-place and keeps the substituted structures dangling
  * in the network.
  *
+ * The gain of a candidate is measured with `cost_fn`.  To optimize the
+ * multiplicative complexity of an XAG, use a library of min-MC structures
+ * (every NPN class is resynthesized from its spectral class in the min-MC
+ * database) together with `and_xor_cost`, which ranks the number of AND
+ * gates before the number of XOR gates:
+ *
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      future::xag_minmc_resynthesis<xag_network> resyn;
+      exact_library_params eps;
+      eps.np_classification = false;
+      exact_library<xag_network, decltype( resyn )> lib( resyn, eps );
+
+      rewrite( xag, lib, {}, nullptr, and_xor_cost<xag_network>{} );
+   \endverbatim
+ *
  * **Required network functions:**
  * - `get_node`
  * - `size`
@@ -36,10 +36,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <bill/sat/interface/common.hpp>
@@ -50,7 +57,9 @@
 #include "../io/write_verilog.hpp"
 #include "../networks/xag.hpp"
 #include "../properties/mccost.hpp"
+#include "../utils/bit_utils.hpp"
 #include "../utils/node_map.hpp"
+#include "../utils/stopwatch.hpp"
 #include "../views/topo_view.hpp"
 #include "cleanup.hpp"
 #include "dont_cares.hpp"
@@ -74,7 +83,19 @@ public:
     xag_network dest;
 
     node_map<xag_network::signal, xag_network> old2new( xag );
-    node_map<std::vector<xag_network::node>, xag_network> lfi( xag );
+
+    /* the linear transitive fanin of a node is a bit-vector over the leaves
+     * (PIs and AND gates), which are indexed in topological order; a row is
+     * released once all gate fanouts of its node have been processed */
+    node_map<uint32_t, xag_network> remaining_fanouts( xag, 0u );
+    lfi_rows.resize( xag.size() );
+    leaves.clear();
+
+    xag.foreach_gate( [&]( auto const& n ) {
+      xag.foreach_fanin( n, [&]( auto const& f ) {
+        remaining_fanouts[f]++;
+      } );
+    } );
 
     old2new[xag.get_node( xag.get_constant( false ) )] = dest.get_constant( false );
     if ( xag.get_node( xag.get_constant( true ) ) != xag.get_node( xag.get_constant( false ) ) )
@@ -83,7 +104,7 @@ public:
     }
     xag.foreach_pi( [&]( auto const& n ) {
       old2new[n] = dest.create_pi();
-      lfi[n].emplace_back( n );
+      make_leaf( n );
     } );
     topo_view topo{ xag };
     topo.foreach_node( [&]( auto const& n ) {
@@ -93,19 +114,22 @@ public:
       if ( xag.is_xor( n ) )
       {
         std::array<xag_network::signal*, 2> children{};
-        std::array<std::vector<xag_network::node>*, 2> clfi{};
+        std::array<xag_network::node, 2> cnodes{};
         xag.foreach_fanin( n, [&]( auto const& f, auto i ) {
           children[i] = &old2new[f];
-          clfi[i] = &lfi[f];
+          cnodes[i] = xag.get_node( f );
         } );
-        lfi[n] = merge( *clfi[0], *clfi[1] );
-        if ( lfi[n].size() == 0 )
+        auto& row = lfi_rows[xag.node_to_index( n )];
+        merge( row, lfi_rows[xag.node_to_index( cnodes[0] )], lfi_rows[xag.node_to_index( cnodes[1] )] );
+
+        const auto [size, first] = count( row );
+        if ( size == 0 )
         {
           old2new[n] = dest.get_constant( false );
         }
-        else if ( lfi[n].size() == 1 )
+        else if ( size == 1 )
         {
-          old2new[n] = old2new[lfi[n].front()];
+          old2new[n] = old2new[leaves[first]];
         }
         else
         {
@@ -114,13 +138,20 @@ public:
       }
       else /* is AND */
       {
-        lfi[n].emplace_back( n );
+        make_leaf( n );
         std::vector<xag_network::signal> children;
         xag.foreach_fanin( n, [&]( auto const& f ) {
           children.push_back( old2new[f] ^ xag.is_complemented( f ) );
         } );
         old2new[n] = dest.create_and( children[0], children[1] );
       }
+
+      xag.foreach_fanin( n, [&]( auto const& f ) {
+        if ( --remaining_fanouts[f] == 0u )
+        {
+          release( xag.get_node( f ) );
+        }
+      } );
     } );
 
     xag.foreach_po( [&]( auto const& f ) {
@@ -131,15 +162,85 @@ public:
   }
 
 private:
-  std::vector<xag_network::node> merge( std::vector<xag_network::node> const& s1, std::vector<xag_network::node> const& s2 ) const
+  std::vector<uint64_t> allocate_row()
   {
-    std::vector<xag_network::node> s;
-    std::set_symmetric_difference( s1.cbegin(), s1.cend(), s2.cbegin(), s2.cend(), std::back_inserter( s ) );
-    return s;
+    if ( free_rows.empty() )
+    {
+      return {};
+    }
+    auto row = std::move( free_rows.back() );
+    free_rows.pop_back();
+    row.clear();
+    return row;
+  }
+
+  void release( xag_network::node const& n )
+  {
+    auto& row = lfi_rows[xag.node_to_index( n )];
+    if ( row.capacity() != 0u )
+    {
+      free_rows.emplace_back( std::move( row ) );
+      row = {};
+    }
+  }
+
+  void make_leaf( xag_network::node const& n )
+  {
+    const auto index = static_cast<uint32_t>( leaves.size() );
+    leaves.emplace_back( n );
+
+    auto& row = lfi_rows[xag.node_to_index( n )];
+    row = allocate_row();
+    row.resize( ( index >> 6 ) + 1u, 0u );
+    row.back() = UINT64_C( 1 ) << ( index & 63u );
+  }
+
+  /* rows never have trailing zero words */
+  void merge( std::vector<uint64_t>& s, std::vector<uint64_t> const& s1, std::vector<uint64_t> const& s2 )
+  {
+    auto const& longer = s1.size() >= s2.size() ? s1 : s2;
+    auto const& shorter = s1.size() >= s2.size() ? s2 : s1;
+
+    s = allocate_row();
+    s.resize( longer.size() );
+    auto i = 0u;
+    for ( ; i < shorter.size(); ++i )
+    {
+      s[i] = longer[i] ^ shorter[i];
+    }
+    std::copy( longer.begin() + i, longer.end(), s.begin() + i );
+
+    while ( !s.empty() && s.back() == 0u )
+    {
+      s.pop_back();
+    }
+  }
+
+  /* returns the number of leaves in a row and the first one */
+  std::pair<uint32_t, uint32_t> count( std::vector<uint64_t> const& row ) const
+  {
+    uint32_t size{ 0u }, first{ 0u };
+    for ( auto i = row.size(); i-- > 0u; )
+    {
+      if ( row[i] == 0u )
+      {
+        continue;
+      }
+      size += popcount64( row[i] );
+      if ( size > 1u )
+      {
+        break;
+      }
+      first = static_cast<uint32_t>( i << 6 ) + ctz64( row[i] );
+    }
+    return { size, first };
   }
 
 private:
   xag_network const& xag;
+  std::vector<std::vector<uint64_t>> lfi_rows;
+  std::vector<std::vector<uint64_t>> free_rows;
+  std::vector<xag_network::node> leaves;
 };
 
 } // namespace detail
@@ -158,54 +259,269 @@ inline xag_network xag_constant_fanin_optimization( xag_network const& xag )
   return detail::xag_constant_fanin_optimization_impl( xag ).run();
 }
 
+struct xag_dont_cares_optimization_params
+{
+  /*! \brief Check AND gates in a reconvergence-driven window instead of the whole network. */
+  bool windowed{ false };
+
+  /*! \brief Maximum number of window leaves (windowed mode). */
+  uint32_t max_window_leaves{ 12u };
+
+  /*! \brief Number of random simulation patterns to filter candidates (0 disables filtering). */
+  uint32_t num_patterns{ 256u };
+
+  /*! \brief Seed for random simulation patterns. */
+  std::default_random_engine::result_type seed{ 1u };
+
+  /*! \brief Number of threads for the don't care checks (0 means hardware concurrency). */
+  uint32_t num_threads{ 1u };
+};
+
+struct xag_dont_cares_optimization_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{ 0 };
+
+  /*! \brief Runtime for random simulation. */
+  stopwatch<>::duration time_simulation{ 0 };
+
+  /*! \brief Runtime for SAT or window checks. */
+  stopwatch<>::duration time_check{ 0 };
+
+  /*! \brief Number of AND gates. */
+  uint32_t num_ands{ 0u };
+
+  /*! \brief Number of AND gates ruled out by simulation. */
+  uint32_t num_filtered{ 0u };
+
+  /*! \brief Number of AND gates replaced by XNOR gates. */
+  uint32_t num_replaced{ 0u };
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] ANDs = {}, filtered = {}, replaced = {}\n", num_ands, num_filtered, num_replaced );
+    std::cout << fmt::format( "[i] simulation time = {:>5.2f} secs\n", to_seconds( time_simulation ) );
+    std::cout << fmt::format( "[i] check time      = {:>5.2f} secs\n", to_seconds( time_check ) );
+    std::cout << fmt::format( "[i] total time      = {:>5.2f} secs\n", to_seconds( time_total ) );
+  }
+};
+
+namespace detail
+{
+
+/* Checks whether both fanins of AND gate `n` cannot be 0 at the same time,
+ * considering only a reconvergence-driven window with at most `max_leaves`
+ * leaves, which are treated as independent inputs.  The window is computed
+ * without modifying the network such that it can be called concurrently. */
+inline bool xag_window_dont_care_00( xag_network const& xag, xag_network::node const& n, uint32_t max_leaves )
+{
+  using node = xag_network::node;
+
+  std::vector<node> leaves, inner;
+  const auto contains = []( std::vector<node> const& v, node const& x ) { return std::find( v.begin(), v.end(), x ) != v.end(); };
+
+  xag.foreach_fanin( n, [&]( auto const& f ) {
+    const auto c = xag.get_node( f );
+    if ( !xag.is_constant( c ) && !contains( leaves, c ) )
+      leaves.push_back( c );
+  } );
+
+  while ( true )
+  {
+    std::optional<uint32_t> best;
+    int32_t best_cost{};
+    for ( auto i = 0u; i < leaves.size(); ++i )
+    {
+      if ( xag.is_pi( leaves[i] ) )
+        continue;
+
+      int32_t cost{ -1 };
+      xag.foreach_fanin( leaves[i], [&]( auto const& f ) {
+        const auto c = xag.get_node( f );
+        if ( !xag.is_constant( c ) && !contains( leaves, c ) && !contains( inner, c ) )
+          ++cost;
+      } );
+      if ( !best || cost < best_cost )
+      {
+        best = i;
+        best_cost = cost;
+      }
+    }
+
+    if ( !best || static_cast<int32_t>( leaves.size() ) + best_cost > static_cast<int32_t>( max_leaves ) )
+      break;
+
+    const auto expand = leaves[*best];
+    leaves.erase( leaves.begin() + *best );
+    inner.push_back( expand );
+    xag.foreach_fanin( expand, [&]( auto const& f ) {
+      const auto c = xag.get_node( f );
+      if ( !xag.is_constant( c ) && !contains( leaves, c ) && !contains( inner, c ) )
+        leaves.push_back( c );
+    } );
+  }
+
+  /* simulate the window exhaustively; node indexes are in topological order */
+  std::sort( inner.begin(), inner.end() );
+  const auto num_vars = static_cast<uint32_t>( leaves.size() );
+  std::unordered_map<node, kitty::dynamic_truth_table> tts;
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    kitty::dynamic_truth_table tt( num_vars );
+    kitty::create_nth_var( tt, i );
+    tts.emplace( leaves[i], tt );
+  }
+  const auto value = [&]( xag_network::signal const& f ) {
+    const auto c = xag.get_node( f );
+    auto tt = xag.is_constant( c ) ? kitty::dynamic_truth_table( num_vars ) : tts.at( c );
+    return xag.is_complemented( f ) ? ~tt : tt;
+  };
+  for ( auto const& g : inner )
+  {
+    std::array<kitty::dynamic_truth_table, 2> fanin;
+    xag.foreach_fanin( g, [&]( auto const& f, auto i ) {
+      fanin[i] = value( f );
+    } );
+    tts.emplace( g, xag.is_and( g ) ? fanin[0] & fanin[1] : fanin[0] ^ fanin[1] );
+  }
+
+  std::array<kitty::dynamic_truth_table, 2> fanin;
+  xag.foreach_fanin( n, [&]( auto const& f, auto i ) {
+    fanin[i] = value( f );
+  } );
+  return kitty::is_const0( ~fanin[0] & ~fanin[1] );
+}
+
+} // namespace detail
+
 /*! \brief Optimizes some AND gates using satisfiability don't cares
  *
  * If an AND gate is satisfiability don't care for assignment 00, it can be
  * replaced by an XNOR gate, therefore reducing the multiplicative complexity.
+ *
+ * Candidates for which random simulation (`num_patterns`) finds an input
+ * pattern with both AND fanins being 0 are not checked further.  The
+ * remaining AND gates are checked either with a SAT solver on the whole
+ * network or, if `windowed` is set, by exhaustive simulation of a
+ * reconvergence-driven window, which is faster but may miss some don't cares.
+ * The checks of different AND gates are independent and are distributed
+ * over `num_threads` threads; each thread uses its own SAT solver.
  */
-inline xag_network xag_dont_cares_optimization( xag_network const& xag )
+inline xag_network xag_dont_cares_optimization( xag_network const& xag, xag_dont_cares_optimization_params const& ps = {}, xag_dont_cares_optimization_stats* pst = nullptr )
 {
-  node_map<xag_network::signal, xag_network> old_to_new( xag );
-
+  xag_dont_cares_optimization_stats st;
   xag_network dest;
-  old_to_new[xag.get_constant( false )] = dest.get_constant( false );
 
-  xag.foreach_pi( [&]( auto const& n ) {
-    old_to_new[n] = dest.create_pi();
-  } );
+  call_with_stopwatch( st.time_total, [&]() {
+    /* filter candidates by random simulation */
+    std::vector<xag_network::node> candidates;
+    xag.foreach_gate( [&]( auto const& n ) {
+      if ( xag.is_and( n ) )
+        candidates.push_back( n );
+    } );
+    st.num_ands = static_cast<uint32_t>( candidates.size() );
 
-  satisfiability_dont_cares_checker<xag_network> checker( xag );
+    if ( ps.num_patterns != 0u )
+    {
+      stopwatch<> t( st.time_simulation );
+      partial_simulator sim( xag.num_pis(), ps.num_patterns, ps.seed );
+      const auto tts = simulate_nodes<kitty::partial_truth_table>( xag, sim );
+
+      candidates.erase( std::remove_if( candidates.begin(), candidates.end(), [&]( auto const& n ) {
+                          std::array<kitty::partial_truth_table, 2> fanin;
+                          xag.foreach_fanin( n, [&]( auto const& f, auto i ) {
+                            fanin[i] = xag.is_complemented( f ) ? ~tts[f] : tts[f];
+                          } );
+                          return !kitty::is_const0( ~fanin[0] & ~fanin[1] );
+                        } ),
+                        candidates.end() );
+      st.num_filtered = st.num_ands - static_cast<uint32_t>( candidates.size() );
+    }
 
-  topo_view<xag_network>{ xag }.foreach_node( [&]( auto const& n ) {
-    if ( xag.is_constant( n ) || xag.is_pi( n ) )
-      return;
+    /* check remaining candidates */
+    node_map<uint8_t, xag_network> is_dont_care( xag, 0u );
+    {
+      stopwatch<> t( st.time_check );
 
-    std::array<xag_network::signal, 2> fanin{};
-    xag.foreach_fanin( n, [&]( auto const& f, auto i ) {
-      fanin[i] = old_to_new[f] ^ xag.is_complemented( f );
-    } );
+      std::atomic<uint32_t> next{ 0u };
+      const auto worker = [&]() {
+        std::optional<satisfiability_dont_cares_checker<xag_network>> checker;
+        for ( auto i = next++; i < candidates.size(); i = next++ )
+        {
+          bool dc;
+          if ( ps.windowed )
+          {
+            dc = detail::xag_window_dont_care_00( xag, candidates[i], ps.max_window_leaves );
+          }
+          else
+          {
+            if ( !checker )
+              checker.emplace( xag );
+            dc = checker->is_dont_care( candidates[i], { false, false } );
+          }
+          /* distinct candidates are distinct node map entries */
+          is_dont_care[candidates[i]] = dc ? 1u : 0u;
+        }
+      };
 
-    if ( xag.is_and( n ) )
-    {
-      if ( checker.is_dont_care( n, { false, false } ) )
+      const auto num_threads = std::max<uint32_t>( 1u, std::min<uint32_t>( ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency(),
+                                                                            static_cast<uint32_t>( candidates.size() ) ) );
+      std::vector<std::thread> threads;
+      for ( auto i = 1u; i < num_threads; ++i )
       {
-        old_to_new[n] = dest.create_xnor( fanin[0], fanin[1] );
+        threads.emplace_back( worker );
       }
-      else
+      worker();
+      for ( auto& thread : threads )
       {
-        old_to_new[n] = dest.create_and( fanin[0], fanin[1] );
+        thread.join();
       }
     }
-    else /* is XOR */
-    {
-      old_to_new[n] = dest.create_xor( fanin[0], fanin[1] );
-    }
-  } );
 
-  xag.foreach_po( [&]( auto const& f ) {
-    dest.create_po( old_to_new[f] ^ xag.is_complemented( f ) );
+    node_map<xag_network::signal, xag_network> old_to_new( xag );
+    old_to_new[xag.get_constant( false )] = dest.get_constant( false );
+
+    xag.foreach_pi( [&]( auto const& n ) {
+      old_to_new[n] = dest.create_pi();
+    } );
+
+    topo_view<xag_network>{ xag }.foreach_node( [&]( auto const& n ) {
+      if ( xag.is_constant( n ) || xag.is_pi( n ) )
+        return;
+
+      std::array<xag_network::signal, 2> fanin{};
+      xag.foreach_fanin( n, [&]( auto const& f, auto i ) {
+        fanin[i] = old_to_new[f] ^ xag.is_complemented( f );
+      } );
+
+      if ( xag.is_and( n ) )
+      {
+        if ( is_dont_care[n] )
+        {
+          ++st.num_replaced;
+          old_to_new[n] = dest.create_xnor( fanin[0], fanin[1] );
+        }
+        else
+        {
+          old_to_new[n] = dest.create_and( fanin[0], fanin[1] );
+        }
+      }
+      else /* is XOR */
+      {
+        old_to_new[n] = dest.create_xor( fanin[0], fanin[1] );
+      }
+    } );
+
+    xag.foreach_po( [&]( auto const& f ) {
+      dest.create_po( old_to_new[f] ^ xag.is_complemented( f ) );
+    } );
   } );
 
+  if ( pst )
+  {
+    *pst = st;
+  }
+
   return dest;
 }
 
@@ -239,7 +555,7 @@ inline xag_network linear_resynthesis_optimization( xag_network const& xag, std:
   assert( linear.num_pis() == linear_optimized.num_pis() );
   assert( linear.num_pos() == linear_optimized.num_pos() );
   assert( linear.num_pis() == xag.num_pis() + num_ands );
-  assert( linear.num_pos() == 1 + 2 * num_ands );
+  assert( linear.num_pos() == xag.num_pos() + 2 * num_ands );
 
   return merge_linear_circuit( linear_optimized, num_ands );
 }
@@ -270,4 +586,22 @@ inline xag_network exact_linear_resynthesis_optimization( xag_network const& xag
   return linear_resynthesis_optimization( xag, linear_resyn, on_ignore_inputs );
 }
 
+/*! \brief Optimizes XOR gates by windowed exact linear network resynthesis
+ *
+ * Unlike `exact_linear_resynthesis_optimization`, which solves a single SAT
+ * problem for the whole linear circuit, this function resynthesizes bounded
+ * windows of it (see `windowed_exact_linear_resynthesis`), and therefore
+ * scales to large linear circuits.
+ */
+template<bill::solvers Solver = bill::solvers::glucose_41>
+inline xag_network windowed_exact_linear_resynthesis_optimization( xag_network const& xag, windowed_exact_linear_resynthesis_params const& ps = {}, windowed_exact_linear_resynthesis_stats* pst = nullptr )
+{
+  const auto linear_resyn = [&]( xag_network const& linear ) {
+    return windowed_exact_linear_resynthesis<xag_network, Solver>( linear, ps, pst );
+  };
+
+  /* windows never add structural dependencies, hence no inputs need to be ignored */
+  return linear_resynthesis_optimization( xag, linear_resyn, []( std::vector<uint32_t> const& ) {} );
+}
+
 } /* namespace mockturtle */
\ No newline at end of file
@@ -33,13 +33,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <fmt/format.h>
 #include <lorina/bristol.hpp>
 
 #include "../traits.hpp"
+#include "../utils/mapped_file.hpp"
+#include "../utils/stopwatch.hpp"
 
 namespace mockturtle
 {
@@ -146,4 +153,422 @@ private:
   mutable std::vector<signal<Ntk>> signal_;
 }; /* bristol_reader */
 
+/*! \brief Gate types of Bristol fashion circuits. */
+enum class bristol_gate_type : uint8_t
+{
+  xor_gate,
+  and_gate,
+  inv_gate,
+  /*! \brief Wire assignment. */
+  eqw_gate,
+  /*! \brief Constant assignment, the input is the constant value. */
+  eq_gate
+};
+
+/*! \brief A parsed gate of a Bristol fashion circuit. */
+struct bristol_gate
+{
+  uint32_t in0;
+  uint32_t in1;
+  uint32_t out;
+  bristol_gate_type type;
+};
+
+struct read_bristol_fast_params
+{
+  /*! \brief Number of threads which parse chunks of gates (0 means hardware concurrency). */
+  uint32_t num_threads{ 1u };
+};
+
+struct read_bristol_fast_stats
+{
+  /*! \brief Time to parse the file. */
+  stopwatch<>::duration time_parse{ 0 };
+
+  /*! \brief Time to create the network. */
+  stopwatch<>::duration time_build{ 0 };
+
+  /*! \brief Number of parsed gates. */
+  uint64_t num_gates{ 0u };
+
+  void report() const
+  {
+    fmt::print( "[i] gates = {}, parse time = {:>5.2f} secs, build time = {:>5.2f} secs\n", num_gates, to_seconds( time_parse ), to_seconds( time_build ) );
+  }
+};
+
+namespace detail
+{
+
+template<class Ntk, class = void>
+struct has_reservable_storage : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_reservable_storage<Ntk, std::void_t<decltype( std::declval<Ntk&>()._storage->nodes.reserve( 0u ) ), decltype( std::declval<Ntk&>()._storage->hash.reserve( 0u ) )>> : std::true_type
+{
+};
+
+class bristol_tokenizer
+{
+public:
+  bristol_tokenizer( char const* begin, char const* end )
+      : pos_( begin ), end_( end )
+  {
+  }
+
+  /* skips blanks and empty lines, returns false at the end of the input */
+  bool next_line()
+  {
+    while ( pos_ != end_ && ( *pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r' || *pos_ == '\n' ) )
+    {
+      ++pos_;
+    }
+    return pos_ != end_;
+  }
+
+  bool at_line_end()
+  {
+    skip_blanks();
+    return pos_ == end_ || *pos_ == '\n';
+  }
+
+  bool number( uint32_t& value )
+  {
+    skip_blanks();
+    if ( pos_ == end_ || *pos_ < '0' || *pos_ > '9' )
+    {
+      return false;
+    }
+    uint64_t v{ 0u };
+    while ( pos_ != end_ && *pos_ >= '0' && *pos_ <= '9' && v <= UINT32_MAX )
+    {
+      v = 10u * v + static_cast<uint32_t>( *pos_++ - '0' );
+    }
+    value = static_cast<uint32_t>( v );
+    return v <= UINT32_MAX;
+  }
+
+  bool gate_type( bristol_gate_type& type )
+  {
+    skip_blanks();
+    const auto begin = pos_;
+    while ( pos_ != end_ && *pos_ >= 'A' && *pos_ <= 'Z' )
+    {
+      ++pos_;
+    }
+    const auto length = pos_ - begin;
+    if ( length == 3 )
+    {
+      switch ( begin[0] )
+      {
+      case 'X':
+        type = bristol_gate_type::xor_gate;
+        return begin[1] == 'O' && begin[2] == 'R';
+      case 'A':
+        type = bristol_gate_type::and_gate;
+        return begin[1] == 'N' && begin[2] == 'D';
+      case 'I':
+        type = bristol_gate_type::inv_gate;
+        return begin[1] == 'N' && begin[2] == 'V';
+      case 'E':
+        type = bristol_gate_type::eqw_gate;
+        return begin[1] == 'Q' && begin[2] == 'W';
+      default:
+        return false;
+      }
+    }
+    type = bristol_gate_type::eq_gate;
+    return length == 2 && begin[0] == 'E' && begin[1] == 'Q';
+  }
+
+  char const* position() const
+  {
+    return pos_;
+  }
+
+private:
+  void skip_blanks()
+  {
+    while ( pos_ != end_ && ( *pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r' ) )
+    {
+      ++pos_;
+    }
+  }
+
+private:
+  char const* pos_;
+  char const* end_;
+};
+
+/* parses the gates in [begin, end), which starts and ends at line boundaries */
+inline bool parse_bristol_gates( char const* begin, char const* end, uint32_t num_wires, std::vector<bristol_gate>& gates )
+{
+  bristol_tokenizer tok( begin, end );
+  while ( tok.next_line() )
+  {
+    uint32_t num_in, num_out, in[2] = { 0u, 0u };
+    bristol_gate gate;
+    if ( !tok.number( num_in ) || !tok.number( num_out ) || num_in < 1u || num_in > 2u || num_out != 1u )
+    {
+      return false;
+    }
+    for ( auto i = 0u; i < num_in; ++i )
+    {
+      if ( !tok.number( in[i] ) )
+      {
+        return false;
+      }
+    }
+    if ( !tok.number( gate.out ) || !tok.gate_type( gate.type ) || !tok.at_line_end() || gate.out >= num_wires )
+    {
+      return false;
+    }
+
+    const auto binary = gate.type == bristol_gate_type::xor_gate || gate.type == bristol_gate_type::and_gate;
+    if ( num_in != ( binary ? 2u : 1u ) || ( gate.type == bristol_gate_type::eq_gate ? in[0] > 1u : in[0] >= num_wires || in[1] >= num_wires ) )
+    {
+      return false;
+    }
+    gate.in0 = in[0];
+    gate.in1 = in[1];
+    gates.push_back( gate );
+  }
+  return true;
+}
+
+} /* namespace detail */
+
+/*! \brief Reads a Bristol fashion circuit from memory into a network.
+ *
+ * Fast alternative to `lorina::read_bristol` with `bristol_reader`.  Gates
+ * are tokenized in place into a compact array of `bristol_gate` (optionally
+ * in parallel, each thread parsing a chunk of lines), and the network is
+ * then created in one pass, after reserving its storage for the number of
+ * gates in the header.  Supports the gates `XOR`, `AND`, `INV`, `EQW`, and
+ * `EQ`.
+ *
+ * Returns `lorina::return_code::parse_error` for malformed input, including
+ * out-of-range wires and unknown gates, without modifying `ntk` in this
+ * case.
+ *
+ * **Required network functions:**
+ * - `create_pi`
+ * - `create_po`
+ * - `create_and`
+ * - `create_xor`
+ * - `create_not`
+ * - `get_constant`
+ */
+template<class Ntk>
+lorina::return_code read_bristol_fast( char const* data, uint64_t size, Ntk& ntk, read_bristol_fast_params const& ps = {}, read_bristol_fast_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_create_pi_v<Ntk>, "Ntk does not implement the create_pi function" );
+  static_assert( has_create_po_v<Ntk>, "Ntk does not implement the create_po function" );
+  static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and function" );
+  static_assert( has_create_xor_v<Ntk>, "Ntk does not implement the create_xor function" );
+  static_assert( has_create_not_v<Ntk>, "Ntk does not implement the create_not function" );
+  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant function" );
+
+  read_bristol_fast_stats st;
+  std::vector<bristol_gate> gates;
+  uint32_t num_gates, num_wires, num_pis{ 0u }, num_pos{ 0u };
+
+  {
+    stopwatch<> t( st.time_parse );
+
+    /* header */
+    detail::bristol_tokenizer tok( data, data + size );
+    uint32_t num_inputs, num_outputs, value;
+    if ( !tok.next_line() || !tok.number( num_gates ) || !tok.number( num_wires ) || !tok.at_line_end() )
+    {
+      return lorina::return_code::parse_error;
+    }
+    if ( !tok.next_line() || !tok.number( num_inputs ) )
+    {
+      return lorina::return_code::parse_error;
+    }
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      if ( !tok.number( value ) )
+      {
+        return lorina::return_code::parse_error;
+      }
+      num_pis += value;
+    }
+    if ( !tok.at_line_end() || !tok.next_line() || !tok.number( num_outputs ) )
+    {
+      return lorina::return_code::parse_error;
+    }
+    for ( auto i = 0u; i < num_outputs; ++i )
+    {
+      if ( !tok.number( value ) )
+      {
+        return lorina::return_code::parse_error;
+      }
+      num_pos += value;
+    }
+    if ( !tok.at_line_end() || num_pis > num_wires || num_pos > num_wires )
+    {
+      return lorina::return_code::parse_error;
+    }
+
+    /* gates, split into chunks at line boundaries */
+    char const* begin = tok.position();
+    char const* end = data + size;
+    const auto num_threads = std::max( 1u, ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency() );
+    const auto num_chunks = static_cast<uint32_t>( std::min<uint64_t>( num_threads, std::max<uint64_t>( 1u, ( end - begin ) / ( 1u << 16 ) ) ) );
+
+    std::vector<char const*> bounds{ begin };
+    for ( auto i = 1u; i < num_chunks; ++i )
+    {
+      auto it = std::max( bounds.back(), begin + ( end - begin ) * i / num_chunks );
+      it = std::find( it, end, '\n' );
+      bounds.push_back( it == end ? end : it + 1 );
+    }
+    bounds.push_back( end );
+
+    if ( num_chunks == 1u )
+    {
+      gates.reserve( num_gates );
+      if ( !detail::parse_bristol_gates( begin, end, num_wires, gates ) )
+      {
+        return lorina::return_code::parse_error;
+      }
+    }
+    else
+    {
+      std::vector<std::vector<bristol_gate>> chunks( num_chunks );
+      std::vector<uint8_t> valid( num_chunks, 0u );
+      std::vector<std::thread> threads;
+      for ( auto i = 0u; i < num_chunks; ++i )
+      {
+        threads.emplace_back( [&, i]() {
+          chunks[i].reserve( static_cast<uint64_t>( num_gates ) * ( bounds[i + 1] - bounds[i] ) / ( end - begin ) + 16u );
+          valid[i] = detail::parse_bristol_gates( bounds[i], bounds[i + 1], num_wires, chunks[i] );
+        } );
+      }
+      for ( auto& thread : threads )
+      {
+        thread.join();
+      }
+      if ( std::find( valid.begin(), valid.end(), 0u ) != valid.end() )
+      {
+        return lorina::return_code::parse_error;
+      }
+
+      gates.reserve( num_gates );
+      for ( auto const& chunk : chunks )
+      {
+        gates.insert( gates.end(), chunk.begin(), chunk.end() );
+      }
+    }
+  }
+
+  {
+    stopwatch<> t( st.time_build );
+
+    if constexpr ( detail::has_reservable_storage<Ntk>::value )
+    {
+      /* avoid regrowing the storage, which happens above 90% of the capacity */
+      const auto num_nodes = 1u + static_cast<uint64_t>( num_pis ) + gates.size();
+      ntk._storage->nodes.reserve( num_nodes * 10u / 9u + 1u );
+      ntk._storage->hash.reserve( gates.size() );
+    }
+
+    std::vector<signal<Ntk>> signals( num_wires, ntk.get_constant( false ) );
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+      signals[i] = ntk.create_pi();
+    }
+
+    /* like `bristol_reader`, the outputs are taken after the number of gates in the header */
+    const auto create_pos = [&]() {
+      for ( auto i = num_wires - num_pos; i < num_wires; ++i )
+      {
+        ntk.create_po( signals[i] );
+      }
+    };
+
+    if ( num_gates == 0u )
+    {
+      create_pos();
+    }
+    for ( auto i = 0u; i < gates.size(); ++i )
+    {
+      auto const& g = gates[i];
+      switch ( g.type )
+      {
+      case bristol_gate_type::xor_gate:
+        signals[g.out] = ntk.create_xor( signals[g.in0], signals[g.in1] );
+        break;
+      case bristol_gate_type::and_gate:
+        signals[g.out] = ntk.create_and( signals[g.in0], signals[g.in1] );
+        break;
+      case bristol_gate_type::inv_gate:
+        signals[g.out] = ntk.create_not( signals[g.in0] );
+        break;
+      case bristol_gate_type::eqw_gate:
+        signals[g.out] = signals[g.in0];
+        break;
+      case bristol_gate_type::eq_gate:
+        signals[g.out] = ntk.get_constant( g.in0 != 0u );
+        break;
+      }
+
+      if ( i + 1u == num_gates )
+      {
+        create_pos();
+      }
+    }
+
+    if ( gates.size() != num_gates )
+    {
+      fmt::print( "[w] header declares {} gates, but {} gates were read\n", num_gates, gates.size() );
+      if ( gates.size() < num_gates )
+      {
+        create_pos();
+      }
+    }
+  }
+
+  st.num_gates = gates.size();
+  if ( pst )
+  {
+    *pst = st;
+  }
+  return lorina::return_code::success;
+}
+
+/*! \brief Reads a Bristol fashion circuit from a file into a network.
+ *
+ * The file is memory-mapped, see `read_bristol_fast` for the in-memory
+ * variant.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      xag_network xag;
+      read_bristol_fast_params ps;
+      ps.num_threads = 4u;
+      if ( read_bristol_fast( "sha256.txt", xag, ps ) != lorina::return_code::success )
+        std::cerr << "parse error\n";
+   \endverbatim
+ */
+template<class Ntk>
+lorina::return_code read_bristol_fast( std::string const& filename, Ntk& ntk, read_bristol_fast_params const& ps = {}, read_bristol_fast_stats* pst = nullptr )
+{
+  mapped_file file;
+  if ( !file.open( filename ) )
+  {
+    return lorina::return_code::parse_error;
+  }
+  return read_bristol_fast( file.data(), file.size(), ntk, ps, pst );
+}
+
 } /* namespace mockturtle */
\ No newline at end of file
@@ -32,16 +32,29 @@
   \author Siang-Yun (Sonia) Lee
 
   This file implements functions to serialize a (combinational)
-  `aig_network` into a file.  The serializer should be used for
-  debugging-purpose only.  It allows to store the current state of the
-  network (including dangling and dead nodes), but does not guarantee
-  platform-independence (use, e.g., `write_verilog` instead).
+  `aig_network` or `xag_network` into a file.  The serializer should be
+  used for debugging-purpose only.  It allows to store the current state
+  of the network (including dangling and dead nodes), but does not
+  guarantee platform-independence (use, e.g., `write_verilog` instead).
+
+  Network snapshots (`write_network_snapshot`, `read_network_snapshot`)
+  store the same state in a versioned and checksummed layout, which is
+  restored from a memory-mapped file without rehashing the nodes.  They
+  are meant for checkpoints between optimization stages and for handing
+  networks to other processes on the same platform.
 */
 
 #pragma once
 
 #include "../networks/aig.hpp"
+#include "../networks/xag.hpp"
+#include "../utils/mapped_file.hpp"
+#include <cstring>
 #include <fstream>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <vector>
 #include <parallel_hashmap/phmap_dump.h>
 
 namespace mockturtle
@@ -159,7 +172,8 @@ public:
     return this->operator()( ar_input, &value->first ) && this->operator()( ar_input, &value->second );
   }
 
-  bool operator()( phmap::BinaryOutputArchive& os, aig_storage const& storage ) const
+  template<typename NodeHasher>
+  bool operator()( phmap::BinaryOutputArchive& os, storage<node_type, empty_storage_data, NodeHasher> const& storage ) const
   {
     /* nodes */
     uint64_t size = storage.nodes.size();
@@ -195,7 +209,7 @@ public:
     }
 
     /* hash */
-    if ( !const_cast<aig_storage&>( storage ).hash.dump( os ) )
+    if ( !const_cast<std::decay_t<decltype( storage )>&>( storage ).hash.dump( os ) )
     {
       return false;
     }
@@ -205,7 +219,8 @@ public:
     return true;
   }
 
-  bool operator()( phmap::BinaryInputArchive& ar_input, aig_storage* storage ) const
+  template<typename NodeHasher>
+  bool operator()( phmap::BinaryInputArchive& ar_input, storage<node_type, empty_storage_data, NodeHasher>* storage ) const
   {
     /* nodes */
     uint64_t size;
@@ -268,26 +283,43 @@ inline void serialize_network( aig_network const& aig, phmap::BinaryOutputArchiv
   assert( okay && "failed to serialize the network onto stream" );
 }
 
-/*! \brief Serializes a combinational AIG network in a file
+/*! \brief Serializes a combinational XAG network to a archive
  *
- * \param aig Combinational AIG network
+ * \param xag Combinational XAG network
+ * \param os Output archive
+ */
+inline void serialize_network( xag_network const& xag, phmap::BinaryOutputArchive& os )
+{
+  detail::serializer _serializer;
+  bool const okay = _serializer( os, *xag._storage );
+  (void)okay;
+  assert( okay && "failed to serialize the network onto stream" );
+}
+
+/*! \brief Serializes a combinational AIG or XAG network in a file
+ *
+ * \param ntk Combinational AIG or XAG network
  * \param filename Filename
  */
-inline void serialize_network( aig_network const& aig, std::string const& filename )
+template<class Ntk>
+inline void serialize_network( Ntk const& ntk, std::string const& filename )
 {
   phmap::BinaryOutputArchive ar_out( filename.c_str() );
-  serialize_network( aig, ar_out );
+  serialize_network( ntk, ar_out );
 }
 
-/*! \brief Deserializes a combinational AIG network from a input archive
+/*! \brief Deserializes a combinational AIG or XAG network from a input archive
  *
  * \param ar_input Input archive
- * \return Deserialized AIG network
+ * \return Deserialized network
  */
-inline aig_network deserialize_network( phmap::BinaryInputArchive& ar_input )
+template<class Ntk = aig_network>
+inline Ntk deserialize_network( phmap::BinaryInputArchive& ar_input )
 {
+  static_assert( std::is_same_v<Ntk, aig_network> || std::is_same_v<Ntk, xag_network>, "Ntk is not an AIG or XAG network" );
+
   detail::serializer _serializer;
-  auto storage = std::make_shared<aig_storage>();
+  auto storage = std::make_shared<typename Ntk::storage::element_type>();
   storage->nodes.clear();
   storage->inputs.clear();
   storage->outputs.clear();
@@ -296,19 +328,287 @@ inline aig_network deserialize_network( phmap::BinaryInputArchive& ar_input )
   bool const okay = _serializer( ar_input, storage.get() );
   (void)okay;
   assert( okay && "failed to deserialize the network onto stream" );
-  return aig_network{ storage };
+  return Ntk{ storage };
 }
 
-/*! \brief Deserializes a combinational AIG network from a file
+/*! \brief Deserializes a combinational AIG or XAG network from a file
  *
  * \param filename Filename
- * \return Deserialized AIG network
+ * \return Deserialized network
  */
-inline aig_network deserialize_network( std::string const& filename )
+template<class Ntk = aig_network>
+inline Ntk deserialize_network( std::string const& filename )
 {
   phmap::BinaryInputArchive ar_input( filename.c_str() );
-  auto aig = deserialize_network( ar_input );
-  return aig;
+  auto ntk = deserialize_network<Ntk>( ar_input );
+  return ntk;
+}
+
+namespace detail
+{
+
+struct network_snapshot_header
+{
+  uint32_t magic;       /* 'MTNS' */
+  uint32_t version;
+  uint32_t network;     /* 1 = aig_network, 2 = xag_network */
+  uint32_t trav_id;
+  uint32_t node_size;   /* sizeof( node_type ) */
+  uint32_t group_width; /* width of the hash table's control groups */
+  uint64_t num_nodes;
+  uint64_t num_inputs;
+  uint64_t num_outputs;
+  uint64_t payload_size;
+  uint64_t checksum;
+};
+
+inline constexpr uint32_t network_snapshot_magic = 0x534e544d;
+inline constexpr uint32_t network_snapshot_version = 1u;
+
+template<class Ntk>
+constexpr uint32_t network_snapshot_type()
+{
+  static_assert( std::is_same_v<Ntk, aig_network> || std::is_same_v<Ntk, xag_network>, "Ntk is not an AIG or XAG network" );
+  return std::is_same_v<Ntk, aig_network> ? 1u : 2u;
+}
+
+/* 64-bit checksum over four interleaved lanes, not cryptographic */
+inline uint64_t network_snapshot_checksum( char const* data, uint64_t size )
+{
+  constexpr uint64_t p1 = 0x9e3779b185ebca87ull;
+  constexpr uint64_t p2 = 0xc2b2ae3d27d4eb4full;
+  const auto round = []( uint64_t acc, uint64_t word ) {
+    acc += word * p2;
+    acc = ( acc << 31 ) | ( acc >> 33 );
+    return acc * p1;
+  };
+
+  uint64_t lanes[4] = { p1 + p2, p2, 0u, 0u - p1 };
+  uint64_t i = 0u;
+  for ( ; i + 32u <= size; i += 32u )
+  {
+    uint64_t words[4];
+    std::memcpy( words, data + i, sizeof( words ) );
+    for ( auto j = 0u; j < 4u; ++j )
+    {
+      lanes[j] = round( lanes[j], words[j] );
+    }
+  }
+
+  uint64_t h = size;
+  for ( auto j = 0u; j < 4u; ++j )
+  {
+    h = round( h ^ lanes[j], j );
+  }
+  for ( ; i < size; ++i )
+  {
+    h = round( h, static_cast<unsigned char>( data[i] ) );
+  }
+  return h ^ ( h >> 29 );
+}
+
+/* archives which let phmap dump and load its raw table to and from memory */
+struct network_snapshot_output_archive
+{
+  bool dump( char const* p, size_t size )
+  {
+    buffer.insert( buffer.end(), p, p + size );
+    return true;
+  }
+
+  template<typename V>
+  bool dump( V const& v )
+  {
+    return dump( reinterpret_cast<char const*>( &v ), sizeof( V ) );
+  }
+
+  std::vector<char> buffer;
+};
+
+struct network_snapshot_input_archive
+{
+  bool load( char* p, size_t size )
+  {
+    if ( static_cast<size_t>( end - pos ) < size )
+    {
+      return false;
+    }
+    std::memcpy( p, pos, size );
+    pos += size;
+    return true;
+  }
+
+  template<typename V>
+  bool load( V* v )
+  {
+    return load( reinterpret_cast<char*>( v ), sizeof( V ) );
+  }
+
+  char const* pos;
+  char const* end;
+};
+
+} /* namespace detail */
+
+/*! \brief Writes a snapshot of a combinational AIG or XAG network
+ *
+ * The snapshot consists of a header with a version, the network type, the
+ * sizes of all sections, and a checksum, followed by the raw nodes, inputs,
+ * outputs, and the raw structural hash table.  It captures the current state
+ * of the network, including dangling and dead nodes.
+ *
+ * The layout depends on the platform (endianness, hash table layout), which
+ * is checked when reading a snapshot.
+ *
+ * \param ntk Combinational AIG or XAG network
+ * \param os Binary output stream
+ */
+template<class Ntk>
+bool write_network_snapshot( Ntk const& ntk, std::ostream& os )
+{
+  using storage_t = typename Ntk::storage::element_type;
+  using node_type = typename storage_t::node_type;
+  static_assert( std::is_trivially_copyable_v<node_type>, "nodes must be trivially copyable" );
+
+  auto const& storage = *ntk._storage;
+
+  detail::network_snapshot_output_archive ar;
+  ar.dump( reinterpret_cast<char const*>( storage.nodes.data() ), sizeof( node_type ) * storage.nodes.size() );
+  ar.dump( reinterpret_cast<char const*>( storage.inputs.data() ), sizeof( uint64_t ) * storage.inputs.size() );
+  ar.dump( reinterpret_cast<char const*>( storage.outputs.data() ), sizeof( typename node_type::pointer_type ) * storage.outputs.size() );
+  if ( !storage.hash.dump( ar ) )
+  {
+    return false;
+  }
+
+  detail::network_snapshot_header header{};
+  header.magic = detail::network_snapshot_magic;
+  header.version = detail::network_snapshot_version;
+  header.network = detail::network_snapshot_type<Ntk>();
+  header.trav_id = storage.trav_id;
+  header.node_size = sizeof( node_type );
+  header.group_width = static_cast<uint32_t>( phmap::priv::Group::kWidth );
+  header.num_nodes = storage.nodes.size();
+  header.num_inputs = storage.inputs.size();
+  header.num_outputs = storage.outputs.size();
+  header.payload_size = ar.buffer.size();
+  header.checksum = detail::network_snapshot_checksum( ar.buffer.data(), ar.buffer.size() );
+
+  os.write( reinterpret_cast<char const*>( &header ), sizeof( header ) );
+  os.write( ar.buffer.data(), ar.buffer.size() );
+  return static_cast<bool>( os );
+}
+
+/*! \brief Writes a snapshot of a combinational AIG or XAG network to a file
+ *
+ * \param ntk Combinational AIG or XAG network
+ * \param filename Filename
+ */
+template<class Ntk>
+bool write_network_snapshot( Ntk const& ntk, std::string const& filename )
+{
+  std::ofstream os( filename, std::ofstream::binary );
+  return os.is_open() && write_network_snapshot( ntk, os );
+}
+
+/*! \brief Restores a combinational AIG or XAG network from a snapshot in memory
+ *
+ * The nodes and the structural hash table are copied as they are, no node is
+ * rehashed.  Returns `std::nullopt` if the snapshot is malformed, was
+ * written for another network type or platform, or (if `verify_checksum` is
+ * true) its checksum does not match.
+ *
+ * \param data Snapshot
+ * \param size Size of the snapshot in bytes
+ * \param verify_checksum Verify the checksum of the snapshot
+ */
+template<class Ntk = xag_network>
+std::optional<Ntk> read_network_snapshot( char const* data, uint64_t size, bool verify_checksum )
+{
+  using storage_t = typename Ntk::storage::element_type;
+  using node_type = typename storage_t::node_type;
+  using pointer_type = typename node_type::pointer_type;
+
+  detail::network_snapshot_header header;
+  if ( size < sizeof( header ) )
+  {
+    return std::nullopt;
+  }
+  std::memcpy( &header, data, sizeof( header ) );
+  if ( header.magic != detail::network_snapshot_magic || header.version != detail::network_snapshot_version ||
+       header.network != detail::network_snapshot_type<Ntk>() || header.node_size != sizeof( node_type ) ||
+       header.group_width != phmap::priv::Group::kWidth || header.payload_size != size - sizeof( header ) )
+  {
+    return std::nullopt;
+  }
+
+  char const* payload = data + sizeof( header );
+  if ( verify_checksum && detail::network_snapshot_checksum( payload, header.payload_size ) != header.checksum )
+  {
+    return std::nullopt;
+  }
+
+  /* guard the section sizes against overflows */
+  if ( header.num_nodes == 0u || header.num_nodes > header.payload_size || header.num_inputs > header.payload_size || header.num_outputs > header.payload_size ||
+       sizeof( node_type ) * header.num_nodes + sizeof( uint64_t ) * header.num_inputs + sizeof( pointer_type ) * header.num_outputs > header.payload_size )
+  {
+    return std::nullopt;
+  }
+
+  auto storage = std::make_shared<storage_t>();
+  storage->trav_id = header.trav_id;
+  storage->nodes.resize( header.num_nodes );
+  storage->inputs.resize( header.num_inputs );
+  storage->outputs.resize( header.num_outputs );
+
+  detail::network_snapshot_input_archive ar{ payload, payload + header.payload_size };
+  ar.load( reinterpret_cast<char*>( storage->nodes.data() ), sizeof( node_type ) * header.num_nodes );
+  ar.load( reinterpret_cast<char*>( storage->inputs.data() ), sizeof( uint64_t ) * header.num_inputs );
+  ar.load( reinterpret_cast<char*>( storage->outputs.data() ), sizeof( pointer_type ) * header.num_outputs );
+
+  /* check the table capacity before phmap allocates it */
+  size_t table_size, capacity;
+  auto peek = ar;
+  if ( !peek.load( &table_size ) || ( table_size != 0u && ( !peek.load( &capacity ) || capacity > static_cast<size_t>( peek.end - peek.pos ) ) ) )
+  {
+    return std::nullopt;
+  }
+  if ( !storage->hash.load( ar ) || ar.pos != ar.end )
+  {
+    return std::nullopt;
+  }
+
+  return Ntk{ storage };
+}
+
+/*! \brief Restores a combinational AIG or XAG network from a snapshot file
+ *
+ * The file is memory-mapped, see `read_network_snapshot` for the in-memory
+ * variant.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      write_network_snapshot( xag, "stage1.snap" );
+      // ... possibly in another process
+      const auto restored = read_network_snapshot<xag_network>( "stage1.snap" );
+   \endverbatim
+ *
+ * \param filename Filename
+ * \param verify_checksum Verify the checksum of the snapshot
+ */
+template<class Ntk = xag_network>
+std::optional<Ntk> read_network_snapshot( std::string const& filename, bool verify_checksum = true )
+{
+  mapped_file file;
+  if ( !file.open( filename ) )
+  {
+    return std::nullopt;
+  }
+  return read_network_snapshot<Ntk>( file.data(), file.size(), verify_checksum );
 }
 
-} /* namespace mockturtle */
\ No newline at end of file
+} /* namespace mockturtle */
@@ -79,6 +79,7 @@
 #include "mockturtle/algorithms/equivalence_checking.hpp"
 #include "mockturtle/algorithms/equivalence_classes.hpp"
 #include "mockturtle/algorithms/exact_mc_synthesis.hpp"
+#include "mockturtle/algorithms/exact_mc_synthesis_cache.hpp"
 #include "mockturtle/algorithms/exorcism.hpp"
 #include "mockturtle/algorithms/experimental/boolean_optimization.hpp"
 #include "mockturtle/algorithms/experimental/cost_generic_resub.hpp"
@@ -182,6 +183,7 @@
 #include "mockturtle/properties/xmgcost.hpp"
 #include "mockturtle/traits.hpp"
 #include "mockturtle/utils/algorithm.hpp"
+#include "mockturtle/utils/bit_utils.hpp"
 #include "mockturtle/utils/cost_functions.hpp"
 #include "mockturtle/utils/cuts.hpp"
 #include "mockturtle/utils/debugging_utils.hpp"
@@ -189,6 +191,7 @@
 #include "mockturtle/utils/include/percy.hpp"
 #include "mockturtle/utils/index_list.hpp"
 #include "mockturtle/utils/json_utils.hpp"
+#include "mockturtle/utils/minmc_database.hpp"
 #include "mockturtle/utils/mixed_radix.hpp"
 #include "mockturtle/utils/name_utils.hpp"
 #include "mockturtle/utils/network_cache.hpp"
@@ -196,12 +199,14 @@
 #include "mockturtle/utils/node_map.hpp"
 #include "mockturtle/utils/progress_bar.hpp"
 #include "mockturtle/utils/recursive_cost_functions.hpp"
+#include "mockturtle/utils/spectral_canonization_cache.hpp"
 #include "mockturtle/utils/stopwatch.hpp"
 #include "mockturtle/utils/string_utils.hpp"
 #include "mockturtle/utils/super_utils.hpp"
 #include "mockturtle/utils/tech_library.hpp"
 #include "mockturtle/utils/truth_table_cache.hpp"
 #include "mockturtle/utils/truth_table_utils.hpp"
+#include "mockturtle/utils/truth_table_stream.hpp"
 #include "mockturtle/utils/window_utils.hpp"
 #include "mockturtle/views/binding_view.hpp"
 #include "mockturtle/views/cnf_view.hpp"
@@ -0,0 +1,69 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bit_utils.hpp
+  \brief Portable bit operations on 64-bit words
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace mockturtle
+{
+
+/*! \brief Number of set bits in a 64-bit word. */
+inline uint32_t popcount64( uint64_t word )
+{
+#ifdef _MSC_VER
+  /* __popcnt64 is not available on 32-bit targets */
+  return static_cast<uint32_t>( __popcnt( static_cast<uint32_t>( word ) ) + __popcnt( static_cast<uint32_t>( word >> 32 ) ) );
+#else
+  return static_cast<uint32_t>( __builtin_popcountll( word ) );
+#endif
+}
+
+/*! \brief Index of the least significant set bit of a non-zero 64-bit word. */
+inline uint32_t ctz64( uint64_t word )
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  if ( _BitScanForward( &index, static_cast<uint32_t>( word ) ) )
+  {
+    return static_cast<uint32_t>( index );
+  }
+  _BitScanForward( &index, static_cast<uint32_t>( word >> 32 ) );
+  return static_cast<uint32_t>( index ) + 32u;
+#else
+  return static_cast<uint32_t>( __builtin_ctzll( word ) );
+#endif
+}
+
+} // namespace mockturtle
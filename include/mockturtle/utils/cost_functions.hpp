@@ -112,6 +112,23 @@ struct mc_cost
   }
 };
 
+/*! \brief Cost which ranks the number of AND gates before other gates.
+ *
+ * A gate with multiplicative complexity (see `mc_cost`) costs `AndWeight`
+ * per AND, other gates cost 1.  As long as less than `AndWeight` other gates
+ * are compared, a solution with fewer AND gates is cheaper, and among
+ * solutions with the same number of AND gates, the one with fewer XOR gates.
+ */
+template<class Ntk, uint32_t AndWeight = 1024u>
+struct and_xor_cost
+{
+  uint32_t operator()( Ntk const& ntk, node<Ntk> const& node ) const
+  {
+    const auto num_ands = mc_cost<Ntk>{}( ntk, node );
+    return num_ands == 0u ? 1u : num_ands * AndWeight;
+  }
+};
+
 struct lut_unitary_cost
 {
   std::pair<uint32_t, uint32_t> operator()( uint32_t num_leaves ) const
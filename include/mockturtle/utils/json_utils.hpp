@@ -33,6 +33,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+
 #include <kitty/dynamic_truth_table.hpp>
 #include <nlohmann/json.hpp>
 
@@ -50,4 +54,59 @@ inline void from_json( const nlohmann::json& j, dynamic_truth_table& tt )
   j.at( "_num_vars" ).get_to( tt._num_vars );
 }
 
-} // namespace kitty
\ No newline at end of file
+} // namespace kitty
+
+namespace mockturtle
+{
+
+/*! \brief Thread-safe writer for JSON lines.
+ *
+ * Writes each JSON object on a single line of `os`, such that results can be
+ * streamed and processed line by line (e.g., with `jq`).  Calls from
+ * different threads are serialized and never interleave.  If `auto_flush` is
+ * set, the stream is flushed after each line, such that results of long
+ * running jobs become visible immediately.
+ */
+class json_lines_writer
+{
+public:
+  explicit json_lines_writer( std::ostream& os, bool auto_flush = false )
+      : os( os ), auto_flush( auto_flush )
+  {
+  }
+
+  void operator()( nlohmann::json const& j )
+  {
+    auto line = j.dump();
+    line.push_back( '\n' );
+    std::lock_guard<std::mutex> lock( mutex );
+    os << line;
+    if ( auto_flush )
+    {
+      os.flush();
+    }
+    ++num_lines;
+  }
+
+  /*! \brief Flushes the underlying stream. */
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    os.flush();
+  }
+
+  /*! \brief Number of lines written so far. */
+  uint64_t size() const
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    return num_lines;
+  }
+
+private:
+  std::ostream& os;
+  bool auto_flush;
+  mutable std::mutex mutex;
+  uint64_t num_lines{0u};
+};
+
+} // namespace mockturtle
@@ -0,0 +1,181 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file mapped_file.hpp
+  \brief Read-only memory-mapped file
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mockturtle
+{
+
+/*! \brief Read-only memory-mapped file.
+ *
+ * Maps a file into memory, such that processes which open the same file
+ * share its pages through the page cache.  On platforms without `mmap`, the
+ * file is read into memory instead.  The data is 8-byte aligned in both
+ * cases.
+ */
+class mapped_file
+{
+public:
+  mapped_file() = default;
+
+  explicit mapped_file( std::string const& filename )
+  {
+    open( filename );
+  }
+
+  mapped_file( mapped_file const& ) = delete;
+  mapped_file& operator=( mapped_file const& ) = delete;
+
+  mapped_file( mapped_file&& other ) noexcept
+  {
+    *this = std::move( other );
+  }
+
+  mapped_file& operator=( mapped_file&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      close();
+      std::swap( data_, other.data_ );
+      std::swap( size_, other.size_ );
+      std::swap( mapped_, other.mapped_ );
+      std::swap( buffer_, other.buffer_ );
+    }
+    return *this;
+  }
+
+  ~mapped_file()
+  {
+    close();
+  }
+
+  /*! \brief Maps a file, returns false if it cannot be opened. */
+  bool open( std::string const& filename )
+  {
+    close();
+
+#if !defined( _WIN32 )
+    const auto fd = ::open( filename.c_str(), O_RDONLY );
+    if ( fd == -1 )
+    {
+      return false;
+    }
+    struct stat sb;
+    if ( ::fstat( fd, &sb ) == -1 )
+    {
+      ::close( fd );
+      return false;
+    }
+    if ( sb.st_size == 0 )
+    {
+      /* empty files cannot be mapped */
+      static const uint64_t empty{ 0u };
+      ::close( fd );
+      data_ = reinterpret_cast<char const*>( &empty );
+      return true;
+    }
+    void* addr = ::mmap( nullptr, sb.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if ( addr == MAP_FAILED )
+    {
+      return false;
+    }
+    data_ = static_cast<char const*>( addr );
+    size_ = sb.st_size;
+    mapped_ = true;
+#else
+    std::ifstream in( filename, std::ifstream::binary | std::ifstream::ate );
+    if ( !in.is_open() )
+    {
+      return false;
+    }
+    size_ = static_cast<uint64_t>( in.tellg() );
+    buffer_.resize( ( size_ + sizeof( uint64_t ) - 1u ) / sizeof( uint64_t ) + 1u );
+    in.seekg( 0 );
+    if ( !in.read( reinterpret_cast<char*>( buffer_.data() ), size_ ) )
+    {
+      close();
+      return false;
+    }
+    data_ = reinterpret_cast<char const*>( buffer_.data() );
+#endif
+    return true;
+  }
+
+  void close()
+  {
+#if !defined( _WIN32 )
+    if ( mapped_ )
+    {
+      ::munmap( const_cast<char*>( data_ ), size_ );
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0u;
+    mapped_ = false;
+    buffer_.clear();
+  }
+
+  bool is_open() const
+  {
+    return data_ != nullptr;
+  }
+
+  char const* data() const
+  {
+    return data_;
+  }
+
+  uint64_t size() const
+  {
+    return size_;
+  }
+
+private:
+  char const* data_{ nullptr };
+  uint64_t size_{ 0u };
+  bool mapped_{ false };
+  std::vector<uint64_t> buffer_;
+};
+
+} // namespace mockturtle
@@ -0,0 +1,385 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file minmc_database.hpp
+  \brief Memory-mapped database of 6-input min-MC XAGs
+
+  The binary format consists of a header of four words in the native byte
+  order of the machine that wrote the file
+
+      uint32_t magic;       // 'MCDB'
+      uint32_t version;     // 1
+      uint64_t num_entries;
+      uint64_t num_values;
+
+  followed by `num_entries` sorted `uint64_t` representatives,
+  `num_entries + 1` `uint32_t` offsets, and the `num_values` `uint32_t`
+  values of all index lists.  The index list of the `i`-th representative
+  is stored in `[offsets[i], offsets[i + 1])`.  The arrays are mapped
+  directly, hence the file is not portable between machines of different
+  endianness: the magic number doubles as a byte order mark, and files
+  written with the other byte order are rejected on load.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <lorina/detail/utils.hpp>
+
+#include "mapped_file.hpp"
+
+namespace mockturtle
+{
+
+namespace detail
+{
+
+struct minmc_database_header
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t num_entries;
+  uint64_t num_values;
+};
+
+inline constexpr uint32_t minmc_database_magic = 0x4244434d; /* 'MCDB' */
+inline constexpr uint32_t minmc_database_version = 1u;
+
+inline uint64_t minmc_database_file_size( uint64_t num_entries, uint64_t num_values )
+{
+  return sizeof( minmc_database_header ) + sizeof( uint64_t ) * num_entries + sizeof( uint32_t ) * ( num_entries + 1u ) + sizeof( uint32_t ) * num_values;
+}
+
+} // namespace detail
+
+/*! \brief Index list of a database entry.
+ *
+ * Points into the memory of a `minmc_database` and is valid as long as the
+ * database is open.
+ */
+struct minmc_database_entry
+{
+  uint32_t const* first{ nullptr };
+  uint32_t const* last{ nullptr };
+
+  uint32_t const* begin() const { return first; }
+  uint32_t const* end() const { return last; }
+  uint64_t size() const { return last - first; }
+
+  explicit operator bool() const { return first != nullptr; }
+};
+
+/*! \brief Read-only, memory-mapped min-MC database.
+ *
+ * Maps a database in the binary format described in `minmc_database.hpp`
+ * into memory (see `mapped_file`).  Opening only validates the header, and
+ * lookups binary search the sorted representatives and return pointers into
+ * the mapped file, so nothing is parsed or copied.  Processes which open the same file share its
+ * pages through the page cache; inside a process, one database can be shared
+ * by several `xag_minmc_resynthesis` instances (see `set_database`).
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      convert_minmc_database( "db_mc6.txt", "db_mc6.bin" );
+
+      minmc_database db( "db_mc6.bin" );
+      if ( const auto entry = db.find( repr ) )
+        xag_index_list il{ std::vector<uint32_t>( entry.begin(), entry.end() ) };
+   \endverbatim
+ */
+class minmc_database
+{
+public:
+  minmc_database() = default;
+
+  explicit minmc_database( std::string const& filename )
+  {
+    open( filename );
+  }
+
+  minmc_database( minmc_database&& other ) noexcept
+  {
+    *this = std::move( other );
+  }
+
+  minmc_database& operator=( minmc_database&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      /* the mapping does not move, hence the pointers stay valid */
+      file_ = std::move( other.file_ );
+      num_entries_ = other.num_entries_;
+      num_values_ = other.num_values_;
+      keys_ = other.keys_;
+      offsets_ = other.offsets_;
+      values_ = other.values_;
+      other.close();
+    }
+    return *this;
+  }
+
+  /*! \brief Opens a database file, returns false if it is missing or malformed. */
+  bool open( std::string const& filename )
+  {
+    close();
+    if ( !file_.open( filename ) || !read_header() )
+    {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close()
+  {
+    file_.close();
+    num_entries_ = 0u;
+    num_values_ = 0u;
+    keys_ = nullptr;
+    offsets_ = nullptr;
+    values_ = nullptr;
+  }
+
+  bool is_open() const
+  {
+    return keys_ != nullptr;
+  }
+
+  /*! \brief Number of representatives. */
+  uint64_t num_entries() const
+  {
+    return num_entries_;
+  }
+
+  /*! \brief Size of the database file in bytes. */
+  uint64_t size_in_bytes() const
+  {
+    return file_.size();
+  }
+
+  /*! \brief Looks up the index list of a representative. */
+  minmc_database_entry find( uint64_t repr ) const
+  {
+    const auto it = std::lower_bound( keys_, keys_ + num_entries_, repr );
+    if ( it == keys_ + num_entries_ || *it != repr )
+    {
+      return {};
+    }
+    return entry( it - keys_ );
+  }
+
+  /*! \brief Calls `fn( repr, entry )` for all entries in ascending order. */
+  template<typename Fn>
+  void foreach_entry( Fn&& fn ) const
+  {
+    for ( auto i = 0u; i < num_entries_; ++i )
+    {
+      fn( keys_[i], entry( i ) );
+    }
+  }
+
+private:
+  minmc_database_entry entry( uint64_t i ) const
+  {
+    if ( offsets_[i] > offsets_[i + 1] || offsets_[i + 1] > num_values_ )
+    {
+      return {};
+    }
+    return { values_ + offsets_[i], values_ + offsets_[i + 1] };
+  }
+
+  bool read_header()
+  {
+    detail::minmc_database_header header;
+    if ( file_.size() < sizeof( header ) )
+    {
+      return false;
+    }
+    std::memcpy( &header, file_.data(), sizeof( header ) );
+    /* also rejects files written with a different byte order */
+    if ( header.magic != detail::minmc_database_magic || header.version != detail::minmc_database_version )
+    {
+      return false;
+    }
+    /* guard the size computation against overflows */
+    const auto size = file_.size();
+    if ( header.num_entries > size || header.num_values > size || detail::minmc_database_file_size( header.num_entries, header.num_values ) != size )
+    {
+      return false;
+    }
+
+    num_entries_ = header.num_entries;
+    num_values_ = header.num_values;
+    keys_ = reinterpret_cast<uint64_t const*>( file_.data() + sizeof( header ) );
+    offsets_ = reinterpret_cast<uint32_t const*>( keys_ + num_entries_ );
+    values_ = offsets_ + num_entries_ + 1u;
+
+    /* the offsets are checked lazily by `find`, only the bounds are checked here */
+    return offsets_[0] == 0u && offsets_[num_entries_] == header.num_values;
+  }
+
+private:
+  mapped_file file_;
+
+  uint64_t num_entries_{ 0u };
+  uint64_t num_values_{ 0u };
+  uint64_t const* keys_{ nullptr };
+  uint32_t const* offsets_{ nullptr };
+  uint32_t const* values_{ nullptr };
+};
+
+/*! \brief Writes a min-MC database in binary format.
+ *
+ * Entries are sorted by their representative; if a representative occurs
+ * several times, the last entry is kept.
+ *
+ * \param entries Pairs of representative and index list
+ * \param os Binary output stream
+ */
+inline bool write_minmc_database( std::vector<std::pair<uint64_t, std::vector<uint32_t>>> entries, std::ostream& os )
+{
+  std::stable_sort( entries.begin(), entries.end(), []( auto const& a, auto const& b ) { return a.first < b.first; } );
+  std::vector<std::pair<uint64_t, std::vector<uint32_t>>> unique;
+  for ( auto& entry : entries )
+  {
+    if ( !unique.empty() && unique.back().first == entry.first )
+    {
+      unique.back() = std::move( entry );
+    }
+    else
+    {
+      unique.push_back( std::move( entry ) );
+    }
+  }
+
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> offsets{ 0u };
+  uint64_t num_values{ 0u };
+  for ( auto const& [repr, index_list] : unique )
+  {
+    keys.push_back( repr );
+    num_values += index_list.size();
+    if ( num_values > UINT32_MAX )
+    {
+      return false;
+    }
+    offsets.push_back( static_cast<uint32_t>( num_values ) );
+  }
+
+  const detail::minmc_database_header header{ detail::minmc_database_magic, detail::minmc_database_version, keys.size(), num_values };
+  os.write( reinterpret_cast<char const*>( &header ), sizeof( header ) );
+  os.write( reinterpret_cast<char const*>( keys.data() ), sizeof( uint64_t ) * keys.size() );
+  os.write( reinterpret_cast<char const*>( offsets.data() ), sizeof( uint32_t ) * offsets.size() );
+  for ( auto const& [_, index_list] : unique )
+  {
+    (void)_;
+    os.write( reinterpret_cast<char const*>( index_list.data() ), sizeof( uint32_t ) * index_list.size() );
+  }
+  return static_cast<bool>( os );
+}
+
+/*! \brief Converts a text min-MC database into binary format.
+ *
+ * Every line of the text format is of the form `<hex> <x> <y> <i0>,<i1>,...`,
+ * where `<hex>` is the truth table of the 6-input representative and the
+ * last column its index list (the format read by
+ * `future::xag_minmc_resynthesis::load_from_file`).  Malformed lines are
+ * skipped.
+ *
+ * \param in Text input stream
+ * \param os Binary output stream
+ */
+inline bool convert_minmc_database( std::istream& in, std::ostream& os )
+{
+  std::vector<std::pair<uint64_t, std::vector<uint32_t>>> entries;
+  kitty::dynamic_truth_table func( 6u );
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    if ( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    const auto vline = lorina::detail::split( line, " " );
+    if ( vline.size() < 4u || vline[0].size() != 16u )
+    {
+      continue;
+    }
+    kitty::create_from_hex_string( func, vline[0] );
+
+    std::vector<uint32_t> index_list;
+    bool valid{ true };
+    for ( auto const& s : lorina::detail::split( vline[3], "," ) )
+    {
+      char* end;
+      const auto value = std::strtoul( s.c_str(), &end, 10 );
+      if ( s.empty() || *end != '\0' )
+      {
+        valid = false;
+        break;
+      }
+      index_list.push_back( static_cast<uint32_t>( value ) );
+    }
+    if ( valid )
+    {
+      entries.emplace_back( *func.cbegin(), std::move( index_list ) );
+    }
+  }
+  return write_minmc_database( std::move( entries ), os );
+}
+
+/*! \brief Converts a text min-MC database file into binary format. */
+inline bool convert_minmc_database( std::string const& text_filename, std::string const& binary_filename )
+{
+  std::ifstream in( text_filename, std::ifstream::in );
+  if ( !in.is_open() )
+  {
+    return false;
+  }
+  std::ofstream os( binary_filename, std::ofstream::binary );
+  if ( !os.is_open() )
+  {
+    return false;
+  }
+  return convert_minmc_database( in, os );
+}
+
+} // namespace mockturtle
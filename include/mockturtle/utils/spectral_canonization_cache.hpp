@@ -0,0 +1,405 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file spectral_canonization_cache.hpp
+  \brief Concurrent cache for spectral canonization
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/spectral.hpp>
+#include <parallel_hashmap/phmap.h>
+
+namespace mockturtle
+{
+
+struct spectral_canonization_cache_params
+{
+  /*! \brief Maximum number of cached functions (0 means unbounded). */
+  uint64_t capacity{ 1u << 20 };
+
+  /*! \brief Number of independently locked shards. */
+  uint32_t num_shards{ 64u };
+};
+
+struct spectral_canonization_cache_stats
+{
+  /*! \brief Number of cache hits. */
+  uint64_t hits{};
+
+  /*! \brief Number of cache misses. */
+  uint64_t misses{};
+
+  /*! \brief Number of evicted entries. */
+  uint64_t evictions{};
+
+  /*! \brief Number of cached functions. */
+  uint64_t size{};
+
+  void report() const
+  {
+    fmt::print( "[i] canonization cache: size = {}, hits = {}, misses = {}, evictions = {}\n", size, hits, misses, evictions );
+  }
+};
+
+/*! \brief Concurrent cache for spectral canonization.
+ *
+ * Memoizes the affine representative and the spectral transformations
+ * computed by `kitty::hybrid_exact_spectral_canonization` for functions with
+ * up to 6 variables.  The cache is split into shards, which are selected by
+ * the hash of the function and locked independently, such that many threads
+ * can share one cache.  Canonization itself runs outside of the locks.
+ *
+ * Each shard holds at most `capacity / num_shards` entries and evicts with
+ * the CLOCK (second chance) policy: a hit sets the reference bit of an entry;
+ * when the clock hand reaches an entry with the bit set, the bit is cleared
+ * and the entry is spared once, otherwise the entry is evicted.  Hence, an
+ * entry survives at most one more sweep, regardless of how many hits it had.
+ *
+ * If a file name is passed to the constructor, the cache is loaded from it
+ * (if it exists) and saved to it in the destructor.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      auto cache = std::make_shared<spectral_canonization_cache>();
+      const auto [repr, trans] = ( *cache )( func );
+   \endverbatim
+ */
+class spectral_canonization_cache
+{
+public:
+  using transformation_t = std::vector<kitty::detail::spectral_operation>;
+
+private:
+  struct key_t
+  {
+    uint64_t word;
+    uint32_t num_vars;
+
+    bool operator==( key_t const& other ) const
+    {
+      return word == other.word && num_vars == other.num_vars;
+    }
+  };
+
+  struct key_hash
+  {
+    uint64_t operator()( key_t const& key ) const
+    {
+      /* splitmix64 finalizer */
+      uint64_t h = key.word + 0x9e3779b97f4a7c15ull * ( key.num_vars + 1u );
+      h = ( h ^ ( h >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+      h = ( h ^ ( h >> 27 ) ) * 0x94d049bb133111ebull;
+      return h ^ ( h >> 31 );
+    }
+  };
+
+  struct entry_t
+  {
+    key_t key;
+    uint64_t repr;
+    transformation_t trans;
+    bool referenced;
+  };
+
+  struct shard_t
+  {
+    std::mutex mutex;
+    phmap::flat_hash_map<key_t, uint32_t, key_hash> index;
+    std::vector<entry_t> entries;
+    uint32_t hand{ 0u };
+  };
+
+public:
+  explicit spectral_canonization_cache( spectral_canonization_cache_params const& ps = {}, std::string const& cache_filename = {} )
+      : shards_( std::max( 1u, ps.num_shards ) ),
+        shard_capacity_( ps.capacity == 0u ? UINT64_MAX : std::max<uint64_t>( 1u, ( ps.capacity + shards_.size() - 1u ) / shards_.size() ) ),
+        cache_filename_( cache_filename )
+  {
+    if ( !cache_filename_.empty() )
+    {
+      load( cache_filename_ );
+    }
+  }
+
+  spectral_canonization_cache( spectral_canonization_cache const& ) = delete;
+  spectral_canonization_cache& operator=( spectral_canonization_cache const& ) = delete;
+
+  ~spectral_canonization_cache()
+  {
+    if ( !cache_filename_.empty() )
+    {
+      save( cache_filename_ );
+    }
+  }
+
+  /*! \brief Returns the representative and the transformations of a function.
+   *
+   * Functions with more than 6 variables are canonized without caching.
+   */
+  std::pair<uint64_t, transformation_t> operator()( kitty::dynamic_truth_table const& func )
+  {
+    std::pair<uint64_t, transformation_t> result;
+    if ( func.num_vars() > 6u )
+    {
+      ++misses_;
+      result.first = *kitty::hybrid_exact_spectral_canonization( func, [&]( auto const& ops ) { result.second = ops; } ).cbegin();
+      return result;
+    }
+
+    const key_t key{ *func.cbegin(), func.num_vars() };
+    if ( lookup( key, result ) )
+    {
+      ++hits_;
+      return result;
+    }
+
+    ++misses_;
+    result.first = *kitty::hybrid_exact_spectral_canonization( func, [&]( auto const& ops ) { result.second = ops; } ).cbegin();
+    insert( key, result.first, result.second );
+    return result;
+  }
+
+  /*! \brief Removes all entries. */
+  void clear()
+  {
+    for ( auto& shard : shards_ )
+    {
+      std::lock_guard<std::mutex> lock( shard.mutex );
+      shard.index.clear();
+      shard.entries.clear();
+      shard.hand = 0u;
+    }
+  }
+
+  /*! \brief Number of cached functions. */
+  uint64_t size() const
+  {
+    uint64_t total{ 0u };
+    for ( auto& shard : shards_ )
+    {
+      std::lock_guard<std::mutex> lock( shard.mutex );
+      total += shard.entries.size();
+    }
+    return total;
+  }
+
+  spectral_canonization_cache_stats stats() const
+  {
+    return { hits_.load(), misses_.load(), evictions_.load(), size() };
+  }
+
+  /*! \brief Loads entries from a binary file (if it exists).
+   *
+   * The file consists of one record per function: the number of variables
+   * (`uint32_t`), the truth table and its representative (`uint64_t` each),
+   * the number of operations (`uint32_t`), and the operations as triples of
+   * `uint16_t` (kind, first and second variable).  Variables are stored as
+   * masks `1 << i` like in kitty's spectral operations.  The file is rejected
+   * as a whole if any record is truncated or contains an unknown operation or
+   * a variable outside the function's support.
+   */
+  bool load( std::string const& filename )
+  {
+    std::ifstream in( filename, std::ifstream::in | std::ifstream::binary );
+    if ( !in.is_open() )
+    {
+      return false;
+    }
+
+    std::vector<std::tuple<key_t, uint64_t, transformation_t>> records;
+    uint32_t num_vars, num_ops;
+    uint64_t word, repr;
+    while ( in.read( reinterpret_cast<char*>( &num_vars ), sizeof( num_vars ) ) )
+    {
+      in.read( reinterpret_cast<char*>( &word ), sizeof( word ) );
+      in.read( reinterpret_cast<char*>( &repr ), sizeof( repr ) );
+      in.read( reinterpret_cast<char*>( &num_ops ), sizeof( num_ops ) );
+      if ( !in || num_vars > 6u || num_ops > 1024u )
+      {
+        fmt::print( "[w] corrupt spectral canonization cache {}\n", filename );
+        return false;
+      }
+
+      transformation_t trans( num_ops );
+      bool valid = true;
+      for ( auto& op : trans )
+      {
+        uint16_t data[3];
+        in.read( reinterpret_cast<char*>( data ), sizeof( data ) );
+        valid = valid && is_valid_operation( data, num_vars );
+        op = kitty::detail::spectral_operation( static_cast<kitty::detail::spectral_operation::kind>( data[0] ), data[1], data[2] );
+      }
+      if ( !in || !valid )
+      {
+        fmt::print( "[w] corrupt spectral canonization cache {}\n", filename );
+        return false;
+      }
+      records.emplace_back( key_t{ word, num_vars }, repr, std::move( trans ) );
+    }
+
+    for ( auto const& [key, r, trans] : records )
+    {
+      insert( key, r, trans );
+    }
+    return true;
+  }
+
+  /*! \brief Saves all entries to a binary file. */
+  bool save( std::string const& filename ) const
+  {
+    std::ofstream out( filename, std::ofstream::out | std::ofstream::binary );
+    if ( !out.is_open() )
+    {
+      return false;
+    }
+
+    for ( auto& shard : shards_ )
+    {
+      std::lock_guard<std::mutex> lock( shard.mutex );
+      for ( auto const& e : shard.entries )
+      {
+        const auto num_ops = static_cast<uint32_t>( e.trans.size() );
+        out.write( reinterpret_cast<char const*>( &e.key.num_vars ), sizeof( e.key.num_vars ) );
+        out.write( reinterpret_cast<char const*>( &e.key.word ), sizeof( e.key.word ) );
+        out.write( reinterpret_cast<char const*>( &e.repr ), sizeof( e.repr ) );
+        out.write( reinterpret_cast<char const*>( &num_ops ), sizeof( num_ops ) );
+        for ( auto const& op : e.trans )
+        {
+          const uint16_t data[3] = { static_cast<uint16_t>( op._kind ), op._var1, op._var2 };
+          out.write( reinterpret_cast<char const*>( data ), sizeof( data ) );
+        }
+      }
+    }
+    return static_cast<bool>( out );
+  }
+
+private:
+  /* operations store variables as single-bit masks, unused variables are 0 */
+  static bool is_valid_operation( uint16_t const ( &data )[3], uint32_t num_vars )
+  {
+    using kind = kitty::detail::spectral_operation::kind;
+
+    const auto is_var = [&]( uint16_t mask ) {
+      return mask != 0u && ( mask & ( mask - 1u ) ) == 0u && mask < ( 1u << num_vars );
+    };
+
+    switch ( static_cast<kind>( data[0] ) )
+    {
+    case kind::none:
+    case kind::output_negation:
+      return data[1] == 0u && data[2] == 0u;
+    case kind::input_negation:
+    case kind::disjoint_translation:
+      return is_var( data[1] ) && data[2] == 0u;
+    case kind::permutation:
+    case kind::spectral_translation:
+      return is_var( data[1] ) && is_var( data[2] );
+    default:
+      return false;
+    }
+  }
+
+  shard_t& shard_of( key_t const& key )
+  {
+    return shards_[( key_hash{}( key ) >> 32 ) % shards_.size()];
+  }
+
+  bool lookup( key_t const& key, std::pair<uint64_t, transformation_t>& result )
+  {
+    auto& shard = shard_of( key );
+    std::lock_guard<std::mutex> lock( shard.mutex );
+    const auto it = shard.index.find( key );
+    if ( it == shard.index.end() )
+    {
+      return false;
+    }
+    auto& e = shard.entries[it->second];
+    e.referenced = true;
+    result.first = e.repr;
+    result.second = e.trans;
+    return true;
+  }
+
+  void insert( key_t const& key, uint64_t repr, transformation_t const& trans )
+  {
+    auto& shard = shard_of( key );
+    std::lock_guard<std::mutex> lock( shard.mutex );
+    if ( shard.index.count( key ) )
+    {
+      /* another thread was faster */
+      return;
+    }
+
+    if ( shard.entries.size() < shard_capacity_ )
+    {
+      shard.index.emplace( key, static_cast<uint32_t>( shard.entries.size() ) );
+      shard.entries.push_back( { key, repr, trans, false } );
+      return;
+    }
+
+    /* CLOCK eviction: clear reference bits until an unreferenced entry is found */
+    while ( shard.entries[shard.hand].referenced )
+    {
+      shard.entries[shard.hand].referenced = false;
+      shard.hand = ( shard.hand + 1u ) % shard.entries.size();
+    }
+    auto& victim = shard.entries[shard.hand];
+    shard.index.erase( victim.key );
+    victim = { key, repr, trans, false };
+    shard.index.emplace( key, shard.hand );
+    shard.hand = ( shard.hand + 1u ) % shard.entries.size();
+    ++evictions_;
+  }
+
+private:
+  mutable std::vector<shard_t> shards_;
+  uint64_t shard_capacity_;
+  std::string cache_filename_;
+
+  std::atomic<uint64_t> hits_{ 0u };
+  std::atomic<uint64_t> misses_{ 0u };
+  std::atomic<uint64_t> evictions_{ 0u };
+};
+
+} // namespace mockturtle
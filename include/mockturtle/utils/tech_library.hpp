@@ -36,7 +36,16 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <kitty/constructors.hpp>
@@ -50,6 +59,7 @@
 #include <parallel_hashmap/phmap.h>
 
 #include "../io/genlib_reader.hpp"
+#include "../io/serialize.hpp"
 #include "../io/super_reader.hpp"
 #include "include/supergate.hpp"
 #include "standard_cell.hpp"
@@ -1082,6 +1092,43 @@ struct exact_supergate
       : root( root ) {}
 };
 
+/*! \cond PRIVATE */
+namespace detail
+{
+
+struct exact_library_file_header
+{
+  uint32_t magic; /* 'MTEL' */
+  uint32_t version;
+  uint32_t num_inputs;
+  uint32_t signal_size;
+  uint64_t key; /* hash of the rewriting function type, its database, and the parameters */
+  uint64_t database_size;
+  uint64_t num_classes;
+  uint64_t num_dc_classes;
+  uint64_t payload_size;
+  uint64_t checksum;
+};
+
+inline constexpr uint32_t exact_library_file_magic = 0x4c45544d;
+inline constexpr uint32_t exact_library_file_version = 1u;
+
+template<class RewritingFn, class = void>
+struct has_database_fingerprint : std::false_type
+{
+};
+
+template<class RewritingFn>
+struct has_database_fingerprint<RewritingFn, std::void_t<decltype( std::declval<RewritingFn const&>().database_fingerprint() )>> : std::true_type
+{
+};
+
+template<class RewritingFn>
+inline constexpr bool has_database_fingerprint_v = has_database_fingerprint<RewritingFn>::value;
+
+} /* namespace detail */
+/*! \endcond */
+
 struct exact_library_params
 {
   /* area of a gate */
@@ -1118,6 +1165,26 @@ struct exact_library_params
       mockturtle::mig_npn_resynthesis mig_resyn{true};
       mockturtle::exact_library<mockturtle::mig_network, mockturtle::mig_npn_resynthesis> lib( mig_resyn );
    \endverbatim
+ *
+ * Libraries over AIGs and XAGs can be saved to a binary file and loaded
+ * from it instead of being built.  The file consists of a header with a
+ * checksum and a key, followed by a snapshot of the database (see
+ * `write_network_snapshot`) and the supergates and DC classes.  The key
+ * identifies the type of the rewriting function, `NInputs`, and the
+ * parameters, a file with a different key is not loaded.  If the rewriting
+ * function has a method `uint64_t database_fingerprint() const`, which
+ * hashes the contents of its database, the fingerprint is part of the key
+ * too, such that changing the database invalidates the file.  Like network
+ * snapshots, the file depends on the platform and the compiler.
+ *
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      mockturtle::xag_npn_resynthesis<mockturtle::xag_network> resyn;
+      // loads the library if the file matches, builds and saves it otherwise
+      mockturtle::exact_library<mockturtle::xag_network, decltype( resyn )> lib( resyn, {}, "xag_npn.lib" );
+   \endverbatim
  */
 template<typename Ntk, class RewritingFn, unsigned NInputs = 4u>
 class exact_library
@@ -1142,6 +1209,33 @@ public:
     generate_library();
   }
 
+  /*! \brief Loads the library from a file or builds it.
+   *
+   * If `filename` cannot be loaded, e.g., because it does not exist or was
+   * written with different parameters, the library is built and saved to
+   * `filename`.
+   */
+  exact_library( RewritingFn const& rewriting_fn, exact_library_params const& ps, std::string const& filename )
+      : _database(),
+        _rewriting_fn( rewriting_fn ),
+        _ps( ps ),
+        _super_lib(),
+        _dc_lib()
+  {
+    if ( load( filename ) )
+    {
+      if ( _ps.verbose )
+      {
+        std::cout << "Loaded library from " << filename << std::endl;
+      }
+      return;
+    }
+
+    _super_lib.reserve( 222 );
+    generate_library();
+    save( filename );
+  }
+
   /*! \brief Get the structures matching the function.
    *
    * Returns a list of graph structures that match the function
@@ -1224,7 +1318,248 @@ public:
     return std::make_pair( _ps.area_inverter, _ps.delay_inverter );
   }
 
+  /*! \brief Saves the library to a binary stream.
+   *
+   * Returns false if the database is neither an AIG nor an XAG.
+   */
+  bool save( std::ostream& os ) const
+  {
+    if constexpr ( has_library_file_v )
+    {
+      std::vector<char> payload;
+      {
+        std::ostringstream snapshot;
+        write_network_snapshot( _database, snapshot );
+        const auto data = snapshot.str();
+        payload.insert( payload.end(), data.begin(), data.end() );
+      }
+      const auto database_size = payload.size();
+
+      const auto append = [&]( auto const& value ) {
+        auto const* p = reinterpret_cast<char const*>( &value );
+        payload.insert( payload.end(), p, p + sizeof( value ) );
+      };
+
+      /* supergates, DC classes refer to them by their class */
+      std::unordered_map<supergates_list_t const*, TT> classes;
+      for ( auto const& [tt, supergates] : _super_lib )
+      {
+        classes.emplace( &supergates, tt );
+        append( tt._bits );
+        append( static_cast<uint32_t>( supergates.size() ) );
+        for ( auto const& sg : supergates )
+        {
+          append( sg.root.data );
+          append( sg.n_inputs );
+          append( sg.polarity );
+          append( sg.area );
+          append( sg.worstDelay );
+          append( sg.tdelay );
+        }
+      }
+
+      for ( auto const& [tt, entries] : _dc_lib )
+      {
+        append( tt._bits );
+        append( static_cast<uint32_t>( entries.size() ) );
+        for ( auto const& [dc, transformation] : entries )
+        {
+          append( dc._bits );
+          append( classes.at( std::get<0>( transformation ) )._bits );
+          append( std::get<1>( transformation ) );
+          append( std::get<2>( transformation ) );
+        }
+      }
+
+      detail::exact_library_file_header header{};
+      header.magic = detail::exact_library_file_magic;
+      header.version = detail::exact_library_file_version;
+      header.num_inputs = NInputs;
+      header.signal_size = sizeof( signal<Ntk> );
+      header.key = library_key();
+      header.database_size = database_size;
+      header.num_classes = _super_lib.size();
+      header.num_dc_classes = _dc_lib.size();
+      header.payload_size = payload.size();
+      header.checksum = detail::network_snapshot_checksum( payload.data(), payload.size() );
+
+      os.write( reinterpret_cast<char const*>( &header ), sizeof( header ) );
+      os.write( payload.data(), payload.size() );
+      return static_cast<bool>( os );
+    }
+    else
+    {
+      (void)os;
+      return false;
+    }
+  }
+
+  /*! \brief Saves the library to a binary file. */
+  bool save( std::string const& filename ) const
+  {
+    if constexpr ( has_library_file_v )
+    {
+      std::ofstream os( filename, std::ofstream::binary );
+      return os.is_open() && save( os );
+    }
+    else
+    {
+      (void)filename;
+      return false;
+    }
+  }
+
+  /*! \brief Loads the library from memory.
+   *
+   * Returns false, and leaves the library unchanged, if the data is not a
+   * library with the same key or if its checksum does not match.
+   */
+  bool load( char const* data, uint64_t size )
+  {
+    if constexpr ( has_library_file_v )
+    {
+      detail::exact_library_file_header header;
+      if ( size < sizeof( header ) )
+      {
+        return false;
+      }
+      std::memcpy( &header, data, sizeof( header ) );
+      if ( header.magic != detail::exact_library_file_magic || header.version != detail::exact_library_file_version ||
+           header.num_inputs != NInputs || header.signal_size != sizeof( signal<Ntk> ) || header.key != library_key() ||
+           header.payload_size != size - sizeof( header ) || header.database_size > header.payload_size )
+      {
+        return false;
+      }
+      char const* pos = data + sizeof( header );
+      char const* end = pos + header.payload_size;
+      if ( detail::network_snapshot_checksum( pos, header.payload_size ) != header.checksum )
+      {
+        return false;
+      }
+
+      /* the payload is covered by the checksum */
+      auto database = read_network_snapshot<Ntk>( pos, header.database_size, false );
+      if ( !database )
+      {
+        return false;
+      }
+      pos += header.database_size;
+
+      const auto read = [&]( auto& value ) {
+        if ( static_cast<uint64_t>( end - pos ) < sizeof( value ) )
+        {
+          return false;
+        }
+        std::memcpy( &value, pos, sizeof( value ) );
+        pos += sizeof( value );
+        return true;
+      };
+
+      lib_t super_lib;
+      super_lib.reserve( header.num_classes );
+      for ( auto i = 0u; i < header.num_classes; ++i )
+      {
+        TT tt;
+        uint32_t num_supergates;
+        if ( !read( tt._bits ) || !read( num_supergates ) )
+        {
+          return false;
+        }
+        auto& supergates = super_lib[tt];
+        for ( auto j = 0u; j < num_supergates; ++j )
+        {
+          signal<Ntk> root;
+          if ( !read( root.data ) )
+          {
+            return false;
+          }
+          exact_supergate<Ntk, NInputs> sg( root );
+          if ( !read( sg.n_inputs ) || !read( sg.polarity ) || !read( sg.area ) || !read( sg.worstDelay ) || !read( sg.tdelay ) || database->get_node( root ) >= database->size() )
+          {
+            return false;
+          }
+          supergates.push_back( sg );
+        }
+      }
+
+      dc_lib_t dc_lib;
+      for ( auto i = 0u; i < header.num_dc_classes; ++i )
+      {
+        TT tt;
+        uint32_t num_entries;
+        if ( !read( tt._bits ) || !read( num_entries ) )
+        {
+          return false;
+        }
+        auto& entries = dc_lib[tt];
+        for ( auto j = 0u; j < num_entries; ++j )
+        {
+          TT dc, cls;
+          uint32_t phase;
+          std::array<uint8_t, NInputs> perm;
+          if ( !read( dc._bits ) || !read( cls._bits ) || !read( phase ) || !read( perm ) )
+          {
+            return false;
+          }
+          const auto it = super_lib.find( cls );
+          if ( it == super_lib.end() )
+          {
+            return false;
+          }
+          entries.emplace_back( dc, std::make_tuple( &it->second, phase, perm ) );
+        }
+      }
+
+      if ( pos != end )
+      {
+        return false;
+      }
+
+      /* moving the maps keeps the addresses of their values */
+      _database = *database;
+      _super_lib = std::move( super_lib );
+      _dc_lib = std::move( dc_lib );
+      return true;
+    }
+    else
+    {
+      (void)data;
+      (void)size;
+      return false;
+    }
+  }
+
+  /*! \brief Loads the library from a memory-mapped file. */
+  bool load( std::string const& filename )
+  {
+    mapped_file file;
+    return file.open( filename ) && load( file.data(), file.size() );
+  }
+
 private:
+  static constexpr bool has_library_file_v = std::is_same_v<Ntk, aig_network> || std::is_same_v<Ntk, xag_network>;
+
+  /* identifies the rewriting function type and its database, the number of inputs, and the parameters */
+  uint64_t library_key() const
+  {
+    std::string key = typeid( RewritingFn ).name();
+    const auto append = [&]( auto const& value ) {
+      key.append( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+    };
+    if constexpr ( detail::has_database_fingerprint_v<RewritingFn> )
+    {
+      append( static_cast<uint64_t>( _rewriting_fn.database_fingerprint() ) );
+    }
+    append( NInputs );
+    append( _ps.area_gate );
+    append( _ps.area_inverter );
+    append( _ps.delay_gate );
+    append( _ps.delay_inverter );
+    append( _ps.np_classification );
+    append( _ps.compute_dc_classes );
+    return detail::network_snapshot_checksum( key.data(), key.size() );
+  }
+
   void generate_library()
   {
     std::vector<signal<Ntk>> pis;
@@ -0,0 +1,354 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2022  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file truth_table_stream.hpp
+  \brief Parallel processing of streamed truth tables
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include "stopwatch.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Input format of a truth table stream. */
+enum class truth_table_format
+{
+  /*! \brief One hexadecimal truth table per line (optional `0x` prefix, `#` starts a comment). */
+  hex,
+  /*! \brief Consecutive little-endian `uint64_t` words, `2^(num_vars - 6)` words per function. */
+  binary
+};
+
+struct truth_table_stream_params
+{
+  /*! \brief Input format. */
+  truth_table_format format{ truth_table_format::hex };
+
+  /*! \brief Number of variables (0 infers it from the hex string length, or 6 for binary input). */
+  uint32_t num_vars{ 0u };
+
+  /*! \brief Number of functions handed to a worker at once. */
+  uint32_t chunk_size{ 1024u };
+
+  /*! \brief Maximum number of chunks read ahead (0 means twice the number of threads). */
+  uint32_t max_pending_chunks{ 0u };
+
+  /*! \brief Number of worker threads (0 means hardware concurrency). */
+  uint32_t num_threads{ 0u };
+};
+
+struct truth_table_stream_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{ 0 };
+
+  /*! \brief Time spent reading and parsing the input. */
+  stopwatch<>::duration time_read{ 0 };
+
+  /*! \brief Time the reader waited for workers to catch up. */
+  stopwatch<>::duration time_wait{ 0 };
+
+  /*! \brief Number of processed functions. */
+  uint64_t num_functions{ 0u };
+
+  /*! \brief Number of skipped malformed entries. */
+  uint64_t num_invalid{ 0u };
+
+  void report() const
+  {
+    fmt::print( "[i] functions = {} ({} invalid)\n", num_functions, num_invalid );
+    fmt::print( "[i] total time = {:>5.2f} secs\n", to_seconds( time_total ) );
+    fmt::print( "[i]   read     = {:>5.2f} secs\n", to_seconds( time_read ) );
+    fmt::print( "[i]   waiting  = {:>5.2f} secs\n", to_seconds( time_wait ) );
+  }
+};
+
+namespace detail
+{
+
+class truth_table_stream_reader
+{
+public:
+  truth_table_stream_reader( std::istream& in, truth_table_stream_params const& ps, truth_table_stream_stats& st )
+      : in( in ), ps( ps ), st( st )
+  {
+  }
+
+  /* reads at most `ps.chunk_size` functions into `chunk`, returns false at the end of the stream */
+  bool read_chunk( std::vector<std::pair<uint64_t, kitty::dynamic_truth_table>>& chunk )
+  {
+    chunk.clear();
+    while ( chunk.size() < ps.chunk_size )
+    {
+      kitty::dynamic_truth_table tt;
+      if ( !( ps.format == truth_table_format::hex ? read_hex( tt ) : read_binary( tt ) ) )
+      {
+        break;
+      }
+      chunk.emplace_back( index++, std::move( tt ) );
+    }
+    return !chunk.empty();
+  }
+
+private:
+  bool read_hex( kitty::dynamic_truth_table& tt )
+  {
+    while ( std::getline( in, line ) )
+    {
+      auto begin = line.find_first_not_of( " \t\r" );
+      auto end = std::min( line.find( '#' ), line.size() );
+      if ( begin == std::string::npos || begin >= end )
+      {
+        continue;
+      }
+      while ( end > begin && std::isspace( static_cast<unsigned char>( line[end - 1] ) ) )
+      {
+        --end;
+      }
+      if ( end - begin > 2u && line[begin] == '0' && ( line[begin + 1] == 'x' || line[begin + 1] == 'X' ) )
+      {
+        begin += 2;
+      }
+
+      const auto hex = line.substr( begin, end - begin );
+      const auto num_vars = hex_num_vars( hex );
+      if ( num_vars < 0 || ( ps.num_vars != 0u && static_cast<uint32_t>( num_vars ) != std::max( ps.num_vars, 2u ) ) )
+      {
+        ++st.num_invalid;
+        continue;
+      }
+
+      tt = kitty::dynamic_truth_table( ps.num_vars != 0u ? ps.num_vars : static_cast<uint32_t>( num_vars ) );
+      kitty::create_from_hex_string( tt, hex );
+      return true;
+    }
+    return false;
+  }
+
+  bool read_binary( kitty::dynamic_truth_table& tt )
+  {
+    const auto num_vars = ps.num_vars != 0u ? ps.num_vars : 6u;
+    const auto num_words = num_vars <= 6u ? 1u : 1u << ( num_vars - 6u );
+
+    words.resize( num_words );
+    if ( !in.read( reinterpret_cast<char*>( words.data() ), sizeof( uint64_t ) * num_words ) )
+    {
+      if ( in.gcount() != 0 )
+      {
+        ++st.num_invalid;
+      }
+      return false;
+    }
+
+    tt = kitty::dynamic_truth_table( num_vars );
+    kitty::create_from_words( tt, words.begin(), words.end() );
+    return true;
+  }
+
+  /* number of variables of a hex string, or -1 if malformed */
+  static int32_t hex_num_vars( std::string const& hex )
+  {
+    if ( hex.empty() || !std::all_of( hex.begin(), hex.end(), []( unsigned char c ) { return std::isxdigit( c ) != 0; } ) )
+    {
+      return -1;
+    }
+    const auto size = hex.size();
+    if ( ( size & ( size - 1 ) ) != 0u )
+    {
+      return -1;
+    }
+    int32_t num_vars = 2;
+    while ( ( 1ull << ( num_vars - 2 ) ) < size )
+    {
+      ++num_vars;
+    }
+    return num_vars;
+  }
+
+private:
+  std::istream& in;
+  truth_table_stream_params const& ps;
+  truth_table_stream_stats& st;
+
+  std::string line;
+  std::vector<uint64_t> words;
+  uint64_t index{ 0u };
+};
+
+} // namespace detail
+
+/*! \brief Processes a stream of truth tables in parallel.
+ *
+ * Reads truth tables from `in` (see `truth_table_format`) and calls
+ * `fn( index, tt, thread_id )` for each of them, where `index` is the
+ * position of the function in the stream (malformed entries are skipped and
+ * do not get an index) and `thread_id` is in `[0, num_threads)`.
+ *
+ * The calling thread reads the input in chunks of `chunk_size` functions and
+ * pushes them into a bounded queue, from which the worker threads pull their
+ * next chunk as soon as they are done with the current one.  When the queue
+ * holds `max_pending_chunks` chunks the reader blocks, such that at most
+ * `(max_pending_chunks + num_threads) * chunk_size` functions are in memory
+ * at any time, independent of the length of the stream.
+ *
+ * `fn` is called concurrently from different threads and is responsible for
+ * synchronizing access to shared state; functions are processed out of order.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      std::ifstream in( "functions.txt" );
+      json_lines_writer out( std::cout );
+      process_truth_table_stream( in, [&]( uint64_t index, kitty::dynamic_truth_table const& tt, uint32_t ) {
+        out( { { "index", index }, { "function", kitty::to_hex( tt ) } } );
+      } );
+   \endverbatim
+ */
+template<class Fn>
+void process_truth_table_stream( std::istream& in, Fn&& fn, truth_table_stream_params const& ps = {}, truth_table_stream_stats* pst = nullptr )
+{
+  using chunk_t = std::vector<std::pair<uint64_t, kitty::dynamic_truth_table>>;
+  using clock = stopwatch<>::clock;
+
+  truth_table_stream_stats st;
+  const auto t_start = clock::now();
+
+  const auto num_threads = std::max( 1u, ps.num_threads ? ps.num_threads : std::thread::hardware_concurrency() );
+  const auto capacity = std::max<std::size_t>( 1u, ps.max_pending_chunks ? ps.max_pending_chunks : 2u * num_threads );
+
+  std::mutex mutex;
+  std::condition_variable not_empty, not_full;
+  std::deque<chunk_t> queue;
+  std::vector<chunk_t> free_chunks; /* recycled chunk buffers */
+  bool done{ false };
+  std::atomic<uint64_t> num_functions{ 0u };
+
+  const auto worker = [&]( uint32_t thread_id ) {
+    chunk_t chunk;
+    while ( true )
+    {
+      {
+        std::unique_lock<std::mutex> lock( mutex );
+        if ( chunk.capacity() != 0u )
+        {
+          free_chunks.push_back( std::move( chunk ) );
+        }
+        not_empty.wait( lock, [&]() { return done || !queue.empty(); } );
+        if ( queue.empty() )
+        {
+          return;
+        }
+        chunk = std::move( queue.front() );
+        queue.pop_front();
+      }
+      not_full.notify_one();
+
+      for ( auto const& [index, tt] : chunk )
+      {
+        fn( index, tt, thread_id );
+      }
+      num_functions += chunk.size();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( auto i = 0u; i < num_threads; ++i )
+  {
+    threads.emplace_back( worker, i );
+  }
+
+  detail::truth_table_stream_reader reader( in, ps, st );
+  while ( true )
+  {
+    chunk_t chunk;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      if ( !free_chunks.empty() )
+      {
+        chunk = std::move( free_chunks.back() );
+        free_chunks.pop_back();
+      }
+    }
+
+    if ( !call_with_stopwatch( st.time_read, [&]() { return reader.read_chunk( chunk ); } ) )
+    {
+      break;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      if ( queue.size() >= capacity )
+      {
+        stopwatch<> t_wait( st.time_wait );
+        not_full.wait( lock, [&]() { return queue.size() < capacity; } );
+      }
+      queue.push_back( std::move( chunk ) );
+    }
+    not_empty.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    done = true;
+  }
+  not_empty.notify_all();
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  st.num_functions = num_functions;
+  st.time_total = clock::now() - t_start;
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+}
+
+} // namespace mockturtle
@@ -39,6 +39,9 @@
 #include "immutable_view.hpp"
 
 #include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
 #include <vector>
 
 namespace mockturtle
@@ -50,6 +53,13 @@ namespace mockturtle
  * also fanin cone of a single node. It maintains the context of each
  * node, which is the aggregated variables that affect the cost a node.
  *
+ * If the network implements `foreach_fanout` (e.g., when wrapped in a
+ * `fanout_view`), contexts are kept up to date when nodes are modified,
+ * e.g., by `substitute_node`: the context of a modified node is recomputed
+ * and changes are propagated into its transitive fanout, stopping at nodes
+ * whose context does not change.  The total cost returned by `get_cost()`
+ * is only updated by `update_cost`.
+ *
  * **Required network functions:**
  * - `size`
  * - `get_node`
@@ -95,7 +105,7 @@ public:
     static_assert( has_set_visited_v<Ntk>, "Ntk does not implement the set_visited method" );
     static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
 
-    add_event = Ntk::events().register_add_event( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
   }
 
   explicit cost_view( Ntk const& ntk, RecCostFn const& cost_fn = {} )
@@ -111,7 +121,7 @@ public:
     static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
 
     update_cost();
-    add_event = Ntk::events().register_add_event( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
   }
 
   explicit cost_view( cost_view<Ntk, RecCostFn> const& other )
@@ -119,13 +129,13 @@ public:
         _cost_fn( other._cost_fn ),
         context( other.context )
   {
-    add_event = Ntk::events().register_add_event( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
   }
 
   cost_view<Ntk, RecCostFn>& operator=( cost_view<Ntk, RecCostFn> const& other )
   {
     /* delete the event of this network */
-    Ntk::events().release_add_event( add_event );
+    release_events();
 
     /* update the base class */
     this->_storage = other._storage;
@@ -135,14 +145,14 @@ public:
     context = other.context;
     _cost_fn = other._cost_fn;
 
-    add_event = Ntk::events().register_add_event( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
 
     return *this;
   }
 
   ~cost_view()
   {
-    Ntk::events().release_add_event( add_event );
+    release_events();
   }
 
   /*! \brief Returns the context of node n */
@@ -206,6 +216,74 @@ public:
     _cost_fn( *this, n, _cost, context[n] );
   }
 
+  /*! \brief Recomputes the context of n and propagates changes to its transitive fanout
+   *
+   * Nodes are updated in level order if the network provides levels, and
+   * in index order otherwise, so that a node is usually updated after all
+   * its modified fanins.  A node is queued at most once at a time.
+   */
+  void on_modified( node const& n )
+  {
+    if constexpr ( has_foreach_fanout_v<Ntk> )
+    {
+      const auto rank = [&]( node const& m ) -> uint64_t {
+        if constexpr ( has_level_v<Ntk> )
+        {
+          return this->level( m );
+        }
+        else
+        {
+          return this->node_to_index( m );
+        }
+      };
+
+      using item_t = std::pair<uint64_t, node>;
+      std::priority_queue<item_t, std::vector<item_t>, std::greater<item_t>> queue;
+      std::vector<bool> queued( this->size(), false );
+
+      const auto enqueue = [&]( node const& m ) {
+        if ( !queued[this->node_to_index( m )] )
+        {
+          queued[this->node_to_index( m )] = true;
+          queue.emplace( rank( m ), m );
+        }
+      };
+
+      enqueue( n );
+      while ( !queue.empty() )
+      {
+        auto const m = queue.top().second;
+        queue.pop();
+        queued[this->node_to_index( m )] = false;
+
+        if constexpr ( has_is_dead_v<Ntk> )
+        {
+          if ( this->is_dead( m ) )
+            continue;
+        }
+        if ( this->is_constant( m ) || this->is_pi( m ) )
+          continue;
+
+        std::vector<context_t> fanin_costs;
+        this->foreach_fanin( m, [&]( auto const& f ) {
+          fanin_costs.emplace_back( context[this->get_node( f )] );
+        } );
+        auto const updated = _cost_fn( *this, m, fanin_costs );
+        if ( m != n && updated == context[m] )
+          continue; /* stabilized */
+
+        context[m] = updated;
+        this->foreach_fanout( m, [&]( auto const& fo ) {
+          enqueue( fo );
+        } );
+      }
+    }
+    else
+    {
+      (void)n;
+    }
+  }
+
   /*! \brief Creates a PI with context assigned */
   signal create_pi( context_t pi_cotext )
   {
@@ -228,6 +306,27 @@ public:
   }
 
 private:
+  void register_events()
+  {
+    add_event = Ntk::events().register_add_event( [this]( auto const& n ) { on_add( n ); } );
+    if constexpr ( has_foreach_fanout_v<Ntk> )
+    {
+      modified_event = Ntk::events().register_modified_event( [this]( auto const& n, auto const& previous ) {
+        (void)previous;
+        on_modified( n );
+      } );
+    }
+  }
+
+  void release_events()
+  {
+    Ntk::events().release_add_event( add_event );
+    if ( modified_event )
+    {
+      Ntk::events().release_modified_event( modified_event );
+    }
+  }
+
   context_t compute_cost( node const& n, uint32_t& _c )
   {
     context_t _context{};
@@ -270,6 +369,7 @@ private:
   RecCostFn _cost_fn;
 
   std::shared_ptr<typename network_events<Ntk>::add_event_type> add_event;
+  std::shared_ptr<typename network_events<Ntk>::modified_event_type> modified_event;
 };
 
 template<class T>
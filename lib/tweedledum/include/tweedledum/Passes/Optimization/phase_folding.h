@@ -5,9 +5,134 @@
 #pragma once
 
 #include "../../IR/Circuit.h"
+#include "../../IR/Instruction.h"
+#include "../../IR/Qubit.h"
+
+#include <deque>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <parallel_hashmap/phmap.h>
+#include <vector>
 
 namespace tweedledum {
 
-Circuit phase_folding(Circuit const& original);
+// Streaming phase folding.
+//
+// Instructions are fed one at a time, in circuit order.  The parity held by
+// each qubit is a bit-packed vector over path variables, and every rotation is
+// merged into the first rotation on the same parity through a hash index over
+// these vectors.  Gates which are neither CNOT, X, Swap nor diagonal single
+// qubit rotations assign fresh path variables to their targets.
+//
+// An optimized instruction is appended to `optimized` as soon as no later
+// rotation can be merged into it anymore, i.e., once one of the variables of
+// its parity is not held by any qubit.  Such variables are recycled, hence the
+// memory is bounded by the live part of the phase polynomial.  If
+// `max_pending` is not zero, at most that many instructions are held back:
+// the oldest rotation is then emitted even if it could still be merged.
+//
+// Circuits synthesized by caterpillar's `logic_network_synthesis` are
+// `netlist<stg_gate>`s; they can be written into a `Circuit` with
+// `caterpillar::ir_circuit_sink` (or converted with `to_ir_circuit`).
+class PhaseFolder {
+public:
+    PhaseFolder(Circuit& optimized, uint32_t max_pending = 0u);
+
+    void apply(Instruction const& inst);
+
+    // Emits all pending instructions.  Must be called after the last
+    // instruction has been applied.
+    void finish();
+
+private:
+    struct TermHash {
+        PhaseFolder const* folder;
+        size_t operator()(uint32_t term) const;
+    };
+
+    struct TermEq {
+        PhaseFolder const* folder;
+        bool operator()(uint32_t left, uint32_t right) const;
+    };
+
+    struct Pending {
+        std::optional<Instruction> inst; // std::nullopt for rotations
+        Qubit qubit = Qubit::invalid();
+        uint32_t term = 0u;
+        double angle = 0.0;
+        bool negated = false;
+        bool open = false;
+    };
+
+    uint64_t* parity(uint32_t qubit)
+    {
+        return qubit_words_.data() + qubit * num_words_;
+    }
+
+    uint64_t* term_parity(uint32_t term)
+    {
+        return term_words_.data() + term * num_words_;
+    }
+
+    uint64_t const* term_parity(uint32_t term) const
+    {
+        return term_words_.data() + term * num_words_;
+    }
+
+    void add_qubits(uint32_t num_qubits);
+
+    void add_phase(uint32_t qubit, double angle);
+
+    void apply_cx(uint32_t control, uint32_t target, bool negative_control);
+
+    void assign_fresh_var(uint32_t qubit);
+
+    void release_var(uint32_t var);
+
+    uint32_t new_var();
+
+    uint32_t new_term();
+
+    void close_term(uint32_t term);
+
+    void close_dead_terms();
+
+    void grow();
+
+    void push(Pending&& pending);
+
+    void flush();
+
+    void emit(Pending const& pending);
+
+    Circuit& optimized_;
+    uint32_t max_pending_;
+
+    // Bit-packed parities of the qubits, `num_words_` words each.
+    uint32_t num_words_;
+    std::vector<uint64_t> qubit_words_;
+    std::vector<uint8_t> qubit_negated_;
+
+    // Path variables: number of qubits depending on them, recycled ids, and
+    // ids which no qubit depends on but which are still used in terms.
+    std::vector<uint32_t> var_refs_;
+    std::vector<uint32_t> free_vars_;
+    std::vector<uint32_t> dead_vars_;
+
+    // Parities of the open rotations, indexed by their hash.  Term 0 is used
+    // as scratch space for lookups.
+    std::vector<uint64_t> term_words_;
+    std::vector<uint64_t> term_pending_;
+    std::vector<uint32_t> free_terms_;
+    phmap::flat_hash_set<uint32_t, TermHash, TermEq> terms_;
+
+    // Instructions which are not emitted yet, `pending_[i]` has sequence
+    // number `pending_base_ + i`.
+    std::deque<Pending> pending_;
+    uint64_t pending_base_;
+};
+
+Circuit phase_folding(
+  Circuit const& original, nlohmann::json const& config = {});
 
 } // namespace tweedledum
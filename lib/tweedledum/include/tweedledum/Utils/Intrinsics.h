@@ -14,6 +14,13 @@ static inline int __builtin_ctz(unsigned x)
     return (int) ret;
 }
 
+static inline int __builtin_ctzll(unsigned long long x)
+{
+    unsigned long ret;
+    _BitScanForward64(&ret, x);
+    return (int) ret;
+}
+
     #define __builtin_popcount __popcnt
 
 #endif
\ No newline at end of file
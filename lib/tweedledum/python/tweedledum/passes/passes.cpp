@@ -60,7 +60,9 @@ void init_Passes(pybind11::module& module)
         py::arg("original"), py::arg("config") = nlohmann::json(),
         "Resynthesize linear parts of the quantum circuit.");
 
-    module.def("phase_folding", &phase_folding, "Phase folding optimization.");
+    module.def("phase_folding", &phase_folding,
+        py::arg("original"), py::arg("config") = nlohmann::json(),
+        "Phase folding optimization.");
 
     // Utility
     module.def("inverse", &inverse,
@@ -5,117 +5,379 @@
 #include "tweedledum/Passes/Optimization/phase_folding.h"
 #include "tweedledum/Operators/All.h"
 #include "tweedledum/Operators/Utils.h"
-#include "tweedledum/Utils/LinPhasePoly.h"
+#include "tweedledum/Utils/Intrinsics.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace tweedledum {
 
-Circuit phase_folding(Circuit const& original)
-{
-    using ESOP = std::vector<uint32_t>;
-    Circuit optimized;
-    uint32_t num_path_vars = 1u;
-    std::vector<ESOP> qubit_pathsum;
-    std::vector<uint8_t> skipped(original.size(), 0);
+namespace {
+struct Config {
+    uint32_t max_pending;
 
-    original.foreach_cbit(
-      [&](std::string_view name) { optimized.create_cbit(name); });
-    original.foreach_qubit([&](std::string_view name) {
-        optimized.create_qubit(name);
-        qubit_pathsum.emplace_back(1u, (num_path_vars++ << 1));
-    });
-
-    LinPhasePoly phase_parities;
-    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
-        uint32_t const t = inst.target(0u);
-        std::optional<double> const angle = rotation_angle(inst);
-        if (inst.num_cbits() || (inst.num_qubits() > 2)) {
-            goto new_vars_end;
-        }
-        if (inst.num_targets() == 2) {
-            if (inst.is_one<Op::Swap>()) {
-                uint32_t const t1 = inst.target(1u);
-                std::swap(qubit_pathsum.at(t), qubit_pathsum.at(t1));
-                return;
+    Config(nlohmann::json const& config)
+        : max_pending(0u)
+    {
+        auto phase_folding_cfg = config.find("phase_folding");
+        if (phase_folding_cfg != config.end()) {
+            if (phase_folding_cfg->contains("max_pending")) {
+                max_pending = phase_folding_cfg->at("max_pending");
             }
-            goto new_vars_end;
-        }
-        if (inst.is_one<Op::X>()) {
-            if (inst.num_controls() == 0) {
-                if (qubit_pathsum.at(t).at(0) == 1u) {
-                    qubit_pathsum.at(t).erase(qubit_pathsum.at(t).begin());
-                    return;
-                }
-                qubit_pathsum.at(t).insert(qubit_pathsum.at(t).begin(), 1u);
-                return;
-            }
-            uint32_t c = inst.control();
-            std::vector<uint32_t> esop;
-            std::set_symmetric_difference(qubit_pathsum.at(c).begin(),
-              qubit_pathsum.at(c).end(), qubit_pathsum.at(t).begin(),
-              qubit_pathsum.at(t).end(), std::back_inserter(esop));
-            qubit_pathsum.at(t) = esop;
-            return;
-        }
-        if (angle) {
-            phase_parities.add_term(qubit_pathsum.at(t), angle.value());
         }
+    }
+};
+
+// Returns the angle of a diagonal single qubit rotation and adds the global
+// phase which is not captured by this angle to `global_phase`.
+std::optional<double> phase_angle(Instruction const& inst, double& global_phase)
+{
+    if (inst.num_controls() || inst.num_cbits()) {
+        return std::nullopt;
+    }
+    if (inst.is_one<Op::P, Op::S, Op::Sdg, Op::T, Op::Tdg, Op::Z>()) {
+        return rotation_angle(inst);
+    }
+    if (inst.is_a<Op::Rz>()) {
+        double const angle = inst.cast<Op::Rz>().angle();
+        global_phase -= angle / 2;
+        return angle;
+    }
+    return std::nullopt;
+}
+
+template<typename Fn>
+void foreach_set_bit(uint64_t word, uint32_t offset, Fn&& fn)
+{
+    while (word) {
+        fn(offset + __builtin_ctzll(word));
+        word &= word - 1;
+    }
+}
+} // namespace
+
+size_t PhaseFolder::TermHash::operator()(uint32_t term) const
+{
+    uint64_t const* words = folder->term_parity(term);
+    uint64_t hash = 0u;
+    for (uint32_t i = 0u; i < folder->num_words_; ++i) {
+        hash = (hash ^ words[i]) * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 32;
+    }
+    return static_cast<size_t>(hash);
+}
+
+bool PhaseFolder::TermEq::operator()(uint32_t left, uint32_t right) const
+{
+    return std::equal(folder->term_parity(left),
+      folder->term_parity(left) + folder->num_words_,
+      folder->term_parity(right));
+}
+
+PhaseFolder::PhaseFolder(Circuit& optimized, uint32_t max_pending)
+    : optimized_(optimized)
+    , max_pending_(max_pending)
+    , num_words_(1u)
+    , term_words_(1u, 0u)
+    , term_pending_(1u, 0u)
+    , terms_(0u, TermHash{this}, TermEq{this})
+    , pending_base_(0u)
+{
+    var_refs_.resize(64u, 0u);
+    for (uint32_t var = 64u; var-- > 0u;) {
+        free_vars_.push_back(var);
+    }
+    add_qubits(optimized.num_qubits());
+}
+
+void PhaseFolder::apply(Instruction const& inst)
+{
+    uint32_t max_qubit = 0u;
+    inst.foreach_qubit(
+      [&](Qubit qubit) { max_qubit = std::max<uint32_t>(max_qubit, qubit); });
+    if (max_qubit >= qubit_negated_.size()) {
+        add_qubits(max_qubit + 1u);
+    }
+
+    double global_phase = 0.0;
+    std::optional<double> const angle = phase_angle(inst, global_phase);
+    if (angle) {
+        optimized_.global_phase() += global_phase;
+        add_phase(inst.target(), angle.value());
         return;
+    }
 
-    new_vars_end:
-        skipped.at(ref) = 1u;
-        inst.foreach_target([&](Qubit wref) {
-            uint32_t const qubit = wref;
-            qubit_pathsum.at(qubit).clear();
-            qubit_pathsum.at(qubit).emplace_back((num_path_vars++ << 1));
-        });
-    });
-
-    num_path_vars = 1u;
-    for (uint32_t i = 0; i < original.num_qubits(); ++i) {
-        qubit_pathsum.at(i) = {(num_path_vars++ << 1)};
-    }
-
-    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
-        if (skipped.at(ref)) {
-            inst.foreach_target([&](Qubit wref) {
-                uint32_t const qubit = wref;
-                qubit_pathsum.at(qubit).clear();
-                qubit_pathsum.at(qubit).emplace_back((num_path_vars++ << 1));
-            });
-            optimized.apply_operator(inst);
+    if (inst.num_cbits() == 0 && inst.is_a<Op::X>()) {
+        if (inst.num_controls() == 0) {
+            qubit_negated_[inst.target()] ^= 1u;
+            push({inst});
+            return;
         }
-        // Rotations
-        if (inst.is_one<Op::P, Op::S, Op::Sdg, Op::T, Op::Tdg, Op::Z>()) {
+        if (inst.num_controls() == 1) {
+            Qubit const control = inst.control();
+            apply_cx(control, inst.target(),
+              control.polarity() == Qubit::Polarity::negative);
+            push({inst});
             return;
         }
+    }
+    if (inst.num_cbits() == 0 && inst.num_controls() == 0
+        && inst.is_a<Op::Swap>()) {
+        uint32_t const t0 = inst.target(0u);
+        uint32_t const t1 = inst.target(1u);
+        std::swap_ranges(parity(t0), parity(t0) + num_words_, parity(t1));
+        std::swap(qubit_negated_[t0], qubit_negated_[t1]);
+        push({inst});
+        return;
+    }
+
+    // Any other gate: the targets are not a linear function of the path
+    // variables anymore.
+    inst.foreach_target([&](Qubit qubit) { assign_fresh_var(qubit); });
+    push({inst});
+}
+
+void PhaseFolder::finish()
+{
+    for (Pending const& pending : pending_) {
+        emit(pending);
+    }
+    pending_base_ += pending_.size();
+    pending_.clear();
+    for (uint32_t term : terms_) {
+        free_terms_.push_back(term);
+    }
+    terms_.clear();
+}
+
+void PhaseFolder::add_qubits(uint32_t num_qubits)
+{
+    while (qubit_negated_.size() < num_qubits) {
+        qubit_words_.resize(qubit_words_.size() + num_words_, 0u);
+        qubit_negated_.push_back(0u);
+        uint32_t const qubit = qubit_negated_.size() - 1u;
+        uint32_t const var = new_var();
+        parity(qubit)[var / 64u] |= (uint64_t(1) << (var % 64u));
+        var_refs_[var] = 1u;
+    }
+}
+
+// A rotation by `angle` on a qubit holding the negated parity `p'` equals a
+// rotation by `-angle` on `p` times the global phase `angle`.  Terms store
+// the angle w.r.t. the positive parity.
+void PhaseFolder::add_phase(uint32_t qubit, double angle)
+{
+    bool const negated = qubit_negated_[qubit];
+    if (negated) {
+        optimized_.global_phase() += angle;
+        angle = -angle;
+    }
+    uint64_t const* words = parity(qubit);
+    if (std::all_of(words, words + num_words_, [](uint64_t w) { return !w; })) {
+        // Constant parity: the rotation is a global phase.
+        return;
+    }
+
+    std::copy(words, words + num_words_, term_parity(0u));
+    auto it = terms_.find(0u);
+    if (it != terms_.end()) {
+        pending_[term_pending_[*it] - pending_base_].angle += angle;
+        return;
+    }
 
-        uint32_t const t = inst.target();
-        if (inst.is_one<Op::Swap>()) {
-            uint32_t const t1 = inst.target(1u);
-            std::swap(qubit_pathsum.at(t), qubit_pathsum.at(t1));
+    uint32_t const term = new_term();
+    std::copy(words, words + num_words_, term_parity(term));
+    terms_.insert(term);
+    term_pending_[term] = pending_base_ + pending_.size();
+
+    Pending pending;
+    pending.qubit = Qubit(qubit);
+    pending.term = term;
+    pending.angle = angle;
+    pending.negated = negated;
+    pending.open = true;
+    push(std::move(pending));
+}
+
+void PhaseFolder::apply_cx(
+  uint32_t control, uint32_t target, bool negative_control)
+{
+    uint64_t const* c_words = parity(control);
+    uint64_t* t_words = parity(target);
+    for (uint32_t i = 0u; i < num_words_; ++i) {
+        foreach_set_bit(c_words[i] & ~t_words[i], i * 64u,
+          [&](uint32_t var) { ++var_refs_[var]; });
+        foreach_set_bit(c_words[i] & t_words[i], i * 64u,
+          [&](uint32_t var) { release_var(var); });
+        t_words[i] ^= c_words[i];
+    }
+    qubit_negated_[target] ^= qubit_negated_[control] ^ negative_control;
+}
+
+void PhaseFolder::assign_fresh_var(uint32_t qubit)
+{
+    uint64_t* words = parity(qubit);
+    for (uint32_t i = 0u; i < num_words_; ++i) {
+        foreach_set_bit(
+          words[i], i * 64u, [&](uint32_t var) { release_var(var); });
+        words[i] = 0u;
+    }
+    qubit_negated_[qubit] = 0u;
+    // `new_var` might change the memory layout of the parities.
+    uint32_t const var = new_var();
+    parity(qubit)[var / 64u] |= (uint64_t(1) << (var % 64u));
+    var_refs_[var] = 1u;
+}
+
+void PhaseFolder::release_var(uint32_t var)
+{
+    assert(var_refs_[var] > 0u);
+    if (--var_refs_[var] == 0u) {
+        dead_vars_.push_back(var);
+    }
+}
+
+// Dead variables are only recycled after closing all terms that use them.
+// This is done in bulk once they make up half of the variables, otherwise
+// the number of variables is doubled.
+uint32_t PhaseFolder::new_var()
+{
+    if (free_vars_.empty()) {
+        if (!dead_vars_.empty() && 2u * dead_vars_.size() >= var_refs_.size()) {
+            close_dead_terms();
+        } else {
+            grow();
         }
-        if (inst.is_one<Op::X>()) {
-            if (inst.num_controls() == 0) {
-                if (qubit_pathsum.at(t).at(0) == 1u) {
-                    qubit_pathsum.at(t).erase(qubit_pathsum.at(t).begin());
-                }
-                qubit_pathsum.at(t).insert(qubit_pathsum.at(t).begin(), 1u);
-            } else {
-                uint32_t c = inst.control();
-                std::vector<uint32_t> esop;
-                std::set_symmetric_difference(qubit_pathsum.at(c).begin(),
-                  qubit_pathsum.at(c).end(), qubit_pathsum.at(t).begin(),
-                  qubit_pathsum.at(t).end(), std::back_inserter(esop));
-                qubit_pathsum.at(t) = esop;
+    }
+    uint32_t const var = free_vars_.back();
+    free_vars_.pop_back();
+    return var;
+}
+
+uint32_t PhaseFolder::new_term()
+{
+    if (!free_terms_.empty()) {
+        uint32_t const term = free_terms_.back();
+        free_terms_.pop_back();
+        return term;
+    }
+    term_words_.resize(term_words_.size() + num_words_, 0u);
+    term_pending_.push_back(0u);
+    return term_pending_.size() - 1u;
+}
+
+void PhaseFolder::close_term(uint32_t term)
+{
+    pending_[term_pending_[term] - pending_base_].open = false;
+    free_terms_.push_back(term);
+}
+
+void PhaseFolder::close_dead_terms()
+{
+    std::vector<uint64_t> dead_mask(num_words_, 0u);
+    for (uint32_t var : dead_vars_) {
+        dead_mask[var / 64u] |= (uint64_t(1) << (var % 64u));
+    }
+    std::vector<uint32_t> closed;
+    for (uint32_t term : terms_) {
+        uint64_t const* words = term_parity(term);
+        for (uint32_t i = 0u; i < num_words_; ++i) {
+            if (words[i] & dead_mask[i]) {
+                closed.push_back(term);
+                break;
             }
         }
-        optimized.apply_operator(inst);
-        double const angle = phase_parities.extract_phase(qubit_pathsum.at(t));
-        if (angle == 0.0) {
-            return;
+    }
+    for (uint32_t term : closed) {
+        terms_.erase(term);
+        close_term(term);
+    }
+    free_vars_.insert(free_vars_.end(), dead_vars_.begin(), dead_vars_.end());
+    dead_vars_.clear();
+    flush();
+}
+
+void PhaseFolder::grow()
+{
+    uint32_t const old_num_words = num_words_;
+    num_words_ *= 2u;
+    auto widen = [&](std::vector<uint64_t>& words) {
+        uint32_t const num_entries = words.size() / old_num_words;
+        words.resize(num_entries * num_words_, 0u);
+        for (uint32_t i = num_entries; i-- > 0u;) {
+            std::copy_backward(words.begin() + i * old_num_words,
+              words.begin() + (i + 1) * old_num_words,
+              words.begin() + i * num_words_ + old_num_words);
+            std::fill_n(words.begin() + i * num_words_ + old_num_words,
+              num_words_ - old_num_words, 0u);
         }
-        apply_identified_phase(optimized, angle, inst.target());
-    });
+    };
+    widen(qubit_words_);
+    widen(term_words_);
+    // The hashes depend on the number of words.
+    std::vector<uint32_t> terms(terms_.begin(), terms_.end());
+    terms_.clear();
+    terms_.insert(terms.begin(), terms.end());
+
+    uint32_t const old_num_vars = var_refs_.size();
+    var_refs_.resize(num_words_ * 64u, 0u);
+    for (uint32_t var = var_refs_.size(); var-- > old_num_vars;) {
+        free_vars_.push_back(var);
+    }
+}
+
+void PhaseFolder::push(Pending&& pending)
+{
+    pending_.push_back(std::move(pending));
+    if (max_pending_ && pending_.size() > max_pending_ && pending_.front().open) {
+        uint32_t const term = pending_.front().term;
+        terms_.erase(term);
+        close_term(term);
+    }
+    flush();
+}
+
+void PhaseFolder::flush()
+{
+    while (!pending_.empty() && !pending_.front().open) {
+        emit(pending_.front());
+        pending_.pop_front();
+        ++pending_base_;
+    }
+}
+
+void PhaseFolder::emit(Pending const& pending)
+{
+    if (pending.inst) {
+        optimized_.apply_operator(*pending.inst);
+        return;
+    }
+    double angle = std::remainder(pending.angle, 2 * numbers::pi);
+    if (std::abs(angle) < 1e-12) {
+        return;
+    }
+    if (pending.negated) {
+        optimized_.global_phase() += angle;
+        angle = -angle;
+    }
+    apply_identified_phase(optimized_, angle, pending.qubit);
+}
+
+Circuit phase_folding(Circuit const& original, nlohmann::json const& config)
+{
+    Config cfg(config);
+    Circuit optimized;
+    original.foreach_cbit(
+      [&](std::string_view name) { optimized.create_cbit(name); });
+    original.foreach_qubit(
+      [&](std::string_view name) { optimized.create_qubit(name); });
+    optimized.global_phase() = original.global_phase();
+
+    PhaseFolder folder(optimized, cfg.max_pending);
+    original.foreach_instruction(
+      [&](Instruction const& inst) { folder.apply(inst); });
+    folder.finish();
     return optimized;
 }
 
@@ -42,3 +42,82 @@ TEST_CASE("Trivial phase folding", "[phase_folding][optimization]")
         CHECK(check_unitary(circuit, optimized));
     }
 }
+
+TEST_CASE("Phase folding through linear gates", "[phase_folding][optimization]")
+{
+    using namespace tweedledum;
+    SECTION("Rotation on an untouched qubit")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        Qubit q1 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q1, q0});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.size() == 2u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Merge across CNOTs")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        Qubit q1 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::T(), {q1});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.size() == 4u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Merge negated parities")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q0});
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q0});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.size() == 2u);
+        CHECK(check_unitary(circuit, optimized, true));
+    }
+    SECTION("No merge across Hadamard")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::Tdg(), {q0});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.size() == 5u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Bounded number of pending instructions")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        Qubit q1 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::T(), {q0});
+
+        nlohmann::json config;
+        config["phase_folding"]["max_pending"] = 2u;
+        Circuit optimized = phase_folding(circuit, config);
+        CHECK(optimized.size() == 4u);
+        CHECK(check_unitary(circuit, optimized));
+
+        optimized = phase_folding(circuit);
+        CHECK(optimized.size() == 3u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+}
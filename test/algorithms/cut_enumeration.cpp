@@ -1,10 +1,14 @@
 #include <catch.hpp>
 
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
 #include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/cut_enumeration/spectr_cut.hpp>
+#include <mockturtle/generators/random_network.hpp>
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/klut.hpp>
 #include <mockturtle/networks/sequential.hpp>
@@ -181,6 +185,80 @@ TEST_CASE( "compute XOR network cuts in 2-LUT network", "[cut_enumeration]" )
   }
 }
 
+template<class Cuts>
+void check_same_cuts( Cuts const& cuts1, Cuts const& cuts2 )
+{
+  CHECK( cuts1.nodes_size() == cuts2.nodes_size() );
+  CHECK( cuts1.total_cuts() == cuts2.total_cuts() );
+  CHECK( cuts1.total_tuples() == cuts2.total_tuples() );
+  for ( auto i = 0u; i < cuts1.nodes_size(); ++i )
+  {
+    auto const& set1 = cuts1.cuts( i );
+    auto const& set2 = cuts2.cuts( i );
+    REQUIRE( set1.size() == set2.size() );
+    for ( auto j = 0u; j < set1.size(); ++j )
+    {
+      CHECK( std::vector<uint32_t>( set1[j].begin(), set1[j].end() ) == std::vector<uint32_t>( set2[j].begin(), set2[j].end() ) );
+      CHECK( set1[j]->func_id == set2[j]->func_id );
+      CHECK( cuts1.truth_table( set1[j] ) == cuts2.truth_table( set2[j] ) );
+    }
+  }
+}
+
+TEST_CASE( "level-parallel cut enumeration", "[cut_enumeration]" )
+{
+  random_network_generator_params_size gps;
+  gps.num_pis = 16u;
+  gps.num_gates = 800u;
+  auto gen = random_aig_generator( gps );
+  const auto aig = gen.generate();
+
+  cut_enumeration_params ps;
+  ps.cut_size = 6u;
+  ps.cut_limit = 8u;
+  ps.minimize_truth_table = true;
+  const auto cuts = cut_enumeration<aig_network, true>( aig, ps );
+  for ( auto num_threads : { 2u, 3u } )
+  {
+    ps.num_threads = num_threads;
+    check_same_cuts( cuts, cut_enumeration<aig_network, true>( aig, ps ) );
+  }
+
+  /* cut data which depends on the truth table */
+  ps.num_threads = 1u;
+  const auto spectr_cuts = cut_enumeration<aig_network, true, cut_enumeration_spectr_cut>( aig, ps );
+  ps.num_threads = 2u;
+  const auto spectr_cuts_par = cut_enumeration<aig_network, true, cut_enumeration_spectr_cut>( aig, ps );
+  check_same_cuts( spectr_cuts, spectr_cuts_par );
+  aig.foreach_gate( [&]( auto n ) {
+    const auto i = aig.node_to_index( n );
+    CHECK( spectr_cuts.cuts( i )[0]->data.cost == spectr_cuts_par.cuts( i )[0]->data.cost );
+  } );
+
+  /* network with 3-input nodes */
+  klut_network klut;
+  std::vector<klut_network::signal> fs;
+  for ( auto i = 0u; i < 10u; ++i )
+  {
+    fs.push_back( klut.create_pi() );
+  }
+  std::mt19937 rng( 42u );
+  for ( auto i = 0u; i < 300u; ++i )
+  {
+    const auto a = fs[rng() % fs.size()];
+    const auto b = fs[rng() % fs.size()];
+    const auto c = fs[rng() % fs.size()];
+    fs.push_back( i % 2 ? klut.create_maj( a, b, c ) : klut.create_xor3( a, b, c ) );
+  }
+  klut.create_po( fs.back() );
+
+  ps.num_threads = 1u;
+  ps.cut_size = 4u;
+  const auto klut_cuts = cut_enumeration<klut_network, true>( klut, ps );
+  ps.num_threads = 4u;
+  check_same_cuts( klut_cuts, cut_enumeration<klut_network, true>( klut, ps ) );
+}
+
 TEST_CASE( "enumerate cuts for an AIG (small graph version)", "[fast_small_cut_enumeration]" )
 {
   aig_network aig;
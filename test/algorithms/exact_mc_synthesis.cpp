@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <atomic>
+#include <stdexcept>
+
 #include <bill/sat/interface/z3.hpp>
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
@@ -51,3 +54,91 @@ TEST_CASE( "Find multiple ITE with exact MC synthesis", "[exact_mc_synthesis]" )
     CHECK( simulate<kitty::dynamic_truth_table>( xag, { 3u } )[0] == func );
   }
 }
+
+TEST_CASE( "Incremental exact MC synthesis", "[exact_mc_synthesis]" )
+{
+  auto const test_one = [&]( uint32_t num_vars, const std::string& expression, bool use_cegar ) {
+    kitty::dynamic_truth_table func( num_vars );
+    kitty::create_from_expression( func, expression );
+
+    exact_mc_synthesis_params ps;
+    ps.use_cegar = use_cegar;
+    const auto xag = exact_mc_synthesis<xag_network>( func, ps );
+    ps.incremental = true;
+    const auto xag_inc = exact_mc_synthesis<xag_network>( func, ps );
+
+    CHECK( simulate<kitty::dynamic_truth_table>( xag_inc, { num_vars } )[0] == func );
+    CHECK( *multiplicative_complexity( xag_inc ) == *multiplicative_complexity( xag ) );
+  };
+
+  for ( auto use_cegar : { false, true } )
+  {
+    test_one( 3u, "<abc>", use_cegar );
+    test_one( 3u, "!<abc>", use_cegar );
+    test_one( 4u, "(abcd)", use_cegar );
+    test_one( 3u, "[(ab)(!ac)]", use_cegar );
+    test_one( 4u, "[(ab)(cd)]", use_cegar );
+    test_one( 4u, "[<abc>d]", use_cegar );
+  }
+}
+
+TEST_CASE( "Exact MC synthesis with a solver portfolio", "[exact_mc_synthesis]" )
+{
+  auto const test_one = [&]( uint32_t num_vars, const std::string& expression ) {
+    kitty::dynamic_truth_table func( num_vars );
+    kitty::create_from_expression( func, expression );
+
+    exact_mc_synthesis_portfolio_stats st;
+    const auto xag = exact_mc_synthesis_portfolio<xag_network>( func, {}, &st );
+    CHECK( simulate<kitty::dynamic_truth_table>( xag, { num_vars } )[0] == func );
+    CHECK( *multiplicative_complexity( xag ) == *multiplicative_complexity( exact_mc_synthesis<xag_network>( func ) ) );
+  };
+
+  test_one( 3u, "<abc>" );
+  test_one( 3u, "!<abc>" );
+  test_one( 4u, "(abcd)" );
+  test_one( 4u, "[(ab)(cd)]" );
+
+  kitty::dynamic_truth_table func( 4u );
+  kitty::create_from_expression( func, "[(ab)<bcd>]" );
+
+  exact_mc_synthesis_portfolio_params ps;
+  ps.num_threads = 2u;
+  ps.configurations.resize( 3u );
+  ps.configurations[1u].solver = bill::solvers::bsat2;
+  ps.configurations[2u].ps.incremental = true;
+  const auto xag = exact_mc_synthesis_portfolio<xag_network>( func, ps );
+  CHECK( simulate<kitty::dynamic_truth_table>( xag, { 4u } )[0] == func );
+
+  /* incremental configurations keep their solvers when the number of AND gates is increased */
+  exact_mc_synthesis_portfolio_params ips;
+  ips.configurations.resize( 2u );
+  ips.configurations[0u].ps.incremental = true;
+  ips.configurations[1u].ps.incremental = true;
+  ips.configurations[1u].ps.use_cegar = true;
+  for ( auto const& expression : { "[(ab)<bcd>]", "[(ab)(cd)]", "!<abc>" } )
+  {
+    kitty::dynamic_truth_table ifunc( 4u );
+    kitty::create_from_expression( ifunc, expression );
+    const auto ixag = exact_mc_synthesis_portfolio<xag_network>( ifunc, ips );
+    CHECK( simulate<kitty::dynamic_truth_table>( ixag, { 4u } )[0] == ifunc );
+    CHECK( *multiplicative_complexity( ixag ) == *multiplicative_complexity( exact_mc_synthesis<xag_network>( ifunc ) ) );
+  }
+
+#if !defined( BILL_WINDOWS_PLATFORM )
+  ps.configurations[1u].solver = bill::solvers::maple;
+  CHECK_THROWS_AS( exact_mc_synthesis_portfolio<xag_network>( func, ps ), std::invalid_argument );
+#endif
+}
+
+TEST_CASE( "Stopped exact MC synthesis", "[exact_mc_synthesis]" )
+{
+  kitty::dynamic_truth_table func( 4u );
+  kitty::create_from_expression( func, "[(ab)<bcd>]" );
+
+  std::atomic<bool> stop{ true };
+  exact_mc_synthesis_params ps;
+  ps.stop = &stop;
+  CHECK( exact_mc_synthesis<xag_network>( func, ps ).num_pis() == 0u );
+  CHECK( exact_mc_synthesis_multiple<xag_network>( func, 2u, ps ).empty() );
+}
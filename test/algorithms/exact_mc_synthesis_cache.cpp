@@ -0,0 +1,142 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/algorithms/exact_mc_synthesis.hpp>
+#include <mockturtle/algorithms/exact_mc_synthesis_cache.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/properties/mccost.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "Exact MC synthesis with affine class cache", "[exact_mc_synthesis_cache]" )
+{
+  exact_mc_synthesis_cache<xag_network> cache;
+
+  const auto test_one = [&]( uint32_t num_vars, std::string const& expression ) {
+    kitty::dynamic_truth_table func( num_vars );
+    kitty::create_from_expression( func, expression );
+    const auto xag = cache( func );
+    CHECK( simulate<kitty::dynamic_truth_table>( xag, { num_vars } )[0] == func );
+    CHECK( *multiplicative_complexity( xag ) == *multiplicative_complexity( exact_mc_synthesis<xag_network>( func ) ) );
+  };
+
+  test_one( 3u, "<abc>" );
+  CHECK( cache.stats().cache_misses == 1u );
+  test_one( 3u, "!<abc>" );
+  test_one( 3u, "<!abc>" );
+  test_one( 3u, "<a!bc>" );
+  CHECK( cache.stats().cache_misses == 1u );
+  CHECK( cache.stats().cache_hits == 3u );
+
+  test_one( 4u, "[(ab)(cd)]" );
+  test_one( 4u, "[(ac)(bd)]" );
+  test_one( 4u, "[(!ab)(c!d)]" );
+  test_one( 4u, "(abcd)" );
+  CHECK( cache.size() == cache.stats().cache_misses );
+}
+
+TEST_CASE( "Save and load exact MC synthesis cache", "[exact_mc_synthesis_cache]" )
+{
+  const std::string filename = "exact_mc_synthesis_cache_test.bin";
+  std::remove( filename.c_str() );
+
+  kitty::dynamic_truth_table func( 4u );
+  kitty::create_from_expression( func, "[(ab)<bcd>]" );
+
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+    cache( func );
+    CHECK( cache.stats().cache_misses == 1u );
+  }
+
+  uint32_t num_calls{ 0u };
+  exact_mc_synthesis_cache<xag_network> cache( [&]( kitty::dynamic_truth_table const& f ) { ++num_calls; return exact_mc_synthesis<xag_network>( f ); } );
+  cache.load( filename );
+  CHECK( cache.size() == 1u );
+
+  const auto xag = cache( func );
+  CHECK( num_calls == 0u );
+  CHECK( cache.stats().cache_hits == 1u );
+  CHECK( simulate<kitty::dynamic_truth_table>( xag, { 4u } )[0] == func );
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "Exact MC synthesis cache file is only written after misses", "[exact_mc_synthesis_cache]" )
+{
+  static_assert( !std::is_copy_constructible_v<exact_mc_synthesis_cache<xag_network>> );
+  static_assert( std::is_move_constructible_v<exact_mc_synthesis_cache<xag_network>> );
+
+  const std::string filename = "exact_mc_synthesis_cache_dirty_test.bin";
+  std::remove( filename.c_str() );
+
+  kitty::dynamic_truth_table func( 3u );
+  kitty::create_from_expression( func, "<abc>" );
+
+  /* no misses, no file */
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+  }
+  CHECK( !std::ifstream( filename ).good() );
+
+  /* moved-from cache does not overwrite the file */
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+    cache( func );
+    exact_mc_synthesis_cache<xag_network> moved( std::move( cache ) );
+    CHECK( moved.size() == 1u );
+  }
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+    CHECK( cache.size() == 1u );
+  }
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "Reject corrupt exact MC synthesis cache", "[exact_mc_synthesis_cache]" )
+{
+  const std::string filename = "exact_mc_synthesis_cache_corrupt_test.bin";
+
+  kitty::dynamic_truth_table func( 3u );
+  kitty::create_from_expression( func, "<abc>" );
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+    cache( func );
+  }
+
+  /* huge index list size in a truncated file */
+  {
+    std::fstream io( filename, std::fstream::in | std::fstream::out | std::fstream::binary );
+    const uint32_t size = 0xffffffffu;
+    io.seekp( sizeof( uint32_t ) + sizeof( uint64_t ) );
+    io.write( reinterpret_cast<char const*>( &size ), sizeof( size ) );
+  }
+  {
+    exact_mc_synthesis_cache<xag_network> cache;
+    cache.load( filename );
+    CHECK( cache.size() == 0u );
+  }
+
+  /* trailing partial record */
+  std::remove( filename.c_str() );
+  {
+    exact_mc_synthesis_cache<xag_network> cache( exact_mc_synthesis_params{}, filename );
+    cache( func );
+  }
+  std::ofstream( filename, std::ofstream::binary | std::ofstream::app ) << "abc";
+  {
+    exact_mc_synthesis_cache<xag_network> cache;
+    cache.load( filename );
+    CHECK( cache.size() == 0u );
+  }
+
+  std::remove( filename.c_str() );
+}
@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <random>
+
 #include <kitty/dynamic_truth_table.hpp>
 #include <mockturtle/algorithms/linear_resynthesis.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
@@ -53,6 +56,84 @@ TEST_CASE( "Linear resynthesis with Paar algorithm 2", "[linear_resynthesis]" )
   }
 }
 
+TEST_CASE( "Linear resynthesis with restarts", "[linear_resynthesis]" )
+{
+  xag_network xag;
+  std::vector<xag_network::signal> xs( 12u );
+  std::generate( xs.begin(), xs.end(), [&]() { return xag.create_pi(); } );
+
+  std::default_random_engine rng( 42u );
+  for ( auto o = 0u; o < 12u; ++o )
+  {
+    std::vector<xag_network::signal> sum;
+    std::copy_if( xs.begin(), xs.end(), std::back_inserter( sum ), [&]( auto const& ) { return rng() % 2u == 0u; } );
+    xag.create_po( xag.create_nary_xor( sum ) );
+  }
+  xag.create_po( xag.get_constant( false ) );
+  xag.create_po( xag.create_xor( xs[3], xs[7] ) );
+
+  const auto f = simulate<kitty::static_truth_table<12u>>( xag );
+  const auto paar_xors = linear_resynthesis_paar( xag ).num_gates();
+
+  for ( auto selection : { linear_resynthesis_selection::paar, linear_resynthesis_selection::boyar_peralta } )
+  {
+    linear_resynthesis_multistart_params ps;
+    ps.selection = selection;
+
+    linear_resynthesis_multistart_stats st1;
+    const auto xag1 = linear_resynthesis_multistart( xag, ps, &st1 );
+    CHECK( simulate<kitty::static_truth_table<12u>>( xag1 ) == f );
+    CHECK( st1.num_xors == xag1.num_gates() );
+
+    ps.num_restarts = 16u;
+    ps.num_threads = 4u;
+    linear_resynthesis_multistart_stats st2;
+    const auto xag2 = linear_resynthesis_multistart( xag, ps, &st2 );
+    CHECK( simulate<kitty::static_truth_table<12u>>( xag2 ) == f );
+    CHECK( xag2.num_gates() <= xag1.num_gates() );
+    CHECK( xag2.num_gates() <= paar_xors );
+
+    /* the result does not depend on the number of threads */
+    ps.num_threads = 1u;
+    linear_resynthesis_multistart_stats st3;
+    const auto xag3 = linear_resynthesis_multistart( xag, ps, &st3 );
+    CHECK( xag3.num_gates() == xag2.num_gates() );
+    CHECK( st3.best_restart == st2.best_restart );
+  }
+}
+
+TEST_CASE( "Windowed exact linear resynthesis", "[linear_resynthesis]" )
+{
+  xag_network xag;
+  std::vector<xag_network::signal> xs( 10u );
+  std::generate( xs.begin(), xs.end(), [&]() { return xag.create_pi(); } );
+
+  /* naive chains which share many pairs */
+  const auto chain = [&]( std::vector<uint32_t> const& indexes ) {
+    auto f = xs[indexes.front()];
+    for ( auto i = 1u; i < indexes.size(); ++i )
+    {
+      f = xag.create_xor( f, xs[indexes[i]] );
+    }
+    return f;
+  };
+  xag.create_po( chain( { 0, 1, 2, 3 } ) );
+  xag.create_po( chain( { 3, 2, 1, 4 } ) );
+  xag.create_po( chain( { 4, 5, 6, 7 } ) );
+  xag.create_po( chain( { 7, 6, 5, 8 } ) );
+  xag.create_po( chain( { 1, 2, 5, 6, 9 } ) );
+  xag.create_po( chain( { 9, 0 } ) );
+
+  windowed_exact_linear_resynthesis_params ps;
+  ps.num_threads = 2u;
+  windowed_exact_linear_resynthesis_stats st;
+  const auto xag2 = windowed_exact_linear_resynthesis( xag, ps, &st );
+
+  CHECK( get_linear_matrix( xag2 ) == get_linear_matrix( xag ) );
+  CHECK( xag2.num_gates() < xag.num_gates() );
+  CHECK( st.num_improved > 0u );
+}
+
 TEST_CASE( "Extract linear matrix from linear network", "[linear_resynthesis]" )
 {
   xag_network xag;
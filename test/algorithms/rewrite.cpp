@@ -1,7 +1,13 @@
 #include <catch.hpp>
 
+#include <vector>
+
+#include <kitty/static_truth_table.hpp>
+
 #include <mockturtle/algorithms/rewrite.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc2.hpp>
 #include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
 #include <mockturtle/algorithms/node_resynthesis/xmg3_npn.hpp>
 #include <mockturtle/networks/aig.hpp>
@@ -215,3 +221,39 @@ TEST_CASE( "Rewrite depth-preserving", "[rewrite]" )
   CHECK( aig.num_pos() == 2 );
   CHECK( aig.num_gates() == 8 );
 }
+
+TEST_CASE( "Rewrite XAG with min-MC structures", "[rewrite]" )
+{
+  /* ripple-carry adder with AND and OR gates only */
+  xag_network xag;
+  std::vector<xag_network::signal> a, b;
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    a.push_back( xag.create_pi() );
+    b.push_back( xag.create_pi() );
+  }
+  const auto create_xor = [&]( auto const& x, auto const& y ) {
+    return xag.create_or( xag.create_and( x, !y ), xag.create_and( !x, y ) );
+  };
+  auto carry = xag.get_constant( false );
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    xag.create_po( create_xor( create_xor( a[i], b[i] ), carry ) );
+    carry = xag.create_or( xag.create_or( xag.create_and( a[i], b[i] ), xag.create_and( a[i], carry ) ), xag.create_and( b[i], carry ) );
+  }
+  xag.create_po( carry );
+
+  const auto tts = simulate<kitty::static_truth_table<8u>>( xag );
+  CHECK( costs<xag_network, mc_cost<xag_network>>( xag ) == 37u );
+
+  future::xag_minmc_resynthesis<xag_network> resyn;
+  exact_library_params eps;
+  eps.np_classification = false;
+  exact_library<xag_network, decltype( resyn )> exact_lib( resyn, eps );
+
+  rewrite( xag, exact_lib, {}, nullptr, and_xor_cost<xag_network>{} );
+
+  /* one AND gate per full adder */
+  CHECK( costs<xag_network, mc_cost<xag_network>>( xag ) == 4u );
+  CHECK( simulate<kitty::static_truth_table<8u>>( xag ) == tts );
+}
@@ -5,8 +5,10 @@
 #include <mockturtle/algorithms/xag_optimization.hpp>
 #include <mockturtle/io/verilog_reader.hpp>
 #include <mockturtle/networks/xag.hpp>
+#include <mockturtle/properties/mccost.hpp>
 
 #include <algorithm>
+#include <random>
 #include <vector>
 
 using namespace mockturtle;
@@ -34,6 +36,28 @@ TEST_CASE( "Edge cases for linear resynthesis", "[xag_optimization]" )
   }
 }
 
+TEST_CASE( "Windowed exact linear resynthesis optimization", "[xag_optimization]" )
+{
+  xag_network xag;
+  std::vector<xag_network::signal> pis( 6u );
+  std::generate( pis.begin(), pis.end(), [&]() { return xag.create_pi(); } );
+
+  const auto a = xag.create_xor( xag.create_xor( pis[0u], pis[1u] ), pis[2u] );
+  const auto b = xag.create_xor( xag.create_xor( pis[2u], pis[1u] ), pis[3u] );
+  const auto c = xag.create_and( a, b );
+  const auto d = xag.create_xor( xag.create_xor( c, pis[1u] ), pis[2u] );
+  const auto e = xag.create_and( d, xag.create_xor( pis[4u], pis[5u] ) );
+  xag.create_po( xag.create_xor( xag.create_xor( e, pis[1u] ), pis[2u] ) );
+  xag.create_po( xag.create_xor( xag.create_xor( c, pis[2u] ), pis[1u] ) );
+  xag.create_po( xag.create_xor( a, b ) );
+
+  windowed_exact_linear_resynthesis_params ps;
+  ps.num_threads = 2u;
+  const auto opt = windowed_exact_linear_resynthesis_optimization( xag, ps );
+  CHECK( simulate<kitty::static_truth_table<6u>>( xag ) == simulate<kitty::static_truth_table<6u>>( opt ) );
+  CHECK( opt.num_gates() <= xag.num_gates() );
+}
+
 TEST_CASE( "Test XAG constant fanin optimization", "[xag_optimization]" )
 {
   /* regression test that leads to a segmentation violation */
@@ -56,3 +80,82 @@ TEST_CASE( "Test XAG constant fanin optimization", "[xag_optimization]" )
   CHECK( lorina::read_verilog( ss, mockturtle::verilog_reader( xag ) ) == lorina::return_code::success );
   xag_constant_fanin_optimization( xag );
 }
+
+TEST_CASE( "XAG constant fanin optimization on random XAGs", "[xag_optimization]" )
+{
+  std::mt19937 rng( 42u );
+  uint32_t num_reduced{ 0u };
+  for ( auto i = 0u; i < 50u; ++i )
+  {
+    xag_network xag;
+    std::vector<xag_network::signal> wires( 8u );
+    std::generate( wires.begin(), wires.end(), [&]() { return xag.create_pi(); } );
+
+    /* many XORs over few wires, such that linear fanins often cancel, and
+       enough AND gates for linear fanins with more than 64 leaves */
+    for ( auto j = 0u; j < 300u; ++j )
+    {
+      const auto a = wires[rng() % wires.size()] ^ ( rng() % 2u == 0u );
+      const auto b = wires[rng() % wires.size()] ^ ( rng() % 2u == 0u );
+      const auto c = wires[rng() % wires.size()];
+      switch ( rng() % 4u )
+      {
+      case 0u:
+        wires.push_back( xag.create_and( a, b ) );
+        break;
+      case 1u:
+        wires.push_back( xag.create_and( a, xag.create_xor( xag.create_xor( b, c ), c ) ) );
+        break;
+      default:
+        wires.push_back( xag.create_xor( a, b ) );
+        break;
+      }
+    }
+    for ( auto j = 0u; j < 8u; ++j )
+    {
+      xag.create_po( wires[wires.size() - 1u - j * 7u] );
+    }
+
+    const auto opt = xag_constant_fanin_optimization( xag );
+    CHECK( simulate<kitty::static_truth_table<8u>>( xag ) == simulate<kitty::static_truth_table<8u>>( opt ) );
+    CHECK( *multiplicative_complexity( opt ) <= *multiplicative_complexity( xag ) );
+    num_reduced += *multiplicative_complexity( opt ) < *multiplicative_complexity( xag ) ? 1u : 0u;
+  }
+  CHECK( num_reduced > 0u );
+}
+
+TEST_CASE( "XAG don't cares optimization", "[xag_optimization]" )
+{
+  xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto d = xag.create_pi();
+
+  /* the two fanins of the first AND gate cannot be 0 at the same time */
+  const auto f1 = xag.create_and( xag.create_xor( a, b ), !xag.create_xor( xag.create_xor( a, c ), xag.create_xor( b, c ) ) );
+  const auto f2 = xag.create_and( xag.create_or( a, c ), d );
+  xag.create_po( xag.create_xor( f1, f2 ) );
+
+  const auto check = [&]( xag_dont_cares_optimization_params const& ps ) {
+    xag_dont_cares_optimization_stats st;
+    const auto opt = xag_dont_cares_optimization( xag, ps, &st );
+    CHECK( simulate<kitty::static_truth_table<4u>>( xag ) == simulate<kitty::static_truth_table<4u>>( opt ) );
+    CHECK( st.num_ands == 3u );
+    CHECK( st.num_replaced == 1u );
+  };
+
+  check( {} );
+
+  xag_dont_cares_optimization_params ps;
+  ps.num_patterns = 0u;
+  ps.num_threads = 2u;
+  check( ps );
+
+  ps.windowed = true;
+  check( ps );
+
+  ps.num_patterns = 64u;
+  ps.max_window_leaves = 4u;
+  check( ps );
+}
@@ -0,0 +1,122 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <caterpillar/structures/circuit_sink.hpp>
+#include <caterpillar/structures/stg_gate.hpp>
+#include <caterpillar/synthesis/lhrs.hpp>
+#include <caterpillar/synthesis/strategies/bennett_mapping_strategy.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <tweedledum/gates/gate_base.hpp>
+#include <tweedledum/io/qasm.hpp>
+#include <tweedledum/networks/netlist.hpp>
+
+using namespace caterpillar;
+
+namespace
+{
+
+/* removes the trailing spaces of the register declarations patched by `qasm_sink::finish` */
+std::string strip_trailing_spaces( std::string const& text )
+{
+  std::istringstream in( text );
+  std::string result, line;
+  while ( std::getline( in, line ) )
+  {
+    line.erase( line.find_last_not_of( ' ' ) + 1u );
+    result += line + "\n";
+  }
+  return result;
+}
+
+mockturtle::xag_network make_xag()
+{
+  mockturtle::xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto d = xag.create_pi();
+  const auto f1 = xag.create_and( xag.create_xor( a, b ), !c );
+  const auto f2 = xag.create_and( f1, xag.create_xor( c, d ) );
+  xag.create_po( xag.create_xor( f1, f2 ) );
+  xag.create_po( !f2 );
+  return xag;
+}
+
+} // namespace
+
+TEST_CASE( "Stream synthesized circuit into QASM sink", "[circuit_sink]" )
+{
+  const auto xag = make_xag();
+
+  tweedledum::netlist<stg_gate> circ;
+  {
+    bennett_mapping_strategy<mockturtle::xag_network> strategy;
+    logic_network_synthesis_stats st;
+    CHECK( logic_network_synthesis( circ, xag, strategy, {}, {}, &st ) );
+    CHECK( st.verified == true );
+  }
+  std::ostringstream expected;
+  tweedledum::write_qasm( circ, expected );
+
+  std::stringstream os;
+  qasm_sink sink( os, 0u, true, 16u );
+  {
+    bennett_mapping_strategy<mockturtle::xag_network> strategy;
+    logic_network_synthesis_stats st;
+    CHECK( logic_network_synthesis( sink, xag, strategy, {}, {}, &st ) );
+    CHECK( !st.verified );
+  }
+  CHECK( sink.finish() );
+
+  CHECK( sink.num_qubits() == circ.num_qubits() );
+  CHECK( sink.stats().num_gates == circ.num_gates() );
+  CHECK( strip_trailing_spaces( os.str() ) == expected.str() );
+  CHECK( os.str().find( fmt::format( "qreg q[{}];", circ.num_qubits() ) ) != std::string::npos );
+}
+
+TEST_CASE( "QASM sink writes the same gates as write_qasm", "[circuit_sink]" )
+{
+  using namespace tweedledum;
+
+  tweedledum::netlist<stg_gate> circ;
+  std::stringstream os;
+  qasm_sink sink( os );
+  std::vector<uint32_t> gates;
+  function_sink counter( [&]( auto const& op, auto const&, auto const& ) { gates.push_back( static_cast<uint32_t>( op.operation() ) ); } );
+
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    circ.add_qubit();
+    sink.add_qubit();
+    counter.add_qubit();
+  }
+
+  const auto add = [&]( auto const&... args ) {
+    circ.add_gate( args... );
+    sink.add_gate( args... );
+    counter.add_gate( args... );
+  };
+  add( gate::hadamard, qubit_id( 0u ) );
+  add( gate::t, qubit_id( 1u ) );
+  add( gate::t_dagger, qubit_id( 1u ) );
+  add( gate_base( gate_set::rotation_z, 0.25 ), qubit_id( 2u ) );
+  add( gate_base( gate_set::rotation_x, 0.5 ), qubit_id( 2u ) );
+  add( gate_base( gate_set::rotation_y, 0.125 ), qubit_id( 3u ) );
+  add( gate::cx, !qubit_id( 0u ), qubit_id( 1u ) );
+  add( gate::mcx, std::vector<qubit_id>{ 0u }, std::vector<qubit_id>{ 2u, 3u } );
+  add( gate::mcx, std::vector<qubit_id>{ 0u, !qubit_id( 1u ) }, std::vector<qubit_id>{ 2u, 3u } );
+  sink.finish();
+
+  std::ostringstream expected;
+  write_qasm( circ, expected );
+  CHECK( strip_trailing_spaces( os.str() ) == expected.str() );
+
+  CHECK( gates.size() == 9u );
+  CHECK( counter.stats().num_t == 2u );
+  CHECK( counter.stats().num_cnots == 1u );
+  CHECK( counter.stats().num_mcx == 2u );
+  CHECK( counter.stats().num_single_qubit == 6u );
+}
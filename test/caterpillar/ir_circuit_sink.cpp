@@ -0,0 +1,88 @@
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include <caterpillar/structures/ir_circuit_sink.hpp>
+#include <caterpillar/structures/stg_gate.hpp>
+#include <caterpillar/synthesis/lhrs.hpp>
+#include <caterpillar/synthesis/strategies/bennett_mapping_strategy.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <tweedledum/IR/Circuit.h>
+#include <tweedledum/gates/gate_base.hpp>
+#include <tweedledum/networks/netlist.hpp>
+
+using namespace caterpillar;
+using namespace tweedledum;
+
+namespace
+{
+
+std::vector<std::string> instruction_kinds( Circuit const& circuit )
+{
+  std::vector<std::string> kinds;
+  circuit.foreach_instruction( [&]( Instruction const& inst ) {
+    kinds.emplace_back( inst.kind() );
+  } );
+  return kinds;
+}
+
+} // namespace
+
+TEST_CASE( "Convert stg_gate circuit into Circuit IR", "[ir_circuit_sink]" )
+{
+  netlist<stg_gate> circ;
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    circ.add_qubit();
+  }
+  circ.add_gate( gate::t, qubit_id( 0u ) );
+  circ.add_gate( gate::hadamard, qubit_id( 1u ) );
+  circ.add_gate( gate::cx, qubit_id( 0u ), qubit_id( 1u ) );
+  circ.add_gate( gate::mcx, std::vector<qubit_id>{ qubit_id( 0u ), !qubit_id( 1u ) }, std::vector<qubit_id>{ 2u, 3u } );
+  circ.add_gate( gate::t_dagger, qubit_id( 2u ) );
+
+  kitty::dynamic_truth_table maj( 3u );
+  kitty::create_majority( maj );
+  circ.add_gate( stg_gate( maj, { 0u, 1u, 2u }, 3u ) ); /* not supported, skipped */
+
+  const auto circuit = to_ir_circuit( circ );
+  CHECK( circuit.num_qubits() == 4u );
+  CHECK( instruction_kinds( circuit ) == std::vector<std::string>{ "std.t", "std.h", "std.x", "std.x", "std.x", "std.x", "std.x", "std.tdg" } );
+
+  /* the negated control is restored around both targets */
+  std::vector<uint32_t> num_qubits;
+  circuit.foreach_instruction( [&]( Instruction const& inst ) {
+    num_qubits.push_back( inst.num_qubits() );
+  } );
+  CHECK( num_qubits == std::vector<uint32_t>{ 1u, 1u, 2u, 1u, 3u, 3u, 1u, 1u } );
+}
+
+TEST_CASE( "Stream synthesized circuit into Circuit IR", "[ir_circuit_sink]" )
+{
+  mockturtle::xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto f = xag.create_and( xag.create_xor( a, b ), !c );
+  xag.create_po( xag.create_xor( f, c ) );
+
+  netlist<stg_gate> circ;
+  {
+    bennett_mapping_strategy<mockturtle::xag_network> strategy;
+    CHECK( logic_network_synthesis( circ, xag, strategy ) );
+  }
+
+  Circuit circuit;
+  ir_circuit_sink sink( circuit );
+  {
+    bennett_mapping_strategy<mockturtle::xag_network> strategy;
+    CHECK( logic_network_synthesis( sink, xag, strategy ) );
+  }
+
+  const auto expected = to_ir_circuit( circ );
+  CHECK( circuit.num_qubits() == expected.num_qubits() );
+  CHECK( instruction_kinds( circuit ) == instruction_kinds( expected ) );
+}
@@ -0,0 +1,109 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <caterpillar/structures/stg_gate.hpp>
+#include <caterpillar/verification/simulate_circuit.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <tweedledum/gates/gate_base.hpp>
+#include <tweedledum/networks/netlist.hpp>
+
+using namespace caterpillar;
+using namespace tweedledum;
+
+namespace
+{
+
+tweedledum::netlist<stg_gate> make_circuit( uint32_t num_qubits )
+{
+  tweedledum::netlist<stg_gate> circ;
+  for ( auto i = 0u; i < num_qubits; ++i )
+  {
+    circ.add_qubit();
+  }
+  return circ;
+}
+
+} // namespace
+
+TEST_CASE( "Check circuit against logic network by simulation", "[simulate_circuit]" )
+{
+  mockturtle::xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  xag.create_po( xag.create_and( a, b ) );
+
+  auto correct = make_circuit( 3u );
+  correct.add_gate( gate::mcx, std::vector<qubit_id>{ 0u, 1u }, std::vector<qubit_id>{ 2u } );
+  CHECK( check_circuit_simulation( correct, xag, { 0u, 1u }, { 2u } ) == true );
+
+  /* computes a XOR b instead of a AND b */
+  auto mismatch = make_circuit( 3u );
+  mismatch.add_gate( gate::cx, qubit_id( 0u ), qubit_id( 2u ) );
+  mismatch.add_gate( gate::cx, qubit_id( 1u ), qubit_id( 2u ) );
+  CHECK( check_circuit_simulation( mismatch, xag, { 0u, 1u }, { 2u } ) == false );
+
+  /* ancilla is not restored */
+  auto dirty = make_circuit( 4u );
+  dirty.add_gate( gate::cx, qubit_id( 0u ), qubit_id( 3u ) );
+  dirty.add_gate( gate::mcx, std::vector<qubit_id>{ 0u, 1u }, std::vector<qubit_id>{ 2u } );
+  CHECK( check_circuit_simulation( dirty, xag, { 0u, 1u }, { 2u } ) == false );
+  circuit_simulation_params ps;
+  ps.check_ancillae = false;
+  CHECK( check_circuit_simulation( dirty, xag, { 0u, 1u }, { 2u }, ps ) == true );
+
+  /* not classical */
+  auto hadamard = make_circuit( 3u );
+  hadamard.add_gate( gate::hadamard, qubit_id( 2u ) );
+  CHECK( !check_circuit_simulation( hadamard, xag, { 0u, 1u }, { 2u } ) );
+}
+
+TEST_CASE( "Simulate circuit with complemented controls and control functions", "[simulate_circuit]" )
+{
+  mockturtle::xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  xag.create_po( xag.create_and( !a, b ) );
+  xag.create_po( xag.create_maj( a, b, c ) );
+
+  auto circ = make_circuit( 5u );
+  circ.add_gate( gate::mcx, std::vector<qubit_id>{ !qubit_id( 0u ), qubit_id( 1u ) }, std::vector<qubit_id>{ 3u } );
+
+  kitty::dynamic_truth_table maj( 3u );
+  kitty::create_majority( maj );
+  circ.add_gate( stg_gate( maj, { 0u, 1u, 2u }, 4u ) );
+  CHECK( check_circuit_simulation( circ, xag, { 0u, 1u, 2u }, { 3u, 4u } ) == true );
+
+  /* complemented control of the function */
+  auto wrong = make_circuit( 5u );
+  wrong.add_gate( gate::mcx, std::vector<qubit_id>{ !qubit_id( 0u ), qubit_id( 1u ) }, std::vector<qubit_id>{ 3u } );
+  wrong.add_gate( stg_gate( maj, { !qubit_id( 0u ), 1u, 2u }, 4u ) );
+  CHECK( check_circuit_simulation( wrong, xag, { 0u, 1u, 2u }, { 3u, 4u } ) == false );
+}
+
+TEST_CASE( "Simulate circuit with many inputs", "[simulate_circuit]" )
+{
+  mockturtle::xag_network xag;
+  std::vector<mockturtle::xag_network::signal> pis( 40u );
+  std::generate( pis.begin(), pis.end(), [&]() { return xag.create_pi(); } );
+  xag.create_po( xag.create_nary_xor( pis ) );
+
+  auto circ = make_circuit( 41u );
+  for ( auto i = 0u; i < 40u; ++i )
+  {
+    circ.add_gate( gate::cx, qubit_id( i ), qubit_id( 40u ) );
+  }
+
+  std::vector<uint32_t> inputs( 40u );
+  std::iota( inputs.begin(), inputs.end(), 0u );
+
+  /* too many inputs for exhaustive simulation, random patterns are used */
+  circuit_simulation_params ps;
+  ps.max_exhaustive_inputs = 64u;
+  CHECK( check_circuit_simulation( circ, xag, inputs, { 40u }, ps ) == true );
+}
@@ -0,0 +1,25 @@
+#include <catch.hpp>
+
+#include <caterpillar/synthesis/strategies/xag_mapping_strategy.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+using namespace caterpillar;
+
+TEST_CASE( "Linear fanin of XOR with equal linear fanins", "[xag_mapping_strategy]" )
+{
+  mockturtle::xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto g = xag.create_and( a, b );
+  const auto x1 = xag.create_xor( g, c );
+  const auto x2 = xag.create_xor( x1, c ); /* linear fanin { g } */
+  const auto x3 = xag.create_xor( x2, g ); /* linear fanin { } */
+  const auto x4 = xag.create_xor( x3, a );
+  xag.create_po( x4 );
+
+  xag_linear_fanins fi( xag, { xag.get_node( x4 ) } );
+  CHECK( fi[xag.get_node( x3 )].empty() );
+  CHECK( fi[xag.get_node( x3 )].empty() );
+  CHECK( fi[xag.get_node( x4 )] == std::vector<uint32_t>{ xag.node_to_index( xag.get_node( x4 ) ) } );
+}
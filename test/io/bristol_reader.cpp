@@ -0,0 +1,110 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/print.hpp>
+#include <lorina/bristol.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/io/bristol_reader.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+/* 1-bit full adder with an inverted carry, as Bristol fashion circuit */
+std::string const full_adder = "7 9\n"
+                               "2 2 1\n"
+                               "1 2\n"
+                               "\n"
+                               "2 1 0 1 3 XOR\n"
+                               "2 1 3 2 4 XOR\n"
+                               "2 1 0 1 5 AND\r\n"
+                               "2 1 3 2 6 AND\n"
+                               "2 1 5 6 7 XOR\n"
+                               "1 1 7 8 INV\n"
+                               "1 1 4 7 EQW\n";
+
+std::string random_circuit( uint32_t num_pis, uint32_t num_gates, uint32_t num_pos )
+{
+  std::mt19937 rng( 42 );
+  std::string text = fmt::format( "{} {}\n1 {}\n1 {}\n", num_gates, num_pis + num_gates, num_pis, num_pos );
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto out = num_pis + i;
+    const auto a = rng() % out, b = rng() % out;
+    switch ( rng() % 4u )
+    {
+    case 0u:
+      text += fmt::format( "2 1 {} {} {} AND\n", a, b, out );
+      break;
+    case 1u:
+      text += fmt::format( "1 1 {} {} INV\n", a, out );
+      break;
+    default:
+      text += fmt::format( "2 1 {} {} {} XOR\n", a, b, out );
+      break;
+    }
+  }
+  return text;
+}
+
+} // namespace
+
+TEST_CASE( "read Bristol circuit with fast reader", "[bristol_reader]" )
+{
+  xag_network xag, xag_ref;
+  read_bristol_fast_stats st;
+  CHECK( read_bristol_fast( full_adder.data(), full_adder.size(), xag, {}, &st ) == lorina::return_code::success );
+  CHECK( st.num_gates == 7u );
+
+  std::istringstream in( full_adder );
+  CHECK( lorina::read_bristol( in, bristol_reader( xag_ref ) ) == lorina::return_code::success );
+
+  CHECK( xag.num_pis() == 3u );
+  CHECK( xag.num_pos() == 2u );
+  CHECK( xag.num_gates() == xag_ref.num_gates() );
+
+  const auto tts = simulate<kitty::dynamic_truth_table>( xag, { 3u } );
+  CHECK( tts == simulate<kitty::dynamic_truth_table>( xag_ref, { 3u } ) );
+  CHECK( kitty::to_hex( tts[0] ) == "96" );
+  CHECK( kitty::to_hex( tts[1] ) == "17" );
+}
+
+TEST_CASE( "read Bristol circuit in parallel chunks", "[bristol_reader]" )
+{
+  const auto text = random_circuit( 64u, 50000u, 32u );
+
+  xag_network xag1, xag4;
+  CHECK( read_bristol_fast( text.data(), text.size(), xag1 ) == lorina::return_code::success );
+
+  read_bristol_fast_params ps;
+  ps.num_threads = 4u;
+  CHECK( read_bristol_fast( text.data(), text.size(), xag4, ps ) == lorina::return_code::success );
+
+  CHECK( xag1.num_pos() == 32u );
+  CHECK( xag1._storage->nodes == xag4._storage->nodes );
+  CHECK( xag1._storage->outputs == xag4._storage->outputs );
+}
+
+TEST_CASE( "reject malformed Bristol circuits", "[bristol_reader]" )
+{
+  for ( std::string const text : { "1 3\n1 2\n1 1\n2 1 0 1 2 NAND\n",
+                                   "1 3\n1 2\n1 1\n2 1 0 5 2 AND\n",
+                                   "1 3\n1 2\n1 1\n2 1 0 1 2 AND extra\n",
+                                   "1 3\n1 2\n1 1\n2 1 0 2 INV\n",
+                                   "1 3\n1 2\n" } )
+  {
+    xag_network xag;
+    CHECK( read_bristol_fast( text.data(), text.size(), xag ) == lorina::return_code::parse_error );
+    CHECK( xag.size() == 1u );
+  }
+
+  xag_network xag;
+  CHECK( read_bristol_fast( "missing.txt", xag ) == lorina::return_code::parse_error );
+}
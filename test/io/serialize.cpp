@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <sstream>
+#include <vector>
+
 #include <mockturtle/io/serialize.hpp>
 
 using namespace mockturtle;
@@ -46,3 +49,83 @@ TEST_CASE( "serialize aig_network into a file", "[serialize]" )
   CHECK( aig2._storage->nodes[f5.index].children[0u].index == f4.index );
   CHECK( aig2._storage->nodes[f5.index].children[1u].index == f3.index );
 }
+
+TEST_CASE( "serialize xag_network into a file", "[serialize]" )
+{
+  xag_network xag;
+
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+
+  const auto f1 = xag.create_xor( a, b );
+  const auto f2 = xag.create_and( f1, c );
+  const auto f3 = xag.create_xor( f2, !a );
+  xag.create_po( f3 );
+
+  serialize_network( xag, "xag.dmp" );
+  xag_network xag2 = deserialize_network<xag_network>( "xag.dmp" );
+
+  CHECK( xag._storage->nodes == xag2._storage->nodes );
+  CHECK( xag._storage->inputs == xag2._storage->inputs );
+  CHECK( xag._storage->outputs == xag2._storage->outputs );
+  CHECK( xag._storage->hash == xag2._storage->hash );
+
+  /* structural hashing still works on the deserialized network */
+  CHECK( xag2.create_xor( a, b ) == f1 );
+  CHECK( xag2.create_and( f1, c ) == f2 );
+}
+
+TEST_CASE( "snapshot of xag_network", "[serialize]" )
+{
+  xag_network xag;
+
+  std::vector<xag_network::signal> fs;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    fs.push_back( xag.create_pi() );
+  }
+  for ( auto i = 0u; i < 200u; ++i )
+  {
+    const auto x = fs[( i * 7u ) % fs.size()];
+    const auto y = fs[( i * 13u + 5u ) % fs.size()];
+    fs.push_back( i % 3u == 0u ? xag.create_and( x, !y ) : xag.create_xor( x, y ) );
+  }
+  xag.create_po( fs.back() );
+  xag.create_po( !fs[fs.size() / 2u] );
+
+  CHECK( write_network_snapshot( xag, "xag.snap" ) );
+  const auto xag2 = read_network_snapshot<xag_network>( "xag.snap" );
+  REQUIRE( xag2 );
+
+  CHECK( xag2->size() == xag.size() );
+  CHECK( xag2->num_pis() == xag.num_pis() );
+  CHECK( xag2->num_pos() == xag.num_pos() );
+  CHECK( xag._storage->nodes == xag2->_storage->nodes );
+  CHECK( xag._storage->inputs == xag2->_storage->inputs );
+  CHECK( xag._storage->outputs == xag2->_storage->outputs );
+  CHECK( xag._storage->hash == xag2->_storage->hash );
+
+  /* the hash table is usable without rehashing */
+  auto xag3 = *xag2;
+  const auto size = xag3.size();
+  for ( auto i = 8u; i < fs.size(); ++i )
+  {
+    const auto x = fs[( ( i - 8u ) * 7u ) % i];
+    const auto y = fs[( ( i - 8u ) * 13u + 5u ) % i];
+    CHECK( ( ( i - 8u ) % 3u == 0u ? xag3.create_and( x, !y ) : xag3.create_xor( x, y ) ) == fs[i] );
+  }
+  CHECK( xag3.size() == size );
+
+  /* snapshots are typed and checksummed */
+  CHECK( !read_network_snapshot<aig_network>( "xag.snap" ) );
+
+  std::stringstream ss;
+  CHECK( write_network_snapshot( xag, ss ) );
+  auto data = ss.str();
+  CHECK( read_network_snapshot<xag_network>( data.data(), data.size(), true ) );
+  data[data.size() / 2u] ^= 1;
+  CHECK( !read_network_snapshot<xag_network>( data.data(), data.size(), true ) );
+  CHECK( !read_network_snapshot<xag_network>( data.data(), data.size() - 8u, false ) );
+  CHECK( !read_network_snapshot<xag_network>( "missing.snap" ) );
+}
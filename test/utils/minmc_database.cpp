@@ -0,0 +1,158 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#if !__clang__ || __clang_major__ > 10
+#if __GNUC__ == 7
+#include <experimental/filesystem>
+#else
+#include <filesystem>
+#endif
+#endif
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/print.hpp>
+#include <kitty/spectral.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/node_resynthesis/sop_factoring.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc2.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/utils/index_list.hpp>
+#include <mockturtle/utils/minmc_database.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+/* path in the temporary directory, such that tests do not write into the working directory */
+std::string temp_filename( std::string const& name )
+{
+#if !__clang__ || __clang_major__ > 10
+#if __GNUC__ == 7
+  namespace fs = std::experimental::filesystem::v1;
+#else
+  namespace fs = std::filesystem;
+#endif
+  return ( fs::temp_directory_path() / name ).string();
+#else
+  return name;
+#endif
+}
+
+std::string to_text_entry( uint64_t repr, std::vector<uint32_t> const& index_list )
+{
+  kitty::dynamic_truth_table tt( 6u );
+  kitty::create_from_words( tt, &repr, &repr + 1 );
+  std::string line = kitty::to_hex( tt ) + " 0 0 ";
+  for ( auto i = 0u; i < index_list.size(); ++i )
+  {
+    line += ( i ? "," : "" ) + std::to_string( index_list[i] );
+  }
+  return line + "\n";
+}
+
+} // namespace
+
+TEST_CASE( "convert and look up a min-MC database", "[minmc_database]" )
+{
+  std::istringstream text( to_text_entry( 0xff00ff00ff00ff00, { 1 << 8 | 6, 8 } ) +
+                           "malformed line\n" +
+                           to_text_entry( 0x8000000000000000, { 1 << 16 | 1 << 8 | 6, 2, 4, 14 } ) +
+                           to_text_entry( 0x0000000000000001, { 1 << 8 | 6, 0 } ) +
+                           to_text_entry( 0x8000000000000000, { 1 << 16 | 1 << 8 | 6, 6, 8, 14 } ) );
+  const auto filename = temp_filename( "mockturtle-test-minmc.bin" );
+  const auto broken_filename = temp_filename( "mockturtle-test-minmc-broken.bin" );
+  {
+    std::ofstream os( filename, std::ofstream::binary );
+    CHECK( convert_minmc_database( text, os ) );
+  }
+
+  minmc_database db;
+  CHECK( !db.is_open() );
+  CHECK( db.open( filename ) );
+  CHECK( db.num_entries() == 3u );
+  CHECK( db.size_in_bytes() == 24u + 3u * 8u + 4u * 4u + 4u * 8u );
+
+  const auto entry = db.find( 0x8000000000000000 );
+  CHECK( entry );
+  CHECK( std::vector<uint32_t>( entry.begin(), entry.end() ) == std::vector<uint32_t>{ 1 << 16 | 1 << 8 | 6, 6, 8, 14 } );
+  CHECK( !db.find( 0x2 ) );
+
+  std::vector<uint64_t> keys;
+  db.foreach_entry( [&]( uint64_t repr, auto const& entry ) {
+    keys.push_back( repr );
+    CHECK( entry.size() >= 2u );
+  } );
+  CHECK( keys == std::vector<uint64_t>{ 0x1, 0x8000000000000000, 0xff00ff00ff00ff00 } );
+
+  /* moving keeps the mapping alive */
+  minmc_database moved( std::move( db ) );
+  CHECK( !db.is_open() );
+  CHECK( moved.find( 0x1 ) );
+
+  std::ofstream( broken_filename, std::ofstream::binary ) << "MCDB";
+  CHECK( !db.open( broken_filename ) );
+  CHECK( !db.open( temp_filename( "mockturtle-test-minmc-missing.bin" ) ) );
+
+  /* a file written on a machine with the other byte order is rejected */
+  {
+    std::ifstream is( filename, std::ifstream::binary );
+    std::string data( ( std::istreambuf_iterator<char>( is ) ), std::istreambuf_iterator<char>() );
+    std::reverse( data.begin(), data.begin() + 4 );
+    std::reverse( data.begin() + 4, data.begin() + 8 );
+    std::ofstream( broken_filename, std::ofstream::binary ) << data;
+  }
+  CHECK( !db.open( broken_filename ) );
+
+  moved.close();
+  std::remove( filename.c_str() );
+  std::remove( broken_filename.c_str() );
+}
+
+TEST_CASE( "resynthesize 6-input function with mapped min-MC database", "[minmc_database]" )
+{
+  kitty::dynamic_truth_table func( 6u );
+  kitty::create_from_hex_string( func, "8000800080008000" );
+  const auto repr = kitty::hybrid_exact_spectral_canonization( func );
+
+  /* some XAG for the representative, which need not be MC-optimal */
+  xag_network repr_xag;
+  std::vector<xag_network::signal> pis( 6u );
+  std::generate( pis.begin(), pis.end(), [&]() { return repr_xag.create_pi(); } );
+  sop_factoring<xag_network> sop_resyn;
+  sop_resyn( repr_xag, repr, pis.begin(), pis.end(), [&]( auto const& f ) { repr_xag.create_po( f ); } );
+  repr_xag = cleanup_dangling( repr_xag );
+  xag_index_list il;
+  encode( il, repr_xag );
+
+  std::istringstream text( to_text_entry( *repr.cbegin(), il.raw() ) );
+  const auto filename = temp_filename( "mockturtle-test-minmc-repr.bin" );
+  {
+    std::ofstream os( filename, std::ofstream::binary );
+    CHECK( convert_minmc_database( text, os ) );
+  }
+
+  future::xag_minmc_resynthesis resyn;
+  const auto fingerprint = resyn.database_fingerprint();
+  CHECK( resyn.load_from_binary_file( filename ) );
+  CHECK( resyn.database_fingerprint() != fingerprint );
+
+  xag_network xag;
+  std::vector<xag_network::signal> leaves( 6u );
+  std::generate( leaves.begin(), leaves.end(), [&]() { return xag.create_pi(); } );
+  uint32_t num_calls{ 0u };
+  resyn( xag, func, leaves.begin(), leaves.end(), [&]( auto const& f ) { xag.create_po( f ); ++num_calls; } );
+  CHECK( num_calls == 1u );
+  CHECK( simulate<kitty::dynamic_truth_table>( xag, { 6u } )[0] == func );
+
+  std::remove( filename.c_str() );
+}
@@ -0,0 +1,207 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/spectral.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_minmc2.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/utils/spectral_canonization_cache.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+kitty::dynamic_truth_table make_function( uint32_t num_vars, uint64_t word )
+{
+  kitty::dynamic_truth_table tt( num_vars );
+  kitty::create_from_words( tt, &word, &word + 1 );
+  tt.mask_bits();
+  return tt;
+}
+
+} // namespace
+
+TEST_CASE( "cache spectral canonization results", "[spectral_canonization_cache]" )
+{
+  spectral_canonization_cache cache;
+
+  const auto func = make_function( 4u, 0x1ee1 );
+  const auto [repr, trans] = cache( func );
+  CHECK( repr == *kitty::hybrid_exact_spectral_canonization( func ).cbegin() );
+  CHECK( cache.stats().misses == 1u );
+
+  const auto [repr2, trans2] = cache( func );
+  CHECK( repr2 == repr );
+  CHECK( trans2.size() == trans.size() );
+  CHECK( cache.stats().hits == 1u );
+
+  /* same word, different number of variables */
+  cache( make_function( 5u, 0x1ee1 ) );
+  CHECK( cache.stats().misses == 2u );
+  CHECK( cache.size() == 2u );
+
+  cache.clear();
+  CHECK( cache.size() == 0u );
+}
+
+TEST_CASE( "evict spectral canonization results with CLOCK", "[spectral_canonization_cache]" )
+{
+  spectral_canonization_cache_params ps;
+  ps.capacity = 4u;
+  ps.num_shards = 1u;
+  spectral_canonization_cache cache( ps );
+
+  for ( auto word = 0u; word < 4u; ++word )
+  {
+    cache( make_function( 3u, word ) );
+  }
+  CHECK( cache.size() == 4u );
+
+  /* function 0 is referenced and survives the next eviction */
+  cache( make_function( 3u, 0u ) );
+  cache( make_function( 3u, 4u ) );
+  CHECK( cache.size() == 4u );
+  CHECK( cache.stats().evictions == 1u );
+
+  const auto hits = cache.stats().hits;
+  cache( make_function( 3u, 0u ) );
+  CHECK( cache.stats().hits == hits + 1u );
+  cache( make_function( 3u, 1u ) );
+  CHECK( cache.stats().hits == hits + 1u );
+}
+
+TEST_CASE( "share spectral canonization cache between threads", "[spectral_canonization_cache]" )
+{
+  spectral_canonization_cache_params ps;
+  ps.capacity = 256u;
+  spectral_canonization_cache cache( ps );
+
+  std::vector<uint64_t> words( 512u );
+  std::mt19937_64 rng( 1 );
+  std::generate( words.begin(), words.end(), [&]() { return rng() & 0xffff; } );
+
+  std::vector<uint32_t> errors( 4u );
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      for ( auto i = 0u; i < words.size(); ++i )
+      {
+        const auto func = make_function( 4u, words[( i + 128u * t ) % words.size()] );
+        const auto [repr, trans] = cache( func );
+        if ( repr != *kitty::hybrid_exact_spectral_canonization( func ).cbegin() )
+        {
+          ++errors[t];
+        }
+      }
+    } );
+  }
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  CHECK( errors == std::vector<uint32_t>( 4u, 0u ) );
+  const auto st = cache.stats();
+  CHECK( st.hits + st.misses == 4u * words.size() );
+  CHECK( st.size <= 256u + ps.num_shards );
+}
+
+TEST_CASE( "save and load spectral canonization cache", "[spectral_canonization_cache]" )
+{
+  {
+    spectral_canonization_cache cache( {}, "canonization_cache.bin" );
+    for ( auto word = 0u; word < 16u; ++word )
+    {
+      cache( make_function( 4u, word * 0x1357 ) );
+    }
+  }
+
+  spectral_canonization_cache cache;
+  CHECK( cache.load( "canonization_cache.bin" ) );
+  CHECK( cache.size() == 16u );
+
+  const auto func = make_function( 4u, 5u * 0x1357 );
+  const auto [repr, trans] = cache( func );
+  CHECK( cache.stats().hits == 1u );
+  CHECK( repr == *kitty::hybrid_exact_spectral_canonization( func ).cbegin() );
+
+  std::vector<kitty::detail::spectral_operation> expected;
+  kitty::hybrid_exact_spectral_canonization( func, [&]( auto const& ops ) { expected = ops; } );
+  REQUIRE( trans.size() == expected.size() );
+  for ( auto i = 0u; i < trans.size(); ++i )
+  {
+    CHECK( trans[i]._kind == expected[i]._kind );
+    CHECK( trans[i]._var1 == expected[i]._var1 );
+    CHECK( trans[i]._var2 == expected[i]._var2 );
+  }
+
+  CHECK( !cache.load( "canonization_cache_missing.bin" ) );
+}
+
+TEST_CASE( "reject corrupt spectral canonization cache", "[spectral_canonization_cache]" )
+{
+  const auto write_record = []( std::string const& filename, uint16_t kind, uint16_t var1, uint16_t var2 ) {
+    std::ofstream out( filename, std::ofstream::out | std::ofstream::binary );
+    const uint32_t num_vars = 4u, num_ops = 1u;
+    const uint64_t word = 0x1357, repr = 0x1357;
+    const uint16_t data[3] = { kind, var1, var2 };
+    out.write( reinterpret_cast<char const*>( &num_vars ), sizeof( num_vars ) );
+    out.write( reinterpret_cast<char const*>( &word ), sizeof( word ) );
+    out.write( reinterpret_cast<char const*>( &repr ), sizeof( repr ) );
+    out.write( reinterpret_cast<char const*>( &num_ops ), sizeof( num_ops ) );
+    out.write( reinterpret_cast<char const*>( data ), sizeof( data ) );
+  };
+
+  using kind = kitty::detail::spectral_operation::kind;
+
+  spectral_canonization_cache cache;
+  write_record( "canonization_cache_corrupt.bin", static_cast<uint16_t>( kind::permutation ), 1u << 1, 1u << 3 );
+  CHECK( cache.load( "canonization_cache_corrupt.bin" ) );
+  CHECK( cache.size() == 1u );
+  cache.clear();
+
+  /* unknown operation */
+  write_record( "canonization_cache_corrupt.bin", 42u, 1u, 0u );
+  CHECK( !cache.load( "canonization_cache_corrupt.bin" ) );
+
+  /* variable outside of the support */
+  write_record( "canonization_cache_corrupt.bin", static_cast<uint16_t>( kind::permutation ), 1u << 1, 1u << 4 );
+  CHECK( !cache.load( "canonization_cache_corrupt.bin" ) );
+
+  /* not a single variable */
+  write_record( "canonization_cache_corrupt.bin", static_cast<uint16_t>( kind::input_negation ), 3u, 0u );
+  CHECK( !cache.load( "canonization_cache_corrupt.bin" ) );
+
+  CHECK( cache.size() == 0u );
+}
+
+TEST_CASE( "share spectral canonization cache between resynthesis engines", "[spectral_canonization_cache]" )
+{
+  auto cache = std::make_shared<spectral_canonization_cache>();
+  future::xag_minmc_resynthesis resyn1( cache );
+  const auto resyn2 = resyn1;
+
+  const auto func = make_function( 4u, 0x8ff8 );
+  for ( auto const* resyn : std::vector<future::xag_minmc_resynthesis<> const*>{ &resyn1, &resyn2 } )
+  {
+    xag_network xag;
+    std::vector<xag_network::signal> pis( 4u );
+    std::generate( pis.begin(), pis.end(), [&]() { return xag.create_pi(); } );
+    ( *resyn )( xag, func, pis.begin(), pis.end(), [&]( auto const& f ) { xag.create_po( f ); } );
+    CHECK( simulate<kitty::dynamic_truth_table>( xag, { 4u } )[0] == func );
+  }
+
+  CHECK( cache->stats().misses == 1u );
+  CHECK( cache->stats().hits == 1u );
+  CHECK( &resyn2.canonization_cache() == cache.get() );
+}
@@ -1,13 +1,24 @@
 #include <catch.hpp>
 
 #include <cstdint>
+#include <cstdio>
+#if !__clang__ || __clang_major__ > 10
+#if __GNUC__ == 7
+#include <experimental/filesystem>
+#else
+#include <filesystem>
+#endif
+#endif
+#include <sstream>
 #include <vector>
 
 #include <lorina/genlib.hpp>
 #include <lorina/super.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
 #include <mockturtle/io/genlib_reader.hpp>
 #include <mockturtle/io/super_reader.hpp>
 #include <mockturtle/utils/super_utils.hpp>
+#include <mockturtle/networks/xag.hpp>
 #include <mockturtle/utils/tech_library.hpp>
 
 #include <kitty/constructors.hpp>
@@ -1031,4 +1042,118 @@ TEST_CASE( "Complete library generation", "[tech_library]" )
 
     kitty::exact_np_enumeration( tt, test_enumeration );
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Save and load exact library", "[tech_library]" )
+{
+  using resyn_t = xag_npn_resynthesis<xag_network, xag_network, xag_npn_db_kind::xag_complete>;
+  using library_t = exact_library<xag_network, resyn_t, 3u>;
+
+#if !__clang__ || __clang_major__ > 10
+#if __GNUC__ == 7
+  namespace fs = std::experimental::filesystem::v1;
+#else
+  namespace fs = std::filesystem;
+#endif
+  const auto filename = ( fs::temp_directory_path() / "mockturtle-test-exact-library.lib" ).string();
+#else
+  const std::string filename = "mockturtle-test-exact-library.lib";
+#endif
+
+  resyn_t resyn;
+  exact_library_params eps;
+  eps.compute_dc_classes = true;
+  library_t lib( resyn, eps );
+
+  std::stringstream ss;
+  CHECK( lib.save( ss ) );
+  const auto data = ss.str();
+  CHECK( lib.save( filename ) );
+
+  /* different parameters */
+  exact_library_params eps2;
+  eps2.area_gate = 2.0f;
+  library_t lib2( resyn, eps2 );
+  CHECK( !lib2.load( data.data(), data.size() ) );
+
+  /* loaded instead of built */
+  library_t lib3( resyn, eps, filename );
+  CHECK( lib3.get_database().size() == lib.get_database().size() );
+  CHECK( lib3.get_database().num_pos() == lib.get_database().num_pos() );
+
+  kitty::static_truth_table<3u> tt;
+  do
+  {
+    auto const* sgs = lib.get_supergates( tt );
+    auto const* sgs3 = lib3.get_supergates( tt );
+    REQUIRE( ( sgs == nullptr ) == ( sgs3 == nullptr ) );
+    if ( sgs )
+    {
+      REQUIRE( sgs->size() == sgs3->size() );
+      for ( auto i = 0u; i < sgs->size(); ++i )
+      {
+        CHECK( ( *sgs )[i].root == ( *sgs3 )[i].root );
+        CHECK( ( *sgs )[i].area == ( *sgs3 )[i].area );
+        CHECK( ( *sgs )[i].tdelay == ( *sgs3 )[i].tdelay );
+      }
+
+      /* matching with don't cares */
+      kitty::static_truth_table<3u> dc;
+      kitty::create_from_words( dc, tt.cbegin(), tt.cend() );
+      dc = ~dc;
+      uint32_t phase = 0u, phase3 = 0u;
+      std::vector<uint8_t> perm{ 0, 1, 2 }, perm3{ 0, 1, 2 };
+      auto const* dc_sgs = lib.get_supergates( tt, dc, phase, perm );
+      auto const* dc_sgs3 = lib3.get_supergates( tt, dc, phase3, perm3 );
+      CHECK( dc_sgs->front().root == dc_sgs3->front().root );
+      CHECK( phase == phase3 );
+      CHECK( perm == perm3 );
+    }
+    kitty::next_inplace( tt );
+  } while ( !kitty::is_const0( tt ) );
+
+  /* corrupted data */
+  auto corrupted = data;
+  corrupted[corrupted.size() / 2] ^= 1;
+  CHECK( !lib3.load( corrupted.data(), corrupted.size() ) );
+  CHECK( !lib3.load( data.data(), data.size() - 1u ) );
+  CHECK( lib3.load( data.data(), data.size() ) );
+
+  std::remove( filename.c_str() );
+}
+
+namespace
+{
+
+/* rewriting function whose database is identified by a fingerprint */
+struct fingerprinted_resynthesis : xag_npn_resynthesis<xag_network, xag_network, xag_npn_db_kind::xag_complete>
+{
+  uint64_t fingerprint{ 0u };
+
+  uint64_t database_fingerprint() const
+  {
+    return fingerprint;
+  }
+};
+
+} // namespace
+
+TEST_CASE( "Exact library files depend on the database fingerprint", "[tech_library]" )
+{
+  using library_t = exact_library<xag_network, fingerprinted_resynthesis, 3u>;
+
+  fingerprinted_resynthesis resyn;
+  resyn.fingerprint = 1u;
+  library_t lib( resyn );
+
+  std::stringstream ss;
+  CHECK( lib.save( ss ) );
+  const auto data = ss.str();
+
+  library_t lib_same( resyn );
+  CHECK( lib_same.load( data.data(), data.size() ) );
+
+  resyn.fingerprint = 2u;
+  library_t lib_other( resyn );
+  CHECK( !lib_other.load( data.data(), data.size() ) );
+}
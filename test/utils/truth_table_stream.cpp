@@ -0,0 +1,91 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/print.hpp>
+#include <mockturtle/utils/json_utils.hpp>
+#include <mockturtle/utils/truth_table_stream.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "process hex truth table stream", "[truth_table_stream]" )
+{
+  std::istringstream in( "# comment\n"
+                         "e8\n"
+                         "0x96696996  \n"
+                         "\n"
+                         "xyz\n"
+                         "abc\n"
+                         "6996966996696996 # 6 variables\n" );
+
+  std::mutex mutex;
+  std::vector<std::string> functions( 3u );
+  uint32_t max_thread_id{};
+  truth_table_stream_params ps;
+  ps.chunk_size = 1u;
+  ps.num_threads = 2u;
+  truth_table_stream_stats st;
+  process_truth_table_stream(
+      in, [&]( uint64_t index, kitty::dynamic_truth_table const& tt, uint32_t thread_id ) {
+        std::lock_guard<std::mutex> lock( mutex );
+        max_thread_id = std::max( max_thread_id, thread_id );
+        functions.at( index ) = kitty::to_hex( tt );
+      },
+      ps, &st );
+
+  CHECK( max_thread_id < 2u );
+  CHECK( st.num_functions == 3u );
+  CHECK( st.num_invalid == 2u );
+  CHECK( functions == std::vector<std::string>{ "e8", "96696996", "6996966996696996" } );
+}
+
+TEST_CASE( "process binary truth table stream with back-pressure", "[truth_table_stream]" )
+{
+  std::vector<uint64_t> words( 1000u );
+  for ( auto i = 0u; i < words.size(); ++i )
+  {
+    words[i] = UINT64_C( 0x9e3779b97f4a7c15 ) * ( i + 1 );
+  }
+  std::string data( reinterpret_cast<char const*>( words.data() ), sizeof( uint64_t ) * words.size() );
+  std::istringstream in( data );
+
+  std::ostringstream out;
+  json_lines_writer writer( out );
+
+  std::atomic<uint32_t> num_mismatches{ 0u };
+  truth_table_stream_params ps;
+  ps.format = truth_table_format::binary;
+  ps.chunk_size = 7u;
+  ps.max_pending_chunks = 1u;
+  ps.num_threads = 3u;
+  truth_table_stream_stats st;
+  process_truth_table_stream(
+      in, [&]( uint64_t index, kitty::dynamic_truth_table const& tt, uint32_t ) {
+        if ( tt.num_vars() != 6u || tt._bits[0] != words[index] )
+        {
+          ++num_mismatches;
+        }
+        writer( { { "index", index }, { "function", kitty::to_hex( tt ) } } );
+      },
+      ps, &st );
+
+  CHECK( num_mismatches == 0u );
+  CHECK( st.num_functions == words.size() );
+  CHECK( writer.size() == words.size() );
+
+  std::istringstream lines( out.str() );
+  std::string line;
+  uint64_t sum{};
+  while ( std::getline( lines, line ) )
+  {
+    sum += nlohmann::json::parse( line )["index"].get<uint64_t>();
+  }
+  CHECK( sum == words.size() * ( words.size() - 1 ) / 2 );
+}
@@ -1,8 +1,12 @@
 #include <catch.hpp>
 
+#include <map>
+#include <memory>
+
 #include <mockturtle/networks/xag.hpp>
 #include <mockturtle/utils/recursive_cost_functions.hpp>
 #include <mockturtle/views/cost_view.hpp>
+#include <mockturtle/views/fanout_view.hpp>
 
 using namespace mockturtle;
 
@@ -115,3 +119,78 @@ TEST_CASE( "compute depth cost for xag window", "[cost_view]" )
   CHECK( cost_xag.get_cost( xag.get_node( f3 ), std::vector( { f1, f2, f3 } ) ) == 2 );
   CHECK( cost_xag.get_cost( xag.get_node( f4 ), std::vector( { f1, f2, f3 } ) ) == 3 );
 }
+
+TEST_CASE( "incremental context update after substitution", "[cost_view]" )
+{
+  xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto f1 = xag.create_and( a, b );
+  const auto f2 = xag.create_and( f1, c );
+  const auto f3 = xag.create_xor( f2, a );
+  const auto f4 = xag.create_and( f3, b );
+  xag.create_po( f4 );
+
+  fanout_view fxag{ xag };
+  cost_view cost_xag( fxag, t_xag_depth_cost_function<decltype( fxag )>() );
+  CHECK( cost_xag.get_context( xag.get_node( f2 ) ) == 2 );
+  CHECK( cost_xag.get_context( xag.get_node( f4 ) ) == 3 );
+
+  /* replacing f2 by c lowers the T-depth of its transitive fanout */
+  cost_xag.substitute_node( xag.get_node( f2 ), c );
+  CHECK( cost_xag.get_context( xag.get_node( f3 ) ) == 0 );
+  CHECK( cost_xag.get_context( xag.get_node( f4 ) ) == 1 );
+  CHECK( cost_xag.get_context( xag.get_node( f1 ) ) == 1 );
+}
+
+namespace
+{
+
+template<class Ntk>
+struct counting_depth_cost_function : t_xag_depth_cost_function<Ntk>
+{
+  using context_t = uint32_t;
+  using t_xag_depth_cost_function<Ntk>::operator();
+
+  context_t operator()( Ntk const& ntk, node<Ntk> const& n, std::vector<context_t> const& fanin_contexts = {} ) const
+  {
+    ++( *evaluations )[ntk.node_to_index( n )];
+    return t_xag_depth_cost_function<Ntk>::operator()( ntk, n, fanin_contexts );
+  }
+
+  std::shared_ptr<std::map<uint64_t, uint32_t>> evaluations = std::make_shared<std::map<uint64_t, uint32_t>>();
+};
+
+} // namespace
+
+TEST_CASE( "update each node once after substitution with reconvergent fanout", "[cost_view]" )
+{
+  xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  const auto c = xag.create_pi();
+  const auto d = xag.create_pi();
+  const auto f1 = xag.create_and( a, xag.create_and( b, d ) );
+  const auto h = xag.create_and( f1, c );
+  const auto g1 = xag.create_and( h, d );
+  const auto g2 = xag.create_and( h, g1 );
+  const auto g3 = xag.create_and( g1, g2 );
+  xag.create_po( g3 );
+
+  fanout_view fxag{ xag };
+  counting_depth_cost_function<decltype( fxag )> cost_fn;
+  cost_view cost_xag( fxag, cost_fn );
+  CHECK( cost_xag.get_context( xag.get_node( g3 ) ) == 6 );
+
+  cost_fn.evaluations->clear();
+  cost_xag.substitute_node( xag.get_node( f1 ), a );
+  CHECK( cost_xag.get_context( xag.get_node( h ) ) == 1 );
+  CHECK( cost_xag.get_context( xag.get_node( g1 ) ) == 2 );
+  CHECK( cost_xag.get_context( xag.get_node( g2 ) ) == 3 );
+  CHECK( cost_xag.get_context( xag.get_node( g3 ) ) == 4 );
+  for ( auto const& s : { h, g1, g2, g3 } )
+  {
+    CHECK( ( *cost_fn.evaluations )[xag.node_to_index( xag.get_node( s ) )] == 1u );
+  }
+}